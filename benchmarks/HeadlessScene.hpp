@@ -0,0 +1,93 @@
+/** @file HeadlessScene.hpp
+ *  @brief Headless versions of the demo scenes for the benchmarks.
+ *
+ *  @details The scenes mirror main.cpp and solar_system.cpp, but their meshes are never
+ *  uploaded (COUNT_ONLY), so they run without an OpenGL context.
+ */
+
+#ifndef HEADLESS_SCENE_H
+#define HEADLESS_SCENE_H
+
+#include <GL/glew.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "../src/Model.hpp"
+#include "../src/Physics.hpp"
+
+/** @class HeadlessScene
+ *  @brief Owns the models of a headless scene. Their physics bodies are owned by the simulation.
+ */
+class HeadlessScene {
+   public:
+    std::vector<std::unique_ptr<Model>> models;
+
+    /**
+	 * @brief Create a model with its physics body and add the body to the simulation.
+	 * @details The body is valid until the next body is created.
+	 */
+    PhysxObject* addBody(Physx& physx, Model* model, PhysxShape shape, float mass, glm::vec3 velocity) {
+        this->models.emplace_back(model);
+        return physx.getBody(physx.createBody(shape, model, mass, velocity));
+    }
+
+    /**
+	 * @brief Build the box of main.cpp: a ground plane, four walls and randomly placed spheres with gravity and air resistance.
+	 */
+    void buildCollisionScene(Physx& physx, int numSpheres, unsigned seed = 42, float boxSize = 50.0f) {
+        srand(seed);
+        const float rotations[5][3] = {{0, 0, 0}, {90, 0, 0}, {0, 0, 90}, {0, 0, -90}, {-90, 0, 0}};
+        const float translations[5][3] = {{0, -12, 0}, {0, 0, -boxSize}, {-boxSize, 0, 0}, {boxSize, 0, 0}, {0, 0, boxSize}};
+        for (int p = 0; p < 5; ++p) {
+            Plane* plane = new Plane(10u, COUNT_ONLY);
+            for (int i = 0; i < 3; ++i) {
+                plane->_translation[i] = translations[p][i];
+                plane->_rotation[i] = rotations[p][i];
+            }
+            plane->updateTransforms();
+            this->addBody(physx, plane, PLANE, 2.0f, glm::vec3(0.0f));
+        }
+
+        for (int i = 0; i < numSpheres; ++i) {
+            Sphere* sphere = new Sphere((((1.0f * rand()) / RAND_MAX + 0.5f) * 5.0f) / 2.0f, 4, COUNT_ONLY);
+            for (int j = 0; j < 3; ++j) {
+                sphere->_translation[j] = ((1.0f * rand()) / RAND_MAX - 0.5f) * boxSize;
+            }
+            sphere->updateTransforms();
+            float mass = (((1.0f * rand()) / RAND_MAX + 1.0f) * 10.0f) * glm::pow(sphere->radius, 3);
+            glm::vec3 velocity((((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f);
+            PhysxObject* body = this->addBody(physx, sphere, SPHERE, mass, velocity);
+            body->enableGravity();
+            body->enableAirResistance();
+        }
+    }
+
+    /**
+	 * @brief Build the scene of solar_system.cpp: a sun with planets on circular orbits.
+	 * @details Planets beyond the four of the demo are spread between radius 10 and 60.
+	 */
+    void buildSolarSystem(Physx& physx, int numPlanets = 4, unsigned seed = 42) {
+        srand(seed);
+        const float sunMass = 100.0f;
+        this->addBody(physx, new Sphere(5, 4, COUNT_ONLY), SPHERE, sunMass, glm::vec3(0.0f));
+
+        const float demoRadii[4] = {5, 15, 25, 30};
+        const float demoMasses[4] = {8, 12, 16, 6};
+        for (int i = 0; i < numPlanets; ++i) {
+            float radius = (i < 4) ? demoRadii[i] : 10.0f + 50.0f * (1.0f * rand()) / RAND_MAX;
+            float mass = (i < 4) ? demoMasses[i] : 1.0f + 10.0f * (1.0f * rand()) / RAND_MAX;
+            float angle = (i < 4) ? 0.0f : 2.0f * PI * (1.0f * rand()) / RAND_MAX;
+
+            Sphere* planet = new Sphere(1, 4, COUNT_ONLY);
+            planet->_translation[0] = radius * cos(angle);
+            planet->_translation[2] = radius * sin(angle);
+            planet->updateTransforms();
+            float speed = glm::sqrt(sunMass / radius);
+            this->addBody(physx, planet, SPHERE, mass, glm::vec3(-speed * sin(angle), 0.0f, speed * cos(angle)));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,144 @@
+/** @file allocation_benchmark.cpp
+ *  @brief Counts the heap allocations of a step once the simulation has warmed up.
+ *
+ *  @details Every global operator new is counted. Each simulation is stepped until its pools,
+ *  arenas and scratch arrays have grown to their working size, then the allocations of the next
+ *  steps are counted, which should be none. Exits with 1 when a simulation still allocates, so
+ *  the check can run as part of a build. The churn case removes and creates spheres every step,
+ *  reusing their models, the way a game spawns and despawns balls.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include "HeadlessScene.hpp"
+#include "../src/FMM.hpp"
+#include "../src/NBody.hpp"
+
+// The replacements below pair malloc with free, GCC only sees the new and the free once inlined.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static std::atomic<long long> allocations(0);
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    void* p = std::malloc(size > 0 ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Step a simulation to warm it up, then count the allocations and time of the next steps.
+ *
+ * @return bool Whether the measured steps did not allocate.
+ */
+static bool measure(const char* name, Physx& physx, int warmupSteps, int numSteps, const std::function<void()>& beforeStep = nullptr) {
+    for (int s = 0; s < warmupSteps; ++s) {
+        if (beforeStep) {
+            beforeStep();
+        }
+        physx.step(0.01f);
+    }
+    long long before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < numSteps; ++s) {
+        if (beforeStep) {
+            beforeStep();
+        }
+        physx.step(0.01f);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / numSteps;
+    long long count = allocations - before;
+    printf("%-28s %10.3f %14lld %14.2f %s\n", name, ms, count, (double)count / numSteps, (count == 0) ? "ok" : "ALLOCATES");
+    return count == 0;
+}
+
+int main(int argc, char** argv) {
+    int numSpheres = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    const int warmupSteps = 500, numSteps = 500;
+    bool ok = true;
+
+    printf("%-28s %10s %14s %14s\n", "simulation", "step ms", "allocations", "per step");
+    const char* names[4] = {"collision discrete", "collision continuous", "collision solver", "collision solver sleeping"};
+    for (int mode = 0; mode < 4; ++mode) {
+        CollisionPhysx physx;
+        if (mode == 1) {
+            physx.enableContinuousCollision();
+        } else if (mode >= 2) {
+            physx.enableContactSolver();
+        }
+        if (mode == 3) {
+            physx.enableSleeping();
+        }
+        HeadlessScene scene;
+        scene.buildCollisionScene(physx, numSpheres);
+        ok = measure(names[mode], physx, warmupSteps, numSteps) && ok;
+    }
+
+    {
+        CollisionPhysx physx;
+        physx.enableContactSolver();
+        physx.enableSleeping();
+        HeadlessScene scene;
+        scene.buildCollisionScene(physx, numSpheres);
+        std::vector<BodyHandle> spheres;
+        for (std::size_t i = 0; i < physx.getObjects().size(); ++i) {
+            if (physx.getObjects()[i]->shape == SPHERE) {
+                spheres.push_back(physx.getHandle(physx.getObjects()[i]));
+            }
+        }
+        // Replace 20 random spheres by new ones dropped from above every step, 2000 per second.
+        auto churn = [&]() {
+            for (int k = 0; k < 20; ++k) {
+                int i = rand() % spheres.size();
+                PhysxObject* old = physx.getBody(spheres[i]);
+                Model* model = old->model;
+                float mass = old->mass;
+                physx.removeBody(spheres[i]);
+                model->_translation[0] = ((1.0f * rand()) / RAND_MAX - 0.5f) * 80.0f;
+                model->_translation[1] = 40.0f;
+                model->_translation[2] = ((1.0f * rand()) / RAND_MAX - 0.5f) * 80.0f;
+                model->updateTransforms();
+                spheres[i] = physx.createBody(SPHERE, model, mass, glm::vec3(0.0f));
+                physx.getBody(spheres[i])->enableGravity();
+            }
+        };
+        ok = measure("collision solver churn", physx, warmupSteps, numSteps, churn) && ok;
+    }
+
+    {
+        SolarSystemPhysx physx;
+        physx.setIntegrator(RK4);
+        HeadlessScene scene;
+        scene.buildSolarSystem(physx, 100);
+        ok = measure("solar system rk4", physx, warmupSteps, numSteps) && ok;
+    }
+    {
+        // Large enough to be split across the worker threads, which are started in the warm-up.
+        NBodyPhysx physx(0.05f, 4);
+        HeadlessScene scene;
+        scene.buildSolarSystem(physx, 1500);
+        ok = measure("nbody", physx, 10, 50) && ok;
+    }
+    {
+        FMMPhysx physx;
+        HeadlessScene scene;
+        scene.buildSolarSystem(physx, 5000);
+        ok = measure("fmm", physx, 10, 50) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/** @file determinism_benchmark.cpp
+ *  @brief Checks that deterministic runs reproduce bit for bit, and what the mode costs.
+ *
+ *  @details The collision scene of main.cpp (default 2000 spheres, or the count given as the first
+ *  argument) is simulated twice with the hash check on: the second run is compared against the
+ *  state hashes of the first. The same is done for NBodyPhysx, once on one thread and once on
+ *  all threads. Reports the step time with and without deterministic mode and the first step
+ *  whose state differed, or -1 when every step matched.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "HeadlessScene.hpp"
+#include "../src/NBody.hpp"
+#include "../src/Snapshot.hpp"
+
+static double bestMilliseconds(const std::function<void()>& f, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Run a scene for numSteps steps and return the state hash of every step.
+ *
+ * @param physx
+ * @param numSteps
+ * @param expected Hashes of a reference run to compare against, or empty.
+ * @param hashes The state hash of every step of this run.
+ * @param mismatch The first step that differed from expected, or -1.
+ * @return double Milliseconds per step.
+ */
+static double run(Physx& physx, int numSteps, const std::vector<std::uint64_t>& expected, std::vector<std::uint64_t>& hashes, std::int64_t& mismatch) {
+    SimulationHistory history(&physx);
+    if (expected.empty()) {
+        history.enableHashCheck();
+    } else {
+        history.expectStateHashes(expected);
+    }
+    double ms = bestMilliseconds([&]() {
+        for (int s = 0; s < numSteps; ++s) {
+            history.step(0.01f);
+        }
+    }, 1);
+    hashes = history.getStateHashes();
+    mismatch = history.getFirstMismatch();
+    return ms / numSteps;
+}
+
+static double plainStepMilliseconds(Physx& physx, int numSteps) {
+    return bestMilliseconds([&]() {
+        for (int s = 0; s < numSteps; ++s) {
+            physx.step(0.01f);
+        }
+    }, 1) / numSteps;
+}
+
+int main(int argc, char** argv) {
+    int numSpheres = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    const int numSteps = 300, numPlanets = 4000, nbodySteps = 20;
+    std::vector<std::uint64_t> reference, hashes;
+    std::int64_t mismatch;
+
+    printf("%-28s %12s %12s %10s\n", "scene", "plain ms", "exact ms", "mismatch");
+
+    {
+        CollisionPhysx plain;
+        HeadlessScene plainScene;
+        plainScene.buildCollisionScene(plain, numSpheres);
+        double plainMs = plainStepMilliseconds(plain, numSteps);
+
+        CollisionPhysx first, second;
+        first.enableDeterministic();
+        second.enableDeterministic();
+        HeadlessScene firstScene, secondScene;
+        firstScene.buildCollisionScene(first, numSpheres);
+        secondScene.buildCollisionScene(second, numSpheres);
+        double exactMs = run(first, numSteps, {}, reference, mismatch);
+        run(second, numSteps, reference, hashes, mismatch);
+        printf("%-28s %12.3f %12.3f %10lld\n", "collision spheres", plainMs, exactMs, (long long)mismatch);
+    }
+
+    {
+        NBodyPhysx plain;
+        HeadlessScene plainScene;
+        plainScene.buildSolarSystem(plain, numPlanets);
+        double plainMs = plainStepMilliseconds(plain, nbodySteps);
+
+        NBodyPhysx first(0.05f, 1), second;
+        first.enableDeterministic();
+        second.enableDeterministic();
+        HeadlessScene firstScene, secondScene;
+        firstScene.buildSolarSystem(first, numPlanets);
+        secondScene.buildSolarSystem(second, numPlanets);
+        double exactMs = run(first, nbodySteps, {}, reference, mismatch);
+        run(second, nbodySteps, reference, hashes, mismatch);
+        char name[64];
+        snprintf(name, sizeof(name), "nbody 1 vs %d threads", second.numThreads);
+        printf("%-28s %12.3f %12.3f %10lld\n", name, plainMs, exactMs, (long long)mismatch);
+    }
+    return 0;
+}
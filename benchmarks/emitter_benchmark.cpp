@@ -0,0 +1,66 @@
+/** @file emitter_benchmark.cpp
+ *  @brief Scalability test: pours spheres into the box of main.cpp and reports the step time against the live body count.
+ *
+ *  @details Spheres are spawned at the rate given as the first argument (default 250 per second)
+ *  and live for the seconds given as the second (default 10), so the box fills up to about rate
+ *  times lifetime bodies and stays there while spheres keep coming and going. The contact solver
+ *  and sleeping are on, as in main.cpp. Prints the mean and worst step time for every band of
+ *  live bodies, and writes every step to the CSV file given as the third argument.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "HeadlessScene.hpp"
+#include "../src/Emitter.hpp"
+
+int main(int argc, char** argv) {
+    EmitterSettings settings;
+    settings.rate = (argc > 1) ? std::atof(argv[1]) : 250.0f;
+    settings.lifetime = (argc > 2) ? std::atof(argv[2]) : 10.0f;
+    const float dt = 0.01f, seconds = 2.0f * settings.lifetime;
+    const int bandWidth = 250;
+
+    CollisionPhysx physx;
+    physx.enableContactSolver();
+    physx.enableSleeping();
+    HeadlessScene scene;
+    scene.buildCollisionScene(physx, 0);
+
+    SphereEmitter emitter(&physx, settings, 1, COUNT_ONLY);
+    for (int s = 0; s < seconds / dt; ++s) {
+        emitter.step(dt);
+    }
+
+    struct Band {
+        int steps = 0;
+        double total = 0.0, worst = 0.0;
+    };
+    std::vector<Band> bands;
+    for (const EmitterSample& sample : emitter.getSamples()) {
+        std::size_t b = sample.alive / bandWidth;
+        if (b >= bands.size()) {
+            bands.resize(b + 1);
+        }
+        ++bands[b].steps;
+        bands[b].total += sample.stepMilliseconds;
+        bands[b].worst = std::max(bands[b].worst, sample.stepMilliseconds);
+    }
+
+    printf("%-16s %8s %12s %12s\n", "live bodies", "steps", "mean ms", "worst ms");
+    for (std::size_t b = 0; b < bands.size(); ++b) {
+        if (bands[b].steps == 0) {
+            continue;
+        }
+        char range[32];
+        snprintf(range, sizeof(range), "%zu-%zu", b * bandWidth, (b + 1) * bandWidth - 1);
+        printf("%-16s %8d %12.3f %12.3f\n", range, bands[b].steps, bands[b].total / bands[b].steps, bands[b].worst);
+    }
+    printf("spawned %llu, removed %llu, alive %d\n", (unsigned long long)emitter.getSpawnedCount(), (unsigned long long)emitter.getRemovedCount(), emitter.getAliveCount());
+
+    if (argc > 3) {
+        emitter.writeCSV(argv[3]);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/** @file fmm_benchmark.cpp
+ *  @brief Accuracy and speed of the fast multipole method against a direct sum.
+ *
+ *  @details Bodies are placed in a Plummer sphere, a clustered galaxy-like distribution, for
+ *  every body count (default 10000, 100000 and 1000000, or the counts given as arguments).
+ *  The accelerations are computed with FMMPhysx for expansion orders 2 to 8, and compared with
+ *  a double precision direct sum on 200 sampled bodies. The direct sum time of all bodies is
+ *  estimated from the NBodyPhysx kernel on the first 20000 bodies, since it grows as n^2.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "HeadlessScene.hpp"
+#include "../src/FMM.hpp"
+#include "../src/NBody.hpp"
+
+static double bestMilliseconds(const std::function<void()>& f, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+static float uniform() {
+    return (1.0f * rand()) / RAND_MAX;
+}
+
+/**
+ * @brief Place n bodies of total mass n in a Plummer sphere of scale length 10.
+ */
+static void plummerSphere(int n, std::vector<glm::vec3>& positions, std::vector<float>& masses) {
+    positions.resize(n);
+    masses.assign(n, 1.0f);
+    for (int i = 0; i < n; ++i) {
+        float u = std::max(uniform(), 1e-6f);
+        // Cut the tail of the distribution off at 100 scale lengths.
+        float r = std::min(10.0f / std::sqrt(std::pow(u, -2.0f / 3.0f) - 1.0f), 1000.0f);
+        glm::vec3 direction;
+        do {
+            direction = glm::vec3(uniform(), uniform(), uniform()) * 2.0f - 1.0f;
+        } while (glm::dot(direction, direction) > 1.0f || glm::dot(direction, direction) < 1e-6f);
+        positions[i] = glm::normalize(direction) * r;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> counts = {10000, 100000, 1000000};
+    if (argc > 1) {
+        counts.clear();
+        for (int a = 1; a < argc; ++a) {
+            counts.push_back(std::atoi(argv[a]));
+        }
+    }
+    const int samples = 200;
+
+    printf("%8s %6s %10s %10s %12s %12s %10s %10s %12s %12s\n", "bodies", "order", "fmm ms", "direct ms", "speedup", "m2l", "p2p/body", "cells", "rms err", "max err");
+    for (int n : counts) {
+        srand(42);
+        std::vector<glm::vec3> positions, accelerations;
+        std::vector<float> masses;
+        plummerSphere(n, positions, masses);
+
+        // Direct sum time of all bodies, scaled up from the first 20000.
+        int direct = std::min(n, 20000);
+        NBodyPhysx nbody;
+        HeadlessScene scene;
+        std::vector<glm::vec3> directPositions(positions.begin(), positions.begin() + direct), velocities(direct, glm::vec3(0.0f)), directAccelerations(direct);
+        for (int i = 0; i < direct; ++i) {
+            Sphere* model = new Sphere(1, 4, COUNT_ONLY);
+            model->worldPosition = positions[i];
+            scene.addBody(nbody, model, SPHERE, masses[i], glm::vec3(0.0f));
+        }
+        double directMs = bestMilliseconds([&]() { nbody.computeAccelerations(directPositions, velocities, directAccelerations); }, 1);
+        directMs *= ((double)n / direct) * ((double)n / direct);
+
+        std::vector<double> reference(3 * samples);
+        std::vector<int> sampled(samples);
+        for (int s = 0; s < samples; ++s) {
+            int i = (int)((long long)s * n / samples);
+            sampled[s] = i;
+            double ax = 0.0, ay = 0.0, az = 0.0;
+            for (int j = 0; j < n; ++j) {
+                double dx = (double)positions[j].x - positions[i].x, dy = (double)positions[j].y - positions[i].y, dz = (double)positions[j].z - positions[i].z;
+                double r2 = dx * dx + dy * dy + dz * dz;
+                if (r2 == 0.0) {
+                    continue;
+                }
+                double f = masses[j] / (r2 * std::sqrt(r2));
+                ax += dx * f, ay += dy * f, az += dz * f;
+            }
+            reference[3 * s] = ax, reference[3 * s + 1] = ay, reference[3 * s + 2] = az;
+        }
+
+        for (int order = 2; order <= 8; order += 2) {
+            FMMPhysx fmm(order);
+            double fmmMs = bestMilliseconds([&]() { fmm.evaluate(positions, masses, accelerations); }, n > 100000 ? 1 : 3);
+
+            double sumError2 = 0.0, maxError = 0.0;
+            for (int s = 0; s < samples; ++s) {
+                const glm::vec3& a = accelerations[sampled[s]];
+                const double* r = &reference[3 * s];
+                double dx = a.x - r[0], dy = a.y - r[1], dz = a.z - r[2];
+                double error = std::sqrt((dx * dx + dy * dy + dz * dz) / (r[0] * r[0] + r[1] * r[1] + r[2] * r[2]));
+                sumError2 += error * error;
+                maxError = std::max(maxError, error);
+            }
+            printf("%8d %6d %10.1f %10.1f %11.1fx %12lld %10.1f %10d %12.2e %12.2e\n", n, order, fmmMs, directMs, directMs / fmmMs,
+                   fmm.getM2LCount(), (double)fmm.getP2PCount() / n, fmm.getCellCount(), std::sqrt(sumError2 / samples), maxError);
+        }
+    }
+    return 0;
+}
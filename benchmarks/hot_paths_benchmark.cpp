@@ -0,0 +1,213 @@
+/** @file hot_paths_benchmark.cpp
+ *  @brief Google Benchmark suite over the hot paths of the physics and the renderer.
+ *
+ *  @details Covers CollisionPhysx::step and SolarSystemPhysx::step over body counts, sphere mesh
+ *  generation over resolutions, loading a Wavefront Object file over triangle counts,
+ *  Model::updateTransforms of moved models and Model::composeModelMatrices of rotated models over
+ *  model counts, Scene::updateWorldMatrices of planets with moons over planet counts and
+ *  Renderer::renderModel over model counts. The
+ *  renderer benchmarks need an OpenGL context: they open a hidden window and are skipped when
+ *  that fails. Everything else is headless.
+ *
+ *  Write the results as JSON to compare them across commits:
+ *      ./build/hot_paths_benchmark --benchmark_out=results.json --benchmark_out_format=json
+ *  run_hot_paths_benchmark.sh does this with one file per commit.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HeadlessScene.hpp"
+#include "../src/Renderer.hpp"
+
+/**
+ * @brief Write a square grid of n by n quads, 2 n^2 triangles, as a Wavefront Object file.
+ */
+static std::string writeGridObject(int n) {
+    std::string path = "/tmp/hot_paths_grid_" + std::to_string(n) + ".obj";
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return "";
+    }
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            std::fprintf(file, "v %f 0 %f\n", (float)i / n - 0.5f, (float)j / n - 0.5f);
+        }
+    }
+    std::fprintf(file, "vn 0 1 0\n");
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            int a = i * (n + 1) + j + 1, b = a + 1, c = a + n + 1, d = c + 1;
+            std::fprintf(file, "f %d//1 %d//1 %d//1\nf %d//1 %d//1 %d//1\n", a, c, b, b, c, d);
+        }
+    }
+    std::fclose(file);
+    return path;
+}
+
+/**
+ * @brief Open a hidden window once, to give the renderer benchmarks an OpenGL context.
+ *
+ * @return bool Whether a context is current.
+ */
+static bool openGLContext() {
+    static int state = -1;
+    if (state < 0) {
+        state = 0;
+        if (glfwInit()) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+            GLFWwindow* window = glfwCreateWindow(64, 64, "hot_paths_benchmark", NULL, NULL);
+            if (window != NULL) {
+                glfwMakeContextCurrent(window);
+                state = (glewInit() == GLEW_OK) ? 1 : 0;
+            }
+        }
+    }
+    return state == 1;
+}
+
+static void BM_CollisionStep(benchmark::State& state) {
+    CollisionPhysx physx;
+    if (state.range(1)) {
+        physx.enableContactSolver();
+    }
+    HeadlessScene scene;
+    scene.buildCollisionScene(physx, state.range(0));
+    for (auto _ : state) {
+        physx.step(0.01f);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollisionStep)->ArgNames({"bodies", "solver"})->ArgsProduct({{100, 400, 1600}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+static void BM_SolarSystemStep(benchmark::State& state) {
+    SolarSystemPhysx physx;
+    HeadlessScene scene;
+    scene.buildSolarSystem(physx, state.range(0));
+    for (auto _ : state) {
+        physx.step(0.01f);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SolarSystemStep)->ArgName("planets")->RangeMultiplier(4)->Range(4, 1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_GenerateSphere(benchmark::State& state) {
+    for (auto _ : state) {
+        Mesh mesh = Sphere::generateSphere(1.0f, state.range(0), CPU_ONLY);
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+}
+BENCHMARK(BM_GenerateSphere)->ArgName("resolution")->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMicrosecond);
+
+static void BM_LoadModel(benchmark::State& state) {
+    std::string path = writeGridObject(state.range(0));
+    if (path.empty()) {
+        state.SkipWithError("Could not write the Wavefront Object file.");
+        return;
+    }
+    for (auto _ : state) {
+        Model model(path, CPU_ONLY);
+        benchmark::DoNotOptimize(model.meshes.data());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * 2 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_LoadModel)->ArgName("grid")->RangeMultiplier(4)->Range(8, 512)->Unit(benchmark::kMillisecond);
+
+static void BM_UpdateTransforms(benchmark::State& state) {
+    std::vector<std::unique_ptr<Sphere>> models;
+    for (int i = 0; i < state.range(0); ++i) {
+        models.emplace_back(new Sphere(1.0f, 4, COUNT_ONLY));
+        models.back()->_rotation[1] = i;
+    }
+    for (auto _ : state) {
+        for (std::unique_ptr<Sphere>& model : models) {
+            model->_translation[0] += 0.001f;
+            model->updateTransforms();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateTransforms)->ArgName("models")->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_ComposeModelMatrices(benchmark::State& state) {
+    std::vector<std::unique_ptr<Sphere>> models;
+    std::vector<Model*> pointers;
+    for (int i = 0; i < state.range(0); ++i) {
+        models.emplace_back(new Sphere(1.0f, 4, COUNT_ONLY));
+        pointers.push_back(models.back().get());
+    }
+    for (auto _ : state) {
+        for (std::unique_ptr<Sphere>& model : models) {
+            model->_rotation[1] += 1.0f;
+            model->updateTransforms();
+        }
+        Model::composeModelMatrices(pointers.data(), pointers.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComposeModelMatrices)->ArgName("models")->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_UpdateWorldMatrices(benchmark::State& state) {
+    // Planets with a moon each, of which one in ten moves every frame.
+    std::vector<std::unique_ptr<Sphere>> models;
+    Scene scene;
+    for (int i = 0; i < state.range(0); ++i) {
+        models.emplace_back(new Sphere(1.0f, 4, COUNT_ONLY));
+        Sphere* planet = models.back().get();
+        models.emplace_back(new Sphere(0.5f, 4, COUNT_ONLY));
+        models.back()->_translation[0] = 3.0f;
+        models.back()->updateTransforms();
+        scene.addModel(planet);
+        scene.addModel(models.back().get(), planet);
+    }
+    scene.updateWorldMatrices();
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < models.size(); i += 20) {
+            models[i]->_translation[1] += 0.01f;
+            models[i]->updateTransforms();
+        }
+        scene.updateWorldMatrices();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * models.size());
+}
+BENCHMARK(BM_UpdateWorldMatrices)->ArgName("planets")->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_RenderModels(benchmark::State& state) {
+    if (!openGLContext()) {
+        state.SkipWithError("No OpenGL context.");
+        return;
+    }
+    Renderer renderer(PerpectiveProperties(1280, 720));
+    glUseProgram(renderer.shader.ID);
+    renderer.updateVPMatrices();
+    std::vector<std::unique_ptr<Sphere>> models;
+    for (int i = 0; i < state.range(0); ++i) {
+        models.emplace_back(new Sphere(1.0f, 16));
+    }
+    for (auto _ : state) {
+        for (const std::unique_ptr<Sphere>& model : models) {
+            renderer.renderModel(model.get());
+        }
+        // Only the submission is timed, not the GPU working through it.
+        state.PauseTiming();
+        glFinish();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderModels)->ArgName("models")->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+/** @file integrator_benchmark.cpp
+ *  @brief Energy and angular momentum drift of the integrators on the solar_system.cpp orbits.
+ *
+ *  @details Runs the four demo planets around the sun for the given simulated time (default 500)
+ *  with every integrator over a range of time steps, and reports the largest relative drift of
+ *  the total energy and angular momentum, the wall time, and the largest time step that stays
+ *  within the drift tolerance (default 1e-3).
+ *  It then adds a comet on an eccentric orbit and compares fixed leapfrog steps against
+ *  the adaptive block time step by drift and number of planet updates, and checks that the
+ *  adaptive steps advance every planet by exactly the time step.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "HeadlessScene.hpp"
+
+struct Drift {
+    double energy = 0.0;
+    double angularMomentum = 0.0;
+    double milliseconds = 0.0;
+    unsigned long long bodyUpdates = 0;
+    //! Whether every adaptive step advanced every planet by exactly dt.
+    bool exactElapsedTime = true;
+};
+
+static double totalEnergy(const Physx& physx) {
+    const std::vector<PhysxObject*>& objects = physx.getObjects();
+    double energy = 0.0;
+    for (size_t i = 1; i < objects.size(); ++i) {
+        glm::vec3 v = objects[i]->velocity;
+        double r = glm::distance(objects[i]->model->worldPosition, objects[0]->model->worldPosition);
+        energy += 0.5 * objects[i]->mass * glm::dot(v, v) - objects[i]->mass * objects[0]->mass / r;
+    }
+    return energy;
+}
+
+static glm::vec3 totalAngularMomentum(const Physx& physx) {
+    const std::vector<PhysxObject*>& objects = physx.getObjects();
+    glm::vec3 momentum = glm::vec3(0.0f);
+    for (size_t i = 1; i < objects.size(); ++i) {
+        glm::vec3 r = objects[i]->model->worldPosition - objects[0]->model->worldPosition;
+        momentum += objects[i]->mass * glm::cross(r, objects[i]->velocity);
+    }
+    return momentum;
+}
+
+static Drift run(IntegratorType integrator, float dt, float duration, bool comet = false, bool adaptive = false) {
+    SolarSystemPhysx physx;
+    HeadlessScene scene;
+    scene.buildSolarSystem(physx);
+    physx.setIntegrator(integrator);
+    if (comet) {
+        // Perihelion 4, aphelion 40, starting at aphelion.
+        Sphere* model = new Sphere(0.5f, 4, COUNT_ONLY);
+        model->_translation[0] = -40.0f;
+        model->updateTransforms();
+        scene.addBody(physx, model, SPHERE, 20.0f, glm::vec3(0.0f, 0.0f, -glm::sqrt(100.0f * (2.0f / 40.0f - 1.0f / 22.0f))));
+    }
+    if (adaptive) {
+        physx.enableAdaptiveTimeStep();
+    }
+
+    double energy0 = totalEnergy(physx);
+    glm::vec3 momentum0 = totalAngularMomentum(physx);
+    Drift drift;
+    int numSteps = (int)(duration / dt);
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < numSteps; ++step) {
+        physx.step(dt);
+        if (adaptive) {
+            for (size_t i = 1; i < physx.getObjects().size(); ++i) {
+                drift.exactElapsedTime = drift.exactElapsedTime && physx.getElapsedTime(i) == (double)dt;
+            }
+        }
+        if (step % 16 == 0 || step == numSteps - 1) {
+            double e = fabs((totalEnergy(physx) - energy0) / energy0);
+            double l = glm::length(totalAngularMomentum(physx) - momentum0) / glm::length(momentum0);
+            drift.energy = (e > drift.energy || e != e) ? e : drift.energy;
+            drift.angularMomentum = (l > drift.angularMomentum || l != l) ? l : drift.angularMomentum;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    drift.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    drift.bodyUpdates = physx.getBodyUpdates();
+    return drift;
+}
+
+int main(int argc, char** argv) {
+    const float duration = (argc > 1) ? std::atof(argv[1]) : 500.0f;
+    const double tolerance = (argc > 2) ? std::atof(argv[2]) : 1e-3;
+    const IntegratorType integrators[] = {EXPLICIT_EULER, SEMI_IMPLICIT_EULER, LEAPFROG, YOSHIDA4, RK4};
+    const char* names[] = {"explicit euler", "semi-implicit euler", "leapfrog", "yoshida4", "rk4"};
+    const float timeSteps[] = {0.001f, 0.005f, 0.02f, 0.05f, 0.1f, 0.2f, 0.3f, 0.5f};
+
+    printf("simulated time %.0f, drift tolerance %g\n", duration, tolerance);
+    printf("%-20s %8s %12s %12s %10s\n", "integrator", "dt", "energy", "ang. mom.", "ms");
+    for (int i = 0; i < 5; ++i) {
+        float largestStable = 0.0f;
+        for (float dt : timeSteps) {
+            Drift drift = run(integrators[i], dt, duration);
+            printf("%-20s %8.3f %12.3e %12.3e %10.2f\n", names[i], dt, drift.energy, drift.angularMomentum, drift.milliseconds);
+            if (drift.energy <= tolerance && drift.angularMomentum <= tolerance) {
+                largestStable = dt;
+            }
+        }
+        printf("%-20s largest dt within tolerance: %s%.3f\n\n", names[i], largestStable > 0.0f ? "" : "none, below ", largestStable > 0.0f ? largestStable : timeSteps[0]);
+    }
+
+    printf("with a comet, perihelion 4 and aphelion 40\n");
+    printf("%-20s %8s %12s %12s %10s %14s %8s\n", "integrator", "dt", "energy", "ang. mom.", "ms", "updates", "elapsed");
+    const float cometSteps[][2] = {{0.05f, 0.0f}, {0.005f, 0.0f}, {0.0005f, 0.0f}, {0.05f, 1.0f}, {0.2f, 1.0f}, {1.0f, 1.0f}};
+    bool exactElapsedTime = true;
+    for (int i = 0; i < 6; ++i) {
+        bool adaptive = cometSteps[i][1] != 0.0f;
+        Drift drift = run(LEAPFROG, cometSteps[i][0], duration, true, adaptive);
+        printf("%-20s %8.4f %12.3e %12.3e %10.2f %14llu %8s\n", adaptive ? "adaptive leapfrog" : "leapfrog", cometSteps[i][0], drift.energy, drift.angularMomentum, drift.milliseconds, drift.bodyUpdates, drift.exactElapsedTime ? "ok" : "wrong");
+        exactElapsedTime = exactElapsedTime && drift.exactElapsedTime;
+    }
+    return exactElapsedTime ? 0 : 1;
+}
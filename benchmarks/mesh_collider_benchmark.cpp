@@ -0,0 +1,142 @@
+/** @file mesh_collider_benchmark.cpp
+ *  @brief Spheres raining onto a large triangle mesh, collided through its bounding volume hierarchy.
+ *
+ *  @details For every grid size (default 64, 256 and 512, or the sizes given as arguments) a hilly
+ *  terrain of 2 * size^2 triangles is generated on the CPU, the way an environment exported from
+ *  Blender is kept for physics. Reports the time to build the hierarchy, closest point queries
+ *  per second against a brute force search over all triangles, and the step time of 2000 spheres
+ *  falling onto the terrain with the contact solver.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "HeadlessScene.hpp"
+
+static double bestMilliseconds(const std::function<void()>& f, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+static float uniform() {
+    return (1.0f * rand()) / RAND_MAX;
+}
+
+static float terrainHeight(float x, float z) {
+    return 3.0f * std::sin(0.15f * x) * std::cos(0.11f * z) + 0.5f * std::sin(0.9f * x + 0.4f * z);
+}
+
+/** @class Terrain
+ *  @brief A square grid of size x size quads over [-50, 50]^2, displaced by terrainHeight().
+ */
+class Terrain : public Model {
+   public:
+    Terrain(unsigned size) : Model(Terrain::generateTerrain(size)) {
+    }
+
+    static Mesh generateTerrain(unsigned size) {
+        std::vector<Vertex> vertices((size + 1) * (size + 1));
+        std::vector<unsigned int> indices;
+        indices.reserve(6 * size * size);
+        for (unsigned i = 0, v = 0; i <= size; ++i) {
+            for (unsigned j = 0; j <= size; ++j, ++v) {
+                float x = -50.0f + 100.0f * i / size, z = -50.0f + 100.0f * j / size;
+                vertices[v].position = glm::vec3(x, terrainHeight(x, z), z);
+                vertices[v].normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+        for (unsigned i = 0; i < size; ++i) {
+            for (unsigned j = 0; j < size; ++j) {
+                unsigned v = i * (size + 1) + j;
+                indices.insert(indices.end(), {v, v + 1, v + size + 1, v + 1, v + size + 2, v + size + 1});
+            }
+        }
+        return Mesh(std::move(vertices), std::move(indices), Material(), CPU_ONLY);
+    }
+};
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes = {64, 256, 512};
+    if (argc > 1) {
+        sizes.clear();
+        for (int a = 1; a < argc; ++a) {
+            sizes.push_back(std::atoi(argv[a]));
+        }
+    }
+    const int numQueries = 20000, bruteQueries = 50, numSpheres = 2000, numSteps = 200;
+
+    printf("%10s %10s %8s %14s %14s %10s %10s %8s\n", "triangles", "build ms", "nodes", "bvh queries/s", "brute queries/s", "step ms", "contacts", "below");
+    for (int size : sizes) {
+        srand(42);
+        Terrain terrain(size);
+        terrain.updateTransforms();
+
+        std::vector<glm::vec3> corners;
+        const Mesh& mesh = terrain.meshes[0];
+        for (unsigned int index : mesh.indices) {
+            corners.push_back(mesh.vertices[index].position);
+        }
+        TriangleBVH bvh;
+        double buildMs = bestMilliseconds([&]() { bvh.build(corners); }, 1);
+
+        std::vector<glm::vec3> points(numQueries);
+        for (glm::vec3& p : points) {
+            p = glm::vec3(uniform() * 100.0f - 50.0f, uniform() * 10.0f - 4.0f, uniform() * 100.0f - 50.0f);
+        }
+        // Points within reach of a sphere, as in the collision pass.
+        float sum = 0.0f;
+        double bvhMs = bestMilliseconds([&]() {
+            for (const glm::vec3& p : points) {
+                glm::vec3 closest;
+                int triangle;
+                sum += std::min(bvh.nearest(p, 2.0f, closest, triangle), 2.0f);
+            }
+        }, 3);
+        double bruteMs = bestMilliseconds([&]() {
+            for (int q = 0; q < bruteQueries; ++q) {
+                float best = 1e30f;
+                for (std::size_t t = 0; t < corners.size(); t += 3) {
+                    glm::vec3 c = TriangleBVH::closestPointOnTriangle(points[q], corners[t], corners[t + 1], corners[t + 2]);
+                    best = std::min(best, glm::dot(points[q] - c, points[q] - c));
+                }
+                sum += best;
+            }
+        }, 1);
+
+        CollisionPhysx physx;
+        physx.enableContactSolver();
+        HeadlessScene scene;
+        scene.addBody(physx, new Terrain(size), TRIANGLE_MESH, 1.0f, glm::vec3(0.0f));
+        for (int i = 0; i < numSpheres; ++i) {
+            Sphere* sphere = new Sphere(0.5f, 4, COUNT_ONLY);
+            float x = uniform() * 90.0f - 45.0f, z = uniform() * 90.0f - 45.0f;
+            sphere->_translation[0] = x;
+            sphere->_translation[1] = 5.0f + uniform() * 20.0f;
+            sphere->_translation[2] = z;
+            sphere->updateTransforms();
+            scene.addBody(physx, sphere, SPHERE, 1.0f, glm::vec3(0.0f))->enableGravity();
+        }
+        double stepMs = bestMilliseconds([&]() {
+            for (int s = 0; s < numSteps; ++s) {
+                physx.step(0.01f);
+            }
+        }, 1) / numSteps;
+        int below = 0;
+        for (PhysxObject* p : physx.getObjects()) {
+            glm::vec3 position = p->model->worldPosition;
+            below += (p->shape == SPHERE && position.y < terrainHeight(position.x, position.z) - 0.5f) ? 1 : 0;
+        }
+
+        printf("%10d %10.1f %8d %14.3g %14.3g %10.3f %10d %8d%s\n", (int)corners.size() / 3, buildMs, bvh.getNodeCount(),
+               numQueries / (bvhMs / 1000.0), bruteQueries / (bruteMs / 1000.0), stepMs, physx.getContactCount(), below, (sum < 0.0f) ? "!" : "");
+    }
+    return 0;
+}
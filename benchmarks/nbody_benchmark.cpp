@@ -0,0 +1,103 @@
+/** @file nbody_benchmark.cpp
+ *  @brief Throughput of the all-pairs gravity kernel against the per-planet loop of SolarSystemPhysx.
+ *
+ *  @details For every body count (default 1000, 2000, 5000 and 10000, or the counts given as
+ *  arguments) bodies are placed uniformly in a ball, and the accelerations are computed with
+ *  the NBodyPhysx kernel and with a loop written like SolarSystemPhysx::step (glm, distance,
+ *  pow and normalize per pair). Reports pair interactions per second and the largest relative
+ *  error against a double precision sum on 100 sampled bodies.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "HeadlessScene.hpp"
+#include "../src/NBody.hpp"
+
+static double bestMilliseconds(const std::function<void()>& f, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief All-pairs accelerations the way SolarSystemPhysx::step computes the sun's pull on a planet.
+ */
+static void perPlanetLoop(const std::vector<PhysxObject*>& objects, float softening2, std::vector<glm::vec3>& accelerations) {
+    int n = objects.size();
+    for (int i = 0; i < n; ++i) {
+        PhysxObject* p = objects[i];
+        glm::vec3 force = glm::vec3(0);
+        for (int j = 0; j < n; ++j) {
+            if (j == i) {
+                continue;
+            }
+            PhysxObject* q = objects[j];
+            float gForce = p->mass * q->mass / (glm::pow(glm::distance(p->model->worldPosition, q->model->worldPosition), 2) + softening2);
+            glm::vec3 gForceDirection = glm::normalize(q->model->worldPosition - p->model->worldPosition);
+            force += gForceDirection * gForce;
+        }
+        accelerations[i] = force / p->mass;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> counts = {1000, 2000, 5000, 10000};
+    if (argc > 1) {
+        counts.clear();
+        for (int a = 1; a < argc; ++a) {
+            counts.push_back(std::atoi(argv[a]));
+        }
+    }
+
+    NBodyPhysx physx;
+    printf("kernel %s, %d threads, softening %.3f\n", NBodyPhysx::kernelName(), physx.numThreads, physx.softening);
+    printf("%8s %14s %14s %14s %14s %10s %12s\n", "bodies", "kernel ms", "interact/s", "loop ms", "interact/s", "speedup", "max rel err");
+
+    for (int n : counts) {
+        NBodyPhysx nbody;
+        HeadlessScene scene;
+        srand(42);
+        std::vector<glm::vec3> positions(n), velocities(n, glm::vec3(0.0f)), kernel(n), loop(n);
+        for (int i = 0; i < n; ++i) {
+            glm::vec3 p;
+            do {
+                p = glm::vec3((1.0f * rand()) / RAND_MAX, (1.0f * rand()) / RAND_MAX, (1.0f * rand()) / RAND_MAX) * 2.0f - 1.0f;
+            } while (glm::dot(p, p) > 1.0f);
+            positions[i] = p * 100.0f;
+            Sphere* model = new Sphere(1, 4, COUNT_ONLY);
+            model->worldPosition = positions[i];
+            scene.addBody(nbody, model, SPHERE, 1.0f + 9.0f * (1.0f * rand()) / RAND_MAX, glm::vec3(0.0f));
+        }
+
+        double interactions = (double)n * n;
+        double kernelMs = bestMilliseconds([&]() { nbody.computeAccelerations(positions, velocities, kernel); }, 5);
+        double loopMs = bestMilliseconds([&]() { perPlanetLoop(nbody.getObjects(), nbody.softening * nbody.softening, loop); }, n > 5000 ? 1 : 3);
+
+        double maxError = 0.0;
+        double softening2 = (double)nbody.softening * nbody.softening;
+        for (int s = 0; s < 100; ++s) {
+            int i = (int)((long long)s * n / 100);
+            double ax = 0.0, ay = 0.0, az = 0.0;
+            for (int j = 0; j < n; ++j) {
+                double dx = (double)positions[j].x - positions[i].x, dy = (double)positions[j].y - positions[i].y, dz = (double)positions[j].z - positions[i].z;
+                double r2 = dx * dx + dy * dy + dz * dz + softening2;
+                double f = nbody.getObjects()[j]->mass / (r2 * std::sqrt(r2));
+                ax += dx * f, ay += dy * f, az += dz * f;
+            }
+            double reference = std::sqrt(ax * ax + ay * ay + az * az);
+            double error = std::sqrt((kernel[i].x - ax) * (kernel[i].x - ax) + (kernel[i].y - ay) * (kernel[i].y - ay) + (kernel[i].z - az) * (kernel[i].z - az)) / reference;
+            maxError = std::max(maxError, error);
+        }
+
+        printf("%8d %14.3f %14.3e %14.3f %14.3e %9.1fx %12.2e\n", n, kernelMs, interactions / (kernelMs * 1e-3), loopMs, interactions / (loopMs * 1e-3), loopMs / kernelMs, maxError);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/** @file scene_file_benchmark.cpp
+ *  @brief Load and save timings of the text and binary scene file forms.
+ *
+ *  @details Builds a collision scene with 100k sphere bodies (or the count given as the first argument),
+ *  then times saving and loading it in both forms, and instantiating it headless.
+ */
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "../src/SceneFile.hpp"
+
+static double timeMilliseconds(const std::function<void()>& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static long fileSize(const std::string& path) {
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0) ? st.st_size : -1;
+}
+
+int main(int argc, char** argv) {
+    const int numBodies = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    const std::string textPath = "/tmp/myblender_benchmark.scene";
+    const std::string binaryPath = "/tmp/myblender_benchmark.mbscene";
+
+    srand(42);
+    SceneDocument document;
+    document.header.engine = SCENE_ENGINE_COLLISION;
+    document.header.timeStep = 0.02f;
+    SceneModelRecord& ground = document.addModel(PLANE_MODEL, "", 0.0f, 10u);
+    ground.translation[1] = -12.0f;
+    document.addBody(0, PLANE, 2.0f, glm::vec3(0.0f));
+    for (int i = 0; i < numBodies; ++i) {
+        SceneModelRecord& sphere = document.addModel(SPHERE_MODEL, "", (1.0f * rand()) / RAND_MAX + 0.5f, 8u);
+        for (int j = 0; j < 3; ++j) {
+            sphere.translation[j] = (1.0f * rand()) / RAND_MAX * 30.0f;
+            sphere.diffuse[j] = (1.0f * rand()) / RAND_MAX;
+        }
+        sphere.hasMaterial = 1u;
+        document.addBody(i + 1, SPHERE, 5.0f, glm::vec3((1.0f * rand()) / RAND_MAX - 0.5f, 0.0f, 0.0f), SCENE_BODY_GRAVITY | SCENE_BODY_AIR_RESISTANCE);
+    }
+
+    printf("Scene with %d bodies\n", numBodies);
+    printf("%-28s %10s\n", "operation", "ms");
+
+    printf("%-28s %10.2f\n", "save text", timeMilliseconds([&]() { document.saveText(textPath); }));
+    printf("%-28s %10.2f\n", "save binary", timeMilliseconds([&]() { document.saveBinary(binaryPath); }));
+
+    SceneDocument textDocument;
+    printf("%-28s %10.2f\n", "load text", timeMilliseconds([&]() { textDocument.loadText(textPath); }));
+
+    SceneFileView view;
+    double checksum = 0.0;
+    printf("%-28s %10.2f\n", "load binary (map + walk)", timeMilliseconds([&]() {
+               view.open(binaryPath);
+               const SceneData& data = view.data();
+               for (std::uint32_t i = 0; i < data.header->numBodies; ++i) {
+                   checksum += data.bodies[i].mass + data.models[data.bodies[i].model].translation[0];
+               }
+           }));
+
+    Scene scene;
+    SceneInstance instance;
+    printf("%-28s %10.2f\n", "instantiate (headless)", timeMilliseconds([&]() { instance.instantiate(view.data(), &scene, "", COUNT_ONLY); }));
+
+    printf("\ntext file   %10ld bytes\nbinary file %10ld bytes\n", fileSize(textPath), fileSize(binaryPath));
+    printf("round trip  %s (checksum %.3f)\n", (textDocument.models.size() == document.models.size() && textDocument.bodies.size() == document.bodies.size()) ? "ok" : "MISMATCH", checksum);
+
+    remove(textPath.c_str());
+    remove(binaryPath.c_str());
+    return 0;
+}
@@ -0,0 +1,71 @@
+/** @file trajectory_benchmark.cpp
+ *  @brief Cost of streaming trajectories of a headless collision run to a file.
+ *
+ *  @details Runs the main.cpp box with the given number of spheres (default 200) for the
+ *  given number of steps (default 5000), first without and then with a TrajectoryRecorder,
+ *  and reads random frames back to check them.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "HeadlessScene.hpp"
+#include "../src/Trajectory.hpp"
+
+static double runMilliseconds(int numSpheres, int numSteps, TrajectoryRecorder* recorder) {
+    CollisionPhysx physx;
+    HeadlessScene scene;
+    scene.buildCollisionScene(physx, numSpheres);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < numSteps; ++step) {
+        physx.step(0.02f);
+        if (recorder != nullptr) {
+            recorder->record(physx, step + 1);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    const int numSpheres = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int numSteps = (argc > 2) ? std::atoi(argv[2]) : 5000;
+    const std::string path = "/tmp/myblender_benchmark.trajectory";
+    const std::uint32_t numBodies = numSpheres + 5;
+
+    double plain = runMilliseconds(numSpheres, numSteps, nullptr);
+
+    TrajectoryRecorder recorder;
+    recorder.open(path, numBodies, 0.02f);
+    double recorded = runMilliseconds(numSpheres, numSteps, &recorder);
+    recorder.close();
+
+    printf("%d bodies, %d steps\n", numBodies, numSteps);
+    printf("without recorder %10.2f ms\n", plain);
+    printf("with recorder    %10.2f ms (%+.1f%%, %llu ring stalls, %llu frames dropped)\n", recorded, 100.0 * (recorded - plain) / plain, (unsigned long long)recorder.getStalls(), (unsigned long long)recorder.getFramesDropped());
+
+    TrajectoryReader reader;
+    if (!reader.open(path)) {
+        return 1;
+    }
+    srand(7);
+    bool ordered = true;
+    auto start = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+        std::uint64_t index = rand() % reader.getFrameCount();
+        TrajectoryFrame frame = reader.frame(index);
+        ordered = ordered && frame.step == index + 1;
+        checksum += frame.px[rand() % numBodies] + frame.vy[rand() % numBodies];
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("file %llu frames of %u bytes, 10000 random frame reads %.2f ms, frames %s (checksum %.3f)\n",
+           (unsigned long long)reader.getFrameCount(), TrajectoryRecorder::frameSizeFor(numBodies),
+           std::chrono::duration<double, std::milli>(end - start).count(), ordered ? "in order" : "OUT OF ORDER", checksum);
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,44 @@
+# Make sure you have GLEW and GLM installed in the global /usr/include/ folder.
+# Then run this script. The benchmarks are headless and do not need ImGui.
+
+BUILD_DIR="./build"
+
+CXXFLAGS="-O2 -Wall -Wformat -ffp-contract=off"
+LDLIBS="-lGLEW -lGL -lpthread -lassimp"
+
+mkdir -p $BUILD_DIR
+
+sh ./compile_engine.sh || exit 1
+
+g++ $CXXFLAGS -o $BUILD_DIR/scene_file_benchmark benchmarks/scene_file_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building scene_file_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/trajectory_benchmark benchmarks/trajectory_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building trajectory_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/integrator_benchmark benchmarks/integrator_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building integrator_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/nbody_benchmark benchmarks/nbody_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building nbody_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/fmm_benchmark benchmarks/fmm_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building fmm_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/mesh_collider_benchmark benchmarks/mesh_collider_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building mesh_collider_benchmark."
+
+g++ $CXXFLAGS -o $BUILD_DIR/determinism_benchmark benchmarks/determinism_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building determinism_benchmark."
+
+# Exits with 1 when a warmed up step still allocates.
+g++ $CXXFLAGS -o $BUILD_DIR/allocation_benchmark benchmarks/allocation_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building allocation_benchmark."
+
+# The scalability test: step time against the number of live bodies while spheres are poured in.
+g++ $CXXFLAGS -o $BUILD_DIR/emitter_benchmark benchmarks/emitter_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building emitter_benchmark."
+
+# Google Benchmark suite over the hot paths, needs libbenchmark. The renderer cases open a hidden GLFW window.
+g++ $CXXFLAGS -o $BUILD_DIR/hot_paths_benchmark benchmarks/hot_paths_benchmark.cpp $BUILD_DIR/libmyblender_engine.a $LDLIBS -lglfw -lbenchmark
+echo ">> Finished compiling, linking, and building hot_paths_benchmark."
@@ -0,0 +1,18 @@
+# Make sure you have Assimp, GLEW, and GLM installed in the global /usr/include/ folder.
+# Builds the engine in src/ into a static library the apps and benchmarks link against.
+# The other compile scripts run this one first.
+
+BUILD_DIR="./build"
+
+# -ffp-contract=off is needed for deterministic runs, see myblender_options in CMakeLists.txt.
+# -march=native compiles the AVX2 or AVX-512 N-body kernel in when the CPU has it.
+CXXFLAGS="-O2 -g -Wall -Wformat -ffp-contract=off -march=native"
+
+mkdir -p $BUILD_DIR/engine
+
+for source in src/*.cpp; do
+    g++ $CXXFLAGS -c -o $BUILD_DIR/engine/$(basename $source .cpp).o $source || exit 1
+done
+rm -f $BUILD_DIR/libmyblender_engine.a
+ar rcs $BUILD_DIR/libmyblender_engine.a $BUILD_DIR/engine/*.o
+echo ">> Finished compiling the engine."
@@ -6,7 +6,7 @@
 BUILD_DIR="./build"
 IMGUI_DIR="./vendor/imgui"
 
-CXXFLAGS="-g -Wall -Wformat"
+CXXFLAGS="-g -Wall -Wformat -ffp-contract=off"
 LDLIBS="-lglfw -lGLEW -lGL -lX11 -lpthread -lXrandr -lXi -ldl -lassimp"
 
 mkdir -p $BUILD_DIR
@@ -21,8 +21,10 @@ mkdir -p $BUILD_DIR
 # g++ $CXXFLAGS -c -o  $BUILD_DIR/imgui_widgets.o $IMGUI_DIR/imgui_widgets.cpp
 # echo ">> Finished compiling ImGui."
 
+sh ./compile_engine.sh || exit 1
+
 g++ $CXXFLAGS -c -o $BUILD_DIR/newtons_cradle.o newtons_cradle.cpp
 echo ">> Finished compiling main."
 
-g++ $CXXFLAGS -o myNewtonsCradle $BUILD_DIR/newtons_cradle.o $BUILD_DIR/imgui.o $BUILD_DIR/imgui_demo.o $BUILD_DIR/imgui_draw.o $BUILD_DIR/imgui_impl_glfw.o $BUILD_DIR/imgui_impl_opengl3.o $BUILD_DIR/imgui_tables.o $BUILD_DIR/imgui_widgets.o $LDLIBS
+g++ $CXXFLAGS -o myNewtonsCradle $BUILD_DIR/newtons_cradle.o $BUILD_DIR/imgui.o $BUILD_DIR/imgui_demo.o $BUILD_DIR/imgui_draw.o $BUILD_DIR/imgui_impl_glfw.o $BUILD_DIR/imgui_impl_opengl3.o $BUILD_DIR/imgui_tables.o $BUILD_DIR/imgui_widgets.o $BUILD_DIR/libmyblender_engine.a $LDLIBS
 echo ">> Finished compiling, linking, and building myBlender."
\ No newline at end of file
@@ -0,0 +1,17 @@
+# Make sure you have Assimp, GLEW, and GLM installed in the global /usr/include/ folder.
+# Then run this script. The sweep is headless and does not need ImGui or GLFW.
+
+BUILD_DIR="./build"
+
+CXXFLAGS="-O2 -Wall -Wformat -ffp-contract=off"
+LDLIBS="-lGLEW -lGL -lpthread -lassimp"
+
+mkdir -p $BUILD_DIR
+
+sh ./compile_engine.sh || exit 1
+
+g++ $CXXFLAGS -c -o $BUILD_DIR/parameter_sweep.o parameter_sweep.cpp
+echo ">> Finished compiling parameter_sweep."
+
+g++ $CXXFLAGS -o myParameterSweep $BUILD_DIR/parameter_sweep.o $BUILD_DIR/libmyblender_engine.a $LDLIBS
+echo ">> Finished compiling, linking, and building myParameterSweep."
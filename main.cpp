@@ -5,7 +5,11 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <iostream>
+
+#include "src/Emitter.hpp"
 #include "src/Renderer.hpp"
+#include "src/SceneFile.hpp"
 
 void logString(const std::string& s);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -30,6 +34,7 @@ const float PLANE_SCALE = 10.0f;
 const float BOUNDING_BOX_DIST = 50.0f;
 const float VALUE_DOWN_SCALER = 2.0f;
 const int NUM_SPHERES = 12;
+const char* SCENE_FILE_PATH = "myBlender.scene";
 
 int main() {
     srand(time(NULL));
@@ -52,7 +57,7 @@ int main() {
 
     GLenum err = glewInit();
     if (err != GLEW_OK) {
-        cout << "glewInit failed: " << glewGetErrorString(err) << endl;
+        std::cout << "glewInit failed: " << glewGetErrorString(err) << std::endl;
         exit(1);
     }
 
@@ -61,6 +66,8 @@ int main() {
     Renderer renderer = Renderer(PerpectiveProperties(SCR_WIDTH, SCR_HEIGHT), 0.02f, glm::vec3(50.0f, 50.0f, 50.0f));
     Scene* scene = renderer.getScene();
     CollisionPhysx physx = CollisionPhysx();
+    physx.enableContactSolver();
+    physx.enableSleeping();
     scene->attachPhysics(&physx);
 
     Plane groundPlane = Plane("/home/karthikrangasai/Documents/Acads/4th Year/4 - 2/IS F311 Comp Graphics/assignment/assignment_2/problem_statement/plane.obj");
@@ -97,7 +104,7 @@ int main() {
     wallFour.updateTransforms();
     wallFour.meshes[0].material.setDiffuseColor(glm::vec3((1.0f * rand()) / RAND_MAX, (1.0f * rand()) / RAND_MAX, (1.0f * rand()) / RAND_MAX));
 
-    vector<Sphere> spheres;
+    std::vector<Sphere> spheres;
     for (int i = 0; i < NUM_SPHERES; ++i) {
         spheres.push_back(
             Sphere(
@@ -119,30 +126,30 @@ int main() {
         scene->addModel(&spheres[i]);
     }
 
-    PhysxObject gPlane = PhysxObject(PhysxShape::PLANE, &groundPlane, 2.0f, glm::vec3(0, 0, 0));
-    PhysxObject gWallOne = PhysxObject(PhysxShape::PLANE, &wallOne, 2.0f, glm::vec3(0, 0, 0));
-    PhysxObject gwallTwo = PhysxObject(PhysxShape::PLANE, &wallTwo, 2.0f, glm::vec3(0, 0, 0));
-    PhysxObject gwallThree = PhysxObject(PhysxShape::PLANE, &wallThree, 2.0f, glm::vec3(0, 0, 0));
-    PhysxObject gwallFour = PhysxObject(PhysxShape::PLANE, &wallFour, 2.0f, glm::vec3(0, 0, 0));
+    physx.createBody(PhysxShape::PLANE, &groundPlane, 2.0f, glm::vec3(0, 0, 0));
+    physx.createBody(PhysxShape::PLANE, &wallOne, 2.0f, glm::vec3(0, 0, 0));
+    physx.createBody(PhysxShape::PLANE, &wallTwo, 2.0f, glm::vec3(0, 0, 0));
+    physx.createBody(PhysxShape::PLANE, &wallThree, 2.0f, glm::vec3(0, 0, 0));
+    physx.createBody(PhysxShape::PLANE, &wallFour, 2.0f, glm::vec3(0, 0, 0));
 
-    vector<PhysxObject> spherePhysx;
+    std::vector<BodyHandle> sphereBodies;
     for (int i = 0; i < NUM_SPHERES; ++i) {
         float mass = (((1.0f * rand()) / RAND_MAX + 1.0f) * 10.0f) * glm::pow(spheres[i].radius, 3);
-        spherePhysx.push_back(PhysxObject(PhysxShape::SPHERE, &spheres[i], mass, glm::vec3((((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f)));
-        spherePhysx[i].enableGravity();
-        spherePhysx[i].enableAirResistance();
+        sphereBodies.push_back(physx.createBody(PhysxShape::SPHERE, &spheres[i], mass, glm::vec3((((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f, (((1.0f * rand()) / RAND_MAX) - 0.5f) * 10.0f)));
+        physx.getBody(sphereBodies[i])->enableGravity();
+        physx.getBody(sphereBodies[i])->enableAirResistance();
     }
+    scene->isPhysicsOn = false;
 
-    physx.addObject(&gPlane);
-    physx.addObject(&gWallOne);
-    physx.addObject(&gwallTwo);
-    physx.addObject(&gwallThree);
-    physx.addObject(&gwallFour);
+    SimulationHistory history = SimulationHistory(&physx);
+    scene->attachHistory(&history);
 
-    for (int i = 0; i < NUM_SPHERES; ++i) {
-        physx.addObject(&spherePhysx[i]);
-    }
-    scene->isPhysicsOn = false;
+    // Holds the models and physics of a scene loaded through the GUI.
+    SceneInstance loadedScene;
+
+    // Pours spheres into the box to find how many bodies the simulation keeps up with.
+    SphereEmitter emitter(&physx, EmitterSettings(), time(NULL), GPU_ONLY, scene);
+    bool emitting = false;
 
     // ImGui Setup
     IMGUI_CHECKVERSION();
@@ -178,11 +185,13 @@ int main() {
 
             ImGui::Separator();
 
-            for (unsigned int i = 0; i < renderer.scene.models.size(); ++i) {
+            // The models of the emitter are at the end of the list and are not listed.
+            unsigned int numListed = renderer.scene.getModels().size() - (emitting ? emitter.getAliveCount() : 0);
+            for (unsigned int i = 0; i < numListed; ++i) {
                 char v[] = "Model 10";
                 snprintf(v, (5 + 1 + 2), "Model %d", (i + 1));
-                ImGui::Checkbox(v, &(renderer.scene.models[i]->visibility));
-                if ((i + 1) != renderer.scene.models.size()) {
+                ImGui::Checkbox(v, &(renderer.scene.getModels()[i]->visibility));
+                if ((i + 1) != numListed) {
                     ImGui::SameLine();
                 }
             }
@@ -190,14 +199,22 @@ int main() {
             ImGui::Separator();
 
             static int modelNumber = 0;
-            for (unsigned int i = 0; i < renderer.scene.models.size(); ++i) {
+            for (unsigned int i = 0; i < numListed; ++i) {
                 char v[] = "Model 10";
                 snprintf(v, (5 + 1 + 2), "Model %d", (i + 1));
                 ImGui::RadioButton(v, &modelNumber, i);
-                if ((i + 1) != renderer.scene.models.size()) {
+                if ((i + 1) != numListed) {
                     ImGui::SameLine();
                 }
             }
+            if (modelNumber < (int)numListed) {
+                Model* selected = renderer.scene.getModels()[modelNumber];
+                // Plane::updateTransforms() rotates the current normal again, so planes are not moved from here.
+                if (selected->type != PLANE_MODEL && ImGui::SliderFloat3("Model Position", selected->_translation, -BOUNDING_BOX_DIST, BOUNDING_BOX_DIST)) {
+                    selected->updateTransforms();
+                    history.discardAfter(history.getCurrentStep());
+                }
+            }
             ImGui::Separator();
 
             {
@@ -217,6 +234,63 @@ int main() {
             if (ImGui::Button("Toggle Physics")) {
                 renderer.scene.isPhysicsOn = !renderer.scene.isPhysicsOn;
             }
+            // Snapshots cannot be restored once bodies have come and gone, so there is no rewinding while emitting.
+            if (!emitting) {
+                ImGui::SameLine();
+                if (ImGui::Button("Rewind 100 Steps")) {
+                    std::uint64_t step = history.getCurrentStep();
+                    history.seek(step > 100 ? step - 100 : 0);
+                }
+                ImGui::Text("Step %llu (%.1f KB recorded)", (unsigned long long)history.getCurrentStep(), history.getBufferSize() / 1024.0f);
+            }
+            if (renderer.scene.physx != nullptr && renderer.scene.physx->getEngine() == COLLISION_ENGINE) {
+                ImGui::Text("Active bodies %d", static_cast<CollisionPhysx*>(renderer.scene.physx)->getActiveCount());
+            }
+
+            if (renderer.scene.physx == &physx) {
+                if (ImGui::Checkbox("Sphere Emitter", &emitting)) {
+                    if (emitting) {
+                        scene->attachHistory(nullptr);
+                    } else {
+                        emitter.clear();
+                        history = SimulationHistory(&physx);
+                        scene->attachHistory(&history);
+                    }
+                }
+                ImGui::SliderFloat("Spheres per Second", &emitter.settings.rate, 10.0f, 2000.0f);
+                ImGui::SliderFloat("Sphere Lifetime", &emitter.settings.lifetime, 1.0f, 60.0f);
+                ImGui::Text("Live spheres %d, step %.2f ms", emitter.getAliveCount(), renderer.stepMilliseconds);
+            }
+
+            ImGui::Separator();
+
+            if (ImGui::Button("Save Scene")) {
+                SceneDocument document;
+                document.capture(renderer.scene, renderer.timeStep);
+                document.saveText(SCENE_FILE_PATH);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Load Scene")) {
+                if (emitting) {
+                    emitter.clear();
+                    emitting = false;
+                    scene->attachHistory(&history);
+                }
+                SceneInstance instance;
+                Scene loaded;
+                if (instance.load(SCENE_FILE_PATH, &loaded)) {
+                    renderer.scene.clearModels();
+                    for (Model* model : loaded.models) {
+                        renderer.scene.addModel(model);
+                    }
+                    renderer.scene.light = loaded.light;
+                    renderer.scene.physx = loaded.physx;
+                    renderer.scene.isPhysicsOn = loaded.isPhysicsOn;
+                    renderer.timeStep = instance.timeStep;
+                    loadedScene = std::move(instance);
+                    history = SimulationHistory(renderer.scene.physx);
+                }
+            }
 
             ImGui::Separator();
 
@@ -224,7 +298,14 @@ int main() {
             ImGui::End();
         }
 
+        bool emitterStep = emitting && renderer.scene.isPhysicsOn;
+        if (emitterStep) {
+            emitter.update(renderer.timeStep);
+        }
         renderer.renderAll();
+        if (emitterStep) {
+            emitter.recordStep(renderer.stepMilliseconds);
+        }
         ImGui::Render();
         int display_w, display_h;
         glfwGetFramebufferSize(window, &display_w, &display_h);
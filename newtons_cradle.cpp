@@ -5,6 +5,8 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <iostream>
+
 #include "src/Renderer.hpp"
 
 void logString(const std::string& s);
@@ -51,7 +53,7 @@ int main() {
 
     GLenum err = glewInit();
     if (err != GLEW_OK) {
-        cout << "glewInit failed: " << glewGetErrorString(err) << endl;
+        std::cout << "glewInit failed: " << glewGetErrorString(err) << std::endl;
         exit(1);
     }
 
@@ -68,7 +70,7 @@ int main() {
     groundPlane.updateTransforms();
     groundPlane.meshes[0].material.setDiffuseColor(glm::vec3(1.0f, 1.0f, 1.0f));
 
-    vector<Sphere> spheres;
+    std::vector<Sphere> spheres;
     for (int i = 0; i < NUM_SPHERES; ++i) {
         spheres.push_back(Sphere(SPHERE_RADIUS, 30));
         spheres[i]._translation[0] = 0.0f;
@@ -124,7 +126,7 @@ int main() {
     PhysxObject gwallTwo = PhysxObject(PhysxShape::PLANE, &wallTwo, 2.0f, glm::vec3(0, 0, 0));
     PhysxObject gwallThree = PhysxObject(PhysxShape::PLANE, &wallThree, 2.0f, glm::vec3(0, 0, 0));
     PhysxObject gwallFour = PhysxObject(PhysxShape::PLANE, &wallFour, 2.0f, glm::vec3(0, 0, 0));
-    vector<PhysxObject> spherePhysx;
+    std::vector<PhysxObject> spherePhysx;
     for (int i = 0; i < NUM_SPHERES; ++i) {
         spherePhysx.push_back(PhysxObject(PhysxShape::SPHERE, &spheres[i], 5.0f, glm::vec3(0.0f, 0.0f, 0.0f)));
     }
@@ -175,11 +177,11 @@ int main() {
 
             ImGui::Separator();
 
-            for (unsigned int i = 0; i < renderer.scene.models.size(); ++i) {
+            for (unsigned int i = 0; i < renderer.scene.getModels().size(); ++i) {
                 char v[] = "Model 10";
                 snprintf(v, (5 + 1 + 2), "Model %d", (i + 1));
-                ImGui::Checkbox(v, &(renderer.scene.models[i]->visibility));
-                if ((i + 1) != renderer.scene.models.size()) {
+                ImGui::Checkbox(v, &(renderer.scene.getModels()[i]->visibility));
+                if ((i + 1) != renderer.scene.getModels().size()) {
                     ImGui::SameLine();
                 }
             }
@@ -187,11 +189,11 @@ int main() {
             ImGui::Separator();
 
             static int modelNumber = 0;
-            for (unsigned int i = 0; i < renderer.scene.models.size(); ++i) {
+            for (unsigned int i = 0; i < renderer.scene.getModels().size(); ++i) {
                 char v[] = "Model 10";
                 snprintf(v, (5 + 1 + 2), "Model %d", (i + 1));
                 ImGui::RadioButton(v, &modelNumber, i);
-                if ((i + 1) != renderer.scene.models.size()) {
+                if ((i + 1) != renderer.scene.getModels().size()) {
                     ImGui::SameLine();
                 }
             }
@@ -0,0 +1,39 @@
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "src/ParameterSweep.hpp"
+
+// Usage: ./myParameterSweep [summary.csv] [seeds per combination] [steps] [threads]
+const int NUM_SEEDS = 100;
+const int NUM_STEPS = 300;
+const float TIME_STEP = 0.01f;
+
+int main(int argc, char** argv) {
+    std::string output = (argc > 1) ? argv[1] : "sweep.csv";
+    int numSeeds = (argc > 2) ? std::atoi(argv[2]) : NUM_SEEDS;
+    int numSteps = (argc > 3) ? std::atoi(argv[3]) : NUM_STEPS;
+    int numThreads = (argc > 4) ? std::atoi(argv[4]) : 0;
+
+    ParameterSweep sweep(numSteps, TIME_STEP, numThreads);
+    std::vector<unsigned> seeds;
+    for (int s = 0; s < numSeeds; ++s) {
+        seeds.push_back(s);
+    }
+    // NUM_SPHERES of main.cpp and larger boxes, around the masses and air viscosity of main.cpp.
+    sweep.addGrid(seeds, {12, 50, 200}, {0.5f, 1.0f, 2.0f}, {0.0f, 0.007f, 0.02f});
+
+    printf("Running %d worlds of %d steps on %d threads.\n", sweep.getWorldCount(), numSteps, sweep.numThreads);
+    auto start = std::chrono::steady_clock::now();
+    sweep.run(true);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Finished in %.2f s, %.1f worlds/s.\n", seconds, sweep.getWorldCount() / seconds);
+
+    if (!sweep.writeCSV(output)) {
+        return 1;
+    }
+    printf("Summary written to %s.\n", output.c_str());
+    return 0;
+}
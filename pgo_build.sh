@@ -0,0 +1,38 @@
+# Profile guided build of the apps and benchmarks with CMake.
+# 1. Build instrumented binaries, 2. train them on the headless benchmark scenes,
+# 3. rebuild with the recorded profiles. Extra arguments are passed to the CMake configure steps,
+# e.g. -DMYBLENDER_MARCH=x86-64-v3.
+
+BUILD_DIR="./build-pgo"
+PROFILE_DIR="$(pwd)/$BUILD_DIR/pgo"
+
+set -e
+
+rm -rf $PROFILE_DIR
+cmake -S . -B $BUILD_DIR -DCMAKE_BUILD_TYPE=Release -DMYBLENDER_LTO=ON -DMYBLENDER_PGO=GENERATE -DMYBLENDER_PGO_DIR=$PROFILE_DIR "$@"
+cmake --build $BUILD_DIR -j --clean-first
+echo ">> Finished building the instrumented binaries."
+
+# The training runs cover the collision engine with and without the solver, spawning and removing
+# bodies, the integrators, the N-body kernels, the mesh colliders and the scene files.
+# Only the profile of the allocation check matters here, not its verdict.
+$BUILD_DIR/allocation_benchmark 400 || true
+$BUILD_DIR/emitter_benchmark 250 4
+$BUILD_DIR/determinism_benchmark 500
+$BUILD_DIR/integrator_benchmark 100
+$BUILD_DIR/nbody_benchmark 1000 4000
+$BUILD_DIR/fmm_benchmark 4000
+$BUILD_DIR/mesh_collider_benchmark
+$BUILD_DIR/scene_file_benchmark 10000
+$BUILD_DIR/trajectory_benchmark 200 1000
+$BUILD_DIR/myParameterSweep $BUILD_DIR/pgo_sweep.csv 1 200
+echo ">> Finished the training runs."
+
+# Clang writes raw profiles that have to be merged first.
+if ls $PROFILE_DIR/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output=$PROFILE_DIR/default.profdata $PROFILE_DIR/*.profraw
+fi
+
+cmake -S . -B $BUILD_DIR -DMYBLENDER_PGO=USE "$@"
+cmake --build $BUILD_DIR -j --clean-first
+echo ">> Finished building the profile guided binaries in $BUILD_DIR."
@@ -0,0 +1,16 @@
+# Build the benchmarks with compile_benchmarks.sh first.
+# Runs the hot paths benchmark and writes its results as JSON, one file per commit, so runs of
+# different commits can be compared, e.g. with compare.py from the Google Benchmark tools.
+
+BUILD_DIR="./build"
+RESULTS_DIR="./benchmark_results"
+
+mkdir -p $RESULTS_DIR
+
+COMMIT=$(git rev-parse --short HEAD)
+if ! git diff --quiet HEAD; then
+    COMMIT="$COMMIT-dirty"
+fi
+
+$BUILD_DIR/hot_paths_benchmark --benchmark_out=$RESULTS_DIR/$COMMIT.json --benchmark_out_format=json "$@"
+echo ">> Wrote $RESULTS_DIR/$COMMIT.json"
@@ -5,6 +5,7 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 
@@ -55,7 +56,7 @@ int main() {
 
     GLenum err = glewInit();
     if (err != GLEW_OK) {
-        cout << "glewInit failed: " << glewGetErrorString(err) << endl;
+        std::cout << "glewInit failed: " << glewGetErrorString(err) << std::endl;
         exit(1);
     }
 
@@ -64,6 +65,8 @@ int main() {
     Renderer renderer = Renderer(PerpectiveProperties(SCR_WIDTH, SCR_HEIGHT), 0.05, glm::vec3(20.0f, 20.0f, 20.0f));
     Scene* universe = renderer.getScene();
     SolarSystemPhysx ssp = SolarSystemPhysx();
+    ssp.setIntegrator(IntegratorType::LEAPFROG);
+    ssp.enableAdaptiveTimeStep();
     // SETUP SCENE //
     Sphere sun = Sphere(5, 30);
     sun.meshes[0].material.setDiffuseColor(glm::vec3(0.937f, 0.557f, 0.22f));
@@ -87,6 +90,12 @@ int main() {
     earth.meshes[0].material.setDiffuseColor(glm::vec3(0.0f, 0.9f, 0.9f));
     PhysxObject earthPhysics = PhysxObject(PhysxShape::SPHERE, &earth, 16, glm::vec3(0, glm::sqrt(100 / 25), 0));
 
+    // Attached to the earth below: it follows the earth and goes round as the earth turns.
+    Sphere moon = Sphere(0.5, 16);
+    moon._translation[0] = 3.5;
+    moon.updateTransforms();
+    moon.meshes[0].material.setDiffuseColor(glm::vec3(0.75f, 0.75f, 0.75f));
+
     Sphere mars = Sphere(1.5, 20);
     mars._translation[0] = 30;
     mars.updateTransforms();
@@ -97,6 +106,7 @@ int main() {
     universe->addModel(&mercury);
     universe->addModel(&venus);
     universe->addModel(&earth);
+    universe->addModel(&moon, &earth);
     universe->addModel(&mars);
 
     ssp.addObject(&sunPhysics);
@@ -158,6 +168,10 @@ int main() {
             ImGui::End();
         }
 
+        if (renderer.scene.isPhysicsOn) {
+            // Degrees per second. The physics applies the new rotation when it moves the earth.
+            earth._rotation[1] = std::fmod(earth._rotation[1] + 60.0f * deltaTime, 360.0f);
+        }
         renderer.renderAll();
         ImGui::Render();
         int display_w, display_h;
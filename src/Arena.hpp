@@ -0,0 +1,300 @@
+/** @file Arena.hpp
+ *  @brief Class definitions for a bump allocator that frees everything at once, and a pool of reusable slots.
+ *
+ *  @details Objects are placed one after the other in large blocks, so creating one costs an
+ *  addition instead of a call into the heap, and threads with their own arenas never contend
+ *  for the heap lock. Nothing is freed on its own: reset() destroys every object and rewinds to
+ *  the first block, keeping the blocks for the next round of allocations. Objects that come and
+ *  go one at a time are kept in a Pool instead.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @class Arena
+ *  @brief Bump allocator owning the objects created in it, see arenaNew().
+ *  @details An arena is not thread safe. Give every thread its own.
+ */
+class Arena {
+   public:
+    //! Size of the blocks allocations are taken from. Larger allocations get a block of their own.
+    static const std::size_t DEFAULT_BLOCK_SIZE = 1 << 16;
+
+    /**
+	 * @brief Construct a new Arena. No memory is taken until the first allocation.
+	 *
+	 * @param blockSize
+	 */
+    Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE) {
+        this->blockSize = blockSize;
+        this->current = 0;
+        this->offset = 0;
+        this->finalizers = nullptr;
+        this->allocationCount = 0;
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        this->reset();
+    }
+
+    /**
+	 * @brief Take size bytes from the arena. The memory lives until the next reset().
+	 *
+	 * @param size
+	 * @param alignment A power of two.
+	 * @return void*
+	 */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        while (this->current < this->blocks.size()) {
+            Block& block = this->blocks[this->current];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+            std::uintptr_t aligned = (base + this->offset + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+            if (aligned + size <= base + block.size) {
+                this->offset = aligned + size - base;
+                ++this->allocationCount;
+                return reinterpret_cast<void*>(aligned);
+            }
+            // The rest of the block is wasted until the next reset.
+            ++this->current;
+            this->offset = 0;
+        }
+
+        Block block;
+        block.size = std::max(this->blockSize, size + alignment);
+        block.data.reset(new char[block.size]);
+        this->blocks.push_back(std::move(block));
+        return this->allocate(size, alignment);
+    }
+
+    /**
+	 * @brief Call destroy on object when the arena is reset. Finalizers run newest first.
+	 *
+	 * @param destroy
+	 * @param object
+	 */
+    void onReset(void (*destroy)(void*), void* object) {
+        Finalizer* finalizer = static_cast<Finalizer*>(this->allocate(sizeof(Finalizer), alignof(Finalizer)));
+        finalizer->destroy = destroy;
+        finalizer->object = object;
+        finalizer->next = this->finalizers;
+        this->finalizers = finalizer;
+    }
+
+    /**
+	 * @brief Destroy every object created in the arena and make all of its memory available again.
+	 */
+    void reset() {
+        while (this->finalizers != nullptr) {
+            Finalizer* finalizer = this->finalizers;
+            this->finalizers = finalizer->next;
+            finalizer->destroy(finalizer->object);
+        }
+        this->current = 0;
+        this->offset = 0;
+    }
+
+    /**
+	 * @brief Get the number of bytes held in blocks, used or not.
+	 *
+	 * @return std::size_t
+	 */
+    std::size_t getCapacity() const {
+        std::size_t capacity = 0;
+        for (const Block& block : this->blocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    /**
+	 * @brief Get the number of allocations made since the arena was constructed.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getAllocationCount() const {
+        return this->allocationCount;
+    }
+
+   private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    std::size_t blockSize;
+    std::vector<Block> blocks;
+    //! Block allocations are taken from, and the number of bytes of it in use.
+    std::size_t current;
+    std::size_t offset;
+    //! Objects to destroy on reset, newest first.
+    Finalizer* finalizers;
+    std::uint64_t allocationCount;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+// Templates cannot have C linkage.
+
+/** @class Pool
+ *  @brief Fixed size slots for objects of one type, reused through a free list.
+ *  @details Objects never move, so pointers to them stay valid until they are destroyed. Slots
+ *  are taken from the heap a chunk at a time, so once a pool has grown to the largest number of
+ *  objects alive at once, creating and destroying objects no longer touches the heap. Objects
+ *  still alive are destroyed with the pool.
+ */
+template <typename T>
+class Pool {
+   public:
+    //! Number of slots taken from the heap at once.
+    static const std::size_t CHUNK_SIZE = 256;
+
+    Pool() {
+        this->freeList = nullptr;
+        this->liveCount = 0;
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    ~Pool() {
+        for (std::unique_ptr<Slot[]>& chunk : this->chunks) {
+            for (std::size_t s = 0; s < CHUNK_SIZE; ++s) {
+                if (chunk[s].live) {
+                    chunk[s].object()->~T();
+                }
+            }
+        }
+    }
+
+    /**
+	 * @brief Construct an object in a free slot.
+	 *
+	 * @param args Arguments of the constructor of T.
+	 * @return T*
+	 */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (this->freeList == nullptr) {
+            this->grow();
+        }
+        Slot* slot = this->freeList;
+        this->freeList = slot->next;
+        T* object = new (slot->storage) T(std::forward<Args>(args)...);
+        slot->live = true;
+        ++this->liveCount;
+        return object;
+    }
+
+    /**
+	 * @brief Destroy an object created by this pool and free its slot.
+	 *
+	 * @param object
+	 */
+    void destroy(T* object) {
+        Slot* slot = reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(object) - offsetof(Slot, storage));
+        object->~T();
+        slot->live = false;
+        slot->next = this->freeList;
+        this->freeList = slot;
+        --this->liveCount;
+    }
+
+    /**
+	 * @brief Make sure count objects can be alive at once without taking memory from the heap.
+	 *
+	 * @param count
+	 */
+    void reserve(std::size_t count) {
+        while (this->chunks.size() * CHUNK_SIZE < count) {
+            this->grow();
+        }
+    }
+
+    /**
+	 * @brief Get the number of objects alive.
+	 *
+	 * @return std::size_t
+	 */
+    std::size_t size() const {
+        return this->liveCount;
+    }
+
+    /**
+	 * @brief Get the number of slots, alive or free.
+	 *
+	 * @return std::size_t
+	 */
+    std::size_t capacity() const {
+        return this->chunks.size() * CHUNK_SIZE;
+    }
+
+   private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot* next;
+        bool live;
+
+        T* object() {
+            return reinterpret_cast<T*>(this->storage);
+        }
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList;
+    std::size_t liveCount;
+
+    void grow() {
+        this->chunks.emplace_back(new Slot[CHUNK_SIZE]);
+        Slot* chunk = this->chunks.back().get();
+        // Link the new slots in order, so objects created one after the other are next to each other.
+        for (std::size_t s = CHUNK_SIZE; s-- > 0;) {
+            chunk[s].live = false;
+            chunk[s].next = this->freeList;
+            this->freeList = &chunk[s];
+        }
+    }
+};
+
+/**
+ * @brief Construct an object in an arena. It is destroyed when the arena is reset, never before.
+ *
+ * @param arena
+ * @param args Arguments of the constructor of T.
+ * @return T*
+ */
+template <typename T, typename... Args>
+T* arenaNew(Arena& arena, Args&&... args) {
+    T* object = new (arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+        arena.onReset([](void* p) { static_cast<T*>(p)->~T(); }, object);
+    }
+    return object;
+}
+
+#endif
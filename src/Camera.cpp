@@ -0,0 +1,168 @@
+/** @file Camera.cpp
+ *  @brief Implementation of the camera, see Camera.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ *  @author G Sathyaram (wreck-count)
+ */
+
+#include <glm/glm/gtc/matrix_transform.hpp>
+
+#include "Camera.hpp"
+
+Camera::Camera(glm::vec3 position) : Origin(0.0f, 0.0f, 0.0f) {
+    this->Position = glm::vec3(position);
+    this->WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->Center = glm::vec3(0.0f, 0.0f, 0.0f);
+
+    this->Front = this->Center - this->Position;
+    this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
+    this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
+    this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
+    this->Roll = 0.0f;
+
+    this->MovementSpeed = SPEED;
+    this->MouseSensitivity = SENSITIVITY;
+    // this->Zoom = ZOOM;
+
+    this->State = NON_PINNED;
+    updateCameraVectors();
+}
+
+void Camera::processKeyboard(Camera_Movement direction, float deltaTime) {
+    float velocity = MovementSpeed * deltaTime;
+    if (direction == FORWARD) {
+        Position += Front * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+    if (direction == BACKWARD) {
+        Position -= Front * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+    if (direction == LEFT) {
+        Position -= Right * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+    if (direction == RIGHT) {
+        Position += Right * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+    if (direction == UP) {
+        Position += Up * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+    if (direction == DOWN) {
+        Position -= Up * velocity;
+        this->Center = this->Position + this->Front;
+        this->State = NON_PINNED;
+    }
+
+    if (direction == PINNED_LEFT) {
+        Position -= Right * velocity;
+        this->updateFrontVector();
+        this->State = PINNED;
+    }
+    if (direction == PINNED_RIGHT) {
+        Position += Right * velocity;
+        this->updateFrontVector();
+        this->State = PINNED;
+    }
+    if (direction == PINNED_UP) {
+        Position += Up * velocity;
+        this->updateFrontVector();
+        this->State = PINNED;
+    }
+    if (direction == PINNED_DOWN) {
+        Position -= Up * velocity;
+        this->updateFrontVector();
+        this->State = PINNED;
+    }
+
+    if (direction == PITCH_UP) {
+        Pitch += this->MouseSensitivity;
+        this->updateCenterVector(this->MouseSensitivity, Right);
+    }
+    if (direction == PITCH_DOWN) {
+        Pitch -= this->MouseSensitivity;
+        this->updateCenterVector(-this->MouseSensitivity, Right);
+    }
+    if (direction == YAW_RIGHT) {
+        Yaw += this->MouseSensitivity;
+        this->updateCenterVector(this->MouseSensitivity, Up);
+    }
+    if (direction == YAW_LEFT) {
+        Yaw -= this->MouseSensitivity;
+        this->updateCenterVector(-this->MouseSensitivity, Up);
+    }
+    if (direction == ROLL_RIGHT) {
+        Roll += this->MouseSensitivity;
+        this->updateCenterVectorForRoll(this->MouseSensitivity, Front);
+    }
+    if (direction == ROLL_LEFT) {
+        Roll -= this->MouseSensitivity;
+        this->updateCenterVectorForRoll(-this->MouseSensitivity, Front);
+    }
+
+    this->updateCameraVectors();
+}
+
+void Camera::reset() {
+    this->Position = glm::vec3(7.0f, 3.0f, 0.0f);
+    this->WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->Center = glm::vec3(0.0f, 0.0f, 0.0f);
+
+    this->Front = this->Center - this->Position;
+    this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
+    this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
+    this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
+
+    this->MovementSpeed = SPEED;
+    this->MouseSensitivity = SENSITIVITY;
+
+    this->State = NON_PINNED;
+    updateCameraVectors();
+}
+
+void Camera::setPosition(const glm::vec3& position) {
+    this->Position = position;
+    this->updateFrontVector();
+}
+
+void Camera::updateFrontVector() {
+    this->Front = this->Center - this->Position;
+    this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
+    this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
+    this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
+}
+
+void Camera::updateCenterVector(float offsetAngle, glm::vec3 axis) {
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(offsetAngle), axis);
+    Front = glm::vec3(rotation * glm::vec4(Front, 1.0));
+
+    this->Center = this->Position + this->Front;
+    this->distanceFromCenter = glm::distance(this->Front, this->Center);
+}
+
+void Camera::updateCenterVectorForRoll(float offsetAngle, glm::vec3 axis) {
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(offsetAngle), axis);
+    Right = glm::vec3(rotation * glm::vec4(Right, 1.0));
+    Up = glm::normalize(glm::cross(Right, Front));
+}
+
+void Camera::updateCameraVectors() {
+    // also re-calculate the Right and Up vector
+    Right = glm::normalize(glm::cross(Front, Up));  // normalize the vectors, because their length gets closer to 0 the more you look up or down which results in slower movement.
+    Up = glm::normalize(glm::cross(Right, Front));
+
+    if (this->State == NON_PINNED) {
+        this->viewMatrix = glm::lookAt(Position, Position + Front, Up);
+    } else if (this->State == PINNED) {
+        this->viewMatrix = glm::lookAt(Position, Center, Up);
+    }
+}
@@ -1,4 +1,4 @@
-/** @file Camera.cpp
+/** @file Camera.hpp
  *  @brief Class definition for Camera.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -9,10 +9,6 @@
 #define CAMERA_H
 
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/matrix_transform.hpp>
-#include <vector>
-
-using namespace std;
 
 #ifdef __cplusplus
 extern "C" {
@@ -128,25 +124,7 @@ class Camera {
 	 * Camera's Up vector is initialzed with World Up which is initialized to Y-axis.
 	 * The camers starts in the NON_PINNED state.
 	*/
-    Camera(glm::vec3 position = glm::vec3(0)) : Origin(0.0f, 0.0f, 0.0f) {
-        this->Position = glm::vec3(position);
-        this->WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
-        this->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-        this->Center = glm::vec3(0.0f, 0.0f, 0.0f);
-
-        this->Front = this->Center - this->Position;
-        this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
-        this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
-        this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
-        this->Roll = 0.0f;
-
-        this->MovementSpeed = SPEED;
-        this->MouseSensitivity = SENSITIVITY;
-        // this->Zoom = ZOOM;
-
-        this->State = NON_PINNED;
-        updateCameraVectors();
-    }
+    Camera(glm::vec3 position = glm::vec3(0));
 
     /** @brief getViewMatrix - Returns the view matrix.
  	 * @details Returns the view matrix calculated using Camera's Euler Angles and the lookAt Matrix.
@@ -181,87 +159,7 @@ class Camera {
 	 * 
 	 * @return void
 	*/
-    void processKeyboard(Camera_Movement direction, float deltaTime) {
-        float velocity = MovementSpeed * deltaTime;
-        if (direction == FORWARD) {
-            Position += Front * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-        if (direction == BACKWARD) {
-            Position -= Front * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-        if (direction == LEFT) {
-            Position -= Right * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-        if (direction == RIGHT) {
-            Position += Right * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-        if (direction == UP) {
-            Position += Up * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-        if (direction == DOWN) {
-            Position -= Up * velocity;
-            this->Center = this->Position + this->Front;
-            this->State = NON_PINNED;
-        }
-
-        if (direction == PINNED_LEFT) {
-            Position -= Right * velocity;
-            this->updateFrontVector();
-            this->State = PINNED;
-        }
-        if (direction == PINNED_RIGHT) {
-            Position += Right * velocity;
-            this->updateFrontVector();
-            this->State = PINNED;
-        }
-        if (direction == PINNED_UP) {
-            Position += Up * velocity;
-            this->updateFrontVector();
-            this->State = PINNED;
-        }
-        if (direction == PINNED_DOWN) {
-            Position -= Up * velocity;
-            this->updateFrontVector();
-            this->State = PINNED;
-        }
-
-        if (direction == PITCH_UP) {
-            Pitch += this->MouseSensitivity;
-            this->updateCenterVector(this->MouseSensitivity, Right);
-        }
-        if (direction == PITCH_DOWN) {
-            Pitch -= this->MouseSensitivity;
-            this->updateCenterVector(-this->MouseSensitivity, Right);
-        }
-        if (direction == YAW_RIGHT) {
-            Yaw += this->MouseSensitivity;
-            this->updateCenterVector(this->MouseSensitivity, Up);
-        }
-        if (direction == YAW_LEFT) {
-            Yaw -= this->MouseSensitivity;
-            this->updateCenterVector(-this->MouseSensitivity, Up);
-        }
-        if (direction == ROLL_RIGHT) {
-            Roll += this->MouseSensitivity;
-            this->updateCenterVectorForRoll(this->MouseSensitivity, Front);
-        }
-        if (direction == ROLL_LEFT) {
-            Roll -= this->MouseSensitivity;
-            this->updateCenterVectorForRoll(-this->MouseSensitivity, Front);
-        }
-
-        this->updateCameraVectors();
-    }
+    void processKeyboard(Camera_Movement direction, float deltaTime);
 
     /** @brief updateCameraSpeed - Updates the Camera Speed based on GUI input.
 	 * @return void
@@ -282,67 +180,23 @@ class Camera {
 	 * 
 	 * @return void
 	*/
-    void reset() {
-        this->Position = glm::vec3(7.0f, 3.0f, 0.0f);
-        this->WorldUp = glm::vec3(0.0f, 1.0f, 0.0f);
-        this->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-        this->Center = glm::vec3(0.0f, 0.0f, 0.0f);
-
-        this->Front = this->Center - this->Position;
-        this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
-        this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
-        this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
-
-        this->MovementSpeed = SPEED;
-        this->MouseSensitivity = SENSITIVITY;
-
-        this->State = NON_PINNED;
-        updateCameraVectors();
-    }
+    void reset();
 
     /**
 	 * @brief Set the Position of the camera.
 	 * 
 	 * @param position 
 	 */
-    void setPosition(const glm::vec3& position) {
-        this->Position = position;
-        this->updateFrontVector();
-    }
+    void setPosition(const glm::vec3& position);
 
    private:
-    void updateFrontVector() {
-        this->Front = this->Center - this->Position;
-        this->distanceFromCenter = glm::distance(this->Position, this->Center);                                            // r = sqrt(x^2 + y^2 + z^2)
-        this->Yaw = glm::atan(this->Front.z, this->Front.x);                                                               // atan(z/x)
-        this->Pitch = glm::atan(this->Front.y, glm::sqrt(glm::pow(this->Front.x, 2.0f) + glm::pow(this->Front.z, 2.0f)));  // atan(y / sqrt(x^2 + z^2))
-    }
+    void updateFrontVector();
 
-    void updateCenterVector(float offsetAngle, glm::vec3 axis) {
-        glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(offsetAngle), axis);
-        Front = glm::vec3(rotation * glm::vec4(Front, 1.0));
+    void updateCenterVector(float offsetAngle, glm::vec3 axis);
 
-        this->Center = this->Position + this->Front;
-        this->distanceFromCenter = glm::distance(this->Front, this->Center);
-    }
-
-    void updateCenterVectorForRoll(float offsetAngle, glm::vec3 axis) {
-        glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(offsetAngle), axis);
-        Right = glm::vec3(rotation * glm::vec4(Right, 1.0));
-        Up = glm::normalize(glm::cross(Right, Front));
-    }
+    void updateCenterVectorForRoll(float offsetAngle, glm::vec3 axis);
 
-    void updateCameraVectors() {
-        // also re-calculate the Right and Up vector
-        Right = glm::normalize(glm::cross(Front, Up));  // normalize the vectors, because their length gets closer to 0 the more you look up or down which results in slower movement.
-        Up = glm::normalize(glm::cross(Right, Front));
-
-        if (this->State == NON_PINNED) {
-            this->viewMatrix = glm::lookAt(Position, Position + Front, Up);
-        } else if (this->State == PINNED) {
-            this->viewMatrix = glm::lookAt(Position, Center, Up);
-        }
-    }
+    void updateCameraVectors();
 };
 
 #ifdef __cplusplus
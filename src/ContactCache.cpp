@@ -0,0 +1,179 @@
+/** @file ContactCache.cpp
+ *  @brief Implementation of the contact cache, see ContactCache.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ContactCache.hpp"
+
+void ContactCache::beginStep() {
+    ++this->step;
+    this->events.clear();
+}
+
+ContactPoint& ContactCache::touch(unsigned one, unsigned two, glm::vec3 normal, float depth) {
+    std::uint64_t key = pairKey(one, two);
+    ContactPoint* found = this->lookup(key);
+    ContactPoint& contact = (found != nullptr) ? *found : *this->insert(key);
+    if (found == nullptr) {
+        contact.normalImpulse = 0.0f;
+        contact.frictionImpulse = glm::vec3(0.0f);
+        this->events.push_back({CONTACT_BEGIN, one, two, normal, depth});
+    }
+    contact.one = one;
+    contact.two = two;
+    contact.normal = normal;
+    contact.depth = depth;
+    contact.step = this->step;
+    return contact;
+}
+
+void ContactCache::endStep(const std::function<bool(const ContactPoint&)>& keep) {
+    std::size_t firstEnd = this->events.size();
+    std::size_t kept = 0;
+    for (ContactPoint* contact : this->contacts) {
+        if (contact->step == this->step) {
+            this->contacts[kept++] = contact;
+        } else if (keep && keep(*contact)) {
+            contact->step = this->step;
+            this->contacts[kept++] = contact;
+        } else {
+            this->events.push_back({CONTACT_END, contact->one, contact->two, contact->normal, contact->depth});
+            this->erase(pairKey(contact->one, contact->two));
+            this->records.destroy(contact);
+        }
+    }
+    this->contacts.resize(kept);
+    // Contacts are kept in no fixed order, sort so that the events are the same from run to run.
+    std::sort(this->events.begin() + firstEnd, this->events.end(), [](const ContactEvent& a, const ContactEvent& b) {
+        return pairKey(a.one, a.two) < pairKey(b.one, b.two);
+    });
+}
+
+void ContactCache::clear() {
+    for (ContactPoint* contact : this->contacts) {
+        this->records.destroy(contact);
+    }
+    this->contacts.clear();
+    std::fill(this->table.begin(), this->table.end(), Entry());
+    this->events.clear();
+}
+
+void ContactCache::remapIds(const std::vector<int>& newIds, std::vector<unsigned>& orphaned) {
+    std::size_t kept = 0;
+    for (ContactPoint* contact : this->contacts) {
+        int one = (contact->one < newIds.size()) ? newIds[contact->one] : -1;
+        int two = (contact->two < newIds.size()) ? newIds[contact->two] : -1;
+        if (one < 0 || two < 0) {
+            if (one >= 0) {
+                orphaned.push_back(one);
+            }
+            if (two >= 0) {
+                orphaned.push_back(two);
+            }
+            this->records.destroy(contact);
+            continue;
+        }
+        contact->one = one;
+        contact->two = two;
+        this->contacts[kept++] = contact;
+    }
+    this->contacts.resize(kept);
+
+    std::fill(this->table.begin(), this->table.end(), Entry());
+    for (ContactPoint* contact : this->contacts) {
+        std::uint64_t key = pairKey(contact->one, contact->two);
+        Entry& entry = this->table[this->probe(key)];
+        entry.key = key;
+        entry.contact = contact;
+    }
+}
+
+void ContactCache::capture(std::vector<std::uint32_t>& words) const {
+    std::vector<const ContactPoint*> sorted(this->contacts.begin(), this->contacts.end());
+    std::sort(sorted.begin(), sorted.end(), [](const ContactPoint* a, const ContactPoint* b) {
+        return pairKey(a->one, a->two) < pairKey(b->one, b->two);
+    });
+
+    words.push_back(sorted.size());
+    for (const ContactPoint* contact : sorted) {
+        const float values[8] = {contact->normal.x, contact->normal.y, contact->normal.z, contact->depth,
+                                 contact->normalImpulse, contact->frictionImpulse.x, contact->frictionImpulse.y, contact->frictionImpulse.z};
+        words.push_back(contact->one);
+        words.push_back(contact->two);
+        for (float value : values) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            words.push_back(bits);
+        }
+    }
+}
+
+void ContactCache::restore(const std::vector<std::uint32_t>& words, std::size_t& i) {
+    this->clear();
+    std::uint32_t count = words[i++];
+    for (std::uint32_t c = 0; c < count; ++c) {
+        float values[8];
+        std::memcpy(values, &words[i + 2], sizeof(values));
+        ContactPoint& contact = *this->insert(pairKey(words[i], words[i + 1]));
+        contact.one = words[i];
+        contact.two = words[i + 1];
+        contact.normal = glm::vec3(values[0], values[1], values[2]);
+        contact.depth = values[3];
+        contact.normalImpulse = values[4];
+        contact.frictionImpulse = glm::vec3(values[5], values[6], values[7]);
+        contact.step = this->step;
+        i += 10;
+    }
+}
+
+std::uint64_t ContactCache::pairKey(unsigned one, unsigned two) {
+    std::uint64_t a = std::min(one, two), b = std::max(one, two);
+    return (a << 32) | b;
+}
+
+std::size_t ContactCache::probe(std::uint64_t key) const {
+    std::size_t mask = this->table.size() - 1;
+    std::size_t slot = this->home(key);
+    while (this->table[slot].contact != nullptr && this->table[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+ContactPoint* ContactCache::insert(std::uint64_t key) {
+    if (2 * (this->contacts.size() + 1) > this->table.size()) {
+        std::vector<Entry> old(std::max<std::size_t>(64, 2 * this->table.size()));
+        old.swap(this->table);
+        for (const Entry& entry : old) {
+            if (entry.contact != nullptr) {
+                this->table[this->probe(entry.key)] = entry;
+            }
+        }
+    }
+    ContactPoint* contact = this->records.create();
+    Entry& entry = this->table[this->probe(key)];
+    entry.key = key;
+    entry.contact = contact;
+    this->contacts.push_back(contact);
+    return contact;
+}
+
+void ContactCache::erase(std::uint64_t key) {
+    std::size_t mask = this->table.size() - 1;
+    std::size_t hole = this->probe(key);
+    this->table[hole] = Entry();
+    for (std::size_t slot = (hole + 1) & mask; this->table[slot].contact != nullptr; slot = (slot + 1) & mask) {
+        std::size_t wanted = this->home(this->table[slot].key);
+        // The entry may move into the hole unless its home lies cyclically in (hole, slot].
+        bool between = (hole < slot) ? (hole < wanted && wanted <= slot) : (hole < wanted || wanted <= slot);
+        if (!between) {
+            this->table[hole] = this->table[slot];
+            this->table[slot] = Entry();
+            hole = slot;
+        }
+    }
+}
@@ -0,0 +1,218 @@
+/** @file ContactCache.hpp
+ *  @brief Class definition for the contacts of a simulation kept across steps.
+ *
+ *  @details Contacts are keyed by the pair of body ids, so a contact found again in the next
+ *  step keeps its accumulated impulses for warm starting. Contacts that appear or disappear
+ *  during a step are reported as events once the step ends. The contacts live in a Pool and are
+ *  found through an open addressing table, so once the cache has held as many contacts as it
+ *  ever will, a step no longer takes memory from the heap.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef CONTACT_CACHE_H
+#define CONTACT_CACHE_H
+
+#include <glm/glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Arena.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct ContactPoint
+ * @brief A contact between two bodies as it was last seen.
+ */
+typedef struct ContactPoint {
+    //! Id of the first body.
+    unsigned one;
+    //! Id of the second body.
+    unsigned two;
+    //! Unit normal pointing from the second body to the first.
+    glm::vec3 normal;
+    //! Penetration depth, negative while the bodies are still apart.
+    float depth;
+    //! Accumulated normal impulse.
+    float normalImpulse;
+    //! Accumulated friction impulse, tangent to the contact.
+    glm::vec3 frictionImpulse;
+    //! Step the contact was last seen in.
+    std::uint64_t step;
+} ContactPoint;
+
+/**
+ * @enum ContactEventType
+ * @brief Whether a contact appeared or disappeared.
+ *
+ */
+enum ContactEventType {
+    CONTACT_BEGIN,
+    CONTACT_END,
+};
+
+/**
+ * @struct ContactEvent
+ * @brief A contact that appeared or disappeared during the last step.
+ */
+typedef struct ContactEvent {
+    ContactEventType type;
+    //! Id of the first body.
+    unsigned one;
+    //! Id of the second body.
+    unsigned two;
+    //! Normal of the contact when it was last seen.
+    glm::vec3 normal;
+    //! Penetration depth of the contact when it was last seen.
+    float depth;
+} ContactEvent;
+
+/** @class ContactCache
+ *  @brief Contacts of a simulation kept across steps, keyed by body pair.
+ *  @details Call beginStep() before the contacts of a step are found, touch() for every contact
+ *  found, and endStep() once the step is done. References returned by touch() stay valid until the
+ *  contact is dropped.
+ */
+class ContactCache {
+   public:
+    /**
+	 * @brief Start collecting the contacts of a new step.
+	 */
+    void beginStep();
+
+    /**
+	 * @brief Record a contact found in the current step.
+	 * @details A contact seen in the previous step keeps its impulses, a new one starts from zero
+	 * and is reported as a CONTACT_BEGIN event.
+	 *
+	 * @param one Id of the first body.
+	 * @param two Id of the second body.
+	 * @param normal Unit normal pointing from the second body to the first.
+	 * @param depth Penetration depth.
+	 * @return ContactPoint&
+	 */
+    ContactPoint& touch(unsigned one, unsigned two, glm::vec3 normal, float depth);
+
+    /**
+	 * @brief Find the contact of a body pair.
+	 *
+	 * @param one
+	 * @param two
+	 * @return const ContactPoint* nullptr when the bodies are not in contact.
+	 */
+    const ContactPoint* find(unsigned one, unsigned two) const {
+        return this->lookup(pairKey(one, two));
+    }
+
+    /**
+	 * @brief Drop the contacts not seen in the current step and report them as CONTACT_END events.
+	 *
+	 * @param keep Optional test for contacts to keep although they were not seen, e.g. between sleeping bodies.
+	 */
+    void endStep(const std::function<bool(const ContactPoint&)>& keep = nullptr);
+
+    /**
+	 * @brief Get the contacts that appeared or disappeared during the last step.
+	 *
+	 * @return const std::vector<ContactEvent>&
+	 */
+    const std::vector<ContactEvent>& getEvents() const {
+        return this->events;
+    }
+
+    /**
+	 * @brief Get the number of contacts.
+	 *
+	 * @return std::size_t
+	 */
+    std::size_t size() const {
+        return this->contacts.size();
+    }
+
+    /**
+	 * @brief Drop all contacts without reporting them.
+	 */
+    void clear();
+
+    /**
+	 * @brief Give the bodies new ids after bodies were added to or removed from the simulation.
+	 * @details Contacts with a removed body are dropped without an event.
+	 *
+	 * @param newIds New id of every old id, -1 for removed bodies.
+	 * @param orphaned Appended with the new ids of the bodies that lost a contact to a removed body.
+	 */
+    void remapIds(const std::vector<int>& newIds, std::vector<unsigned>& orphaned);
+
+    /**
+	 * @brief Append all contacts as 32 bit words, sorted by body pair.
+	 *
+	 * @param words
+	 */
+    void capture(std::vector<std::uint32_t>& words) const;
+
+    /**
+	 * @brief Replace the contacts with the ones written by capture(), starting at words[i].
+	 *
+	 * @param words
+	 * @param i Advanced past the words read.
+	 */
+    void restore(const std::vector<std::uint32_t>& words, std::size_t& i);
+
+    /**
+	 * @brief Key of a body pair, the same whichever order the ids are given in.
+	 */
+    static std::uint64_t pairKey(unsigned one, unsigned two);
+
+   private:
+    /**
+	 * @struct Entry
+	 * @brief A slot of the table, empty while contact is nullptr.
+	 */
+    struct Entry {
+        std::uint64_t key = 0;
+        ContactPoint* contact = nullptr;
+    };
+
+    //! Storage of the contacts.
+    Pool<ContactPoint> records;
+    //! All contacts, in no particular order.
+    std::vector<ContactPoint*> contacts;
+    //! Open addressing table from body pair to contact, with linear probing. The size is 0 or a power of two.
+    std::vector<Entry> table;
+    //! Events of the last step.
+    std::vector<ContactEvent> events;
+    //! Number of steps begun so far.
+    std::uint64_t step = 0;
+
+    std::size_t home(std::uint64_t key) const {
+        return ((key * 0x9E3779B97F4A7C15ull) >> 32) & (this->table.size() - 1);
+    }
+
+    /**
+	 * @brief Slot holding key, or the empty slot it would go into.
+	 */
+    std::size_t probe(std::uint64_t key) const;
+
+    ContactPoint* lookup(std::uint64_t key) const {
+        return this->table.empty() ? nullptr : this->table[this->probe(key)].contact;
+    }
+
+    /**
+	 * @brief Add a contact that is not in the table yet, growing the table to keep it at most half full.
+	 */
+    ContactPoint* insert(std::uint64_t key);
+
+    /**
+	 * @brief Remove a key from the table, moving the entries probed past it back so none is cut off.
+	 */
+    void erase(std::uint64_t key);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
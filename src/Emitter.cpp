@@ -0,0 +1,120 @@
+/** @file Emitter.cpp
+ *  @brief Implementation of the sphere emitter, see Emitter.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#include "Emitter.hpp"
+
+SphereEmitter::SphereEmitter(Physx* physx, const EmitterSettings& settings, unsigned seed, MeshResidency residency, Scene* scene) : random(seed) {
+    this->physx = physx;
+    this->scene = scene;
+    this->settings = settings;
+    this->prototypes.reserve(NUM_PROTOTYPES);
+    for (int p = 0; p < NUM_PROTOTYPES; ++p) {
+        float t = (NUM_PROTOTYPES > 1) ? (float)p / (NUM_PROTOTYPES - 1) : 0.0f;
+        this->prototypes.emplace_back(settings.minRadius + t * (settings.maxRadius - settings.minRadius), 16u, residency);
+    }
+    this->particles.reserve(settings.maxAlive);
+    this->pending = 0.0f;
+    this->spawnedCount = this->removedCount = 0;
+}
+
+void SphereEmitter::update(float dt) {
+    for (std::size_t i = 0; i < this->particles.size();) {
+        Particle& particle = this->particles[i];
+        particle.age += dt;
+        const glm::vec3& x = particle.model->worldPosition;
+        bool outside = false;
+        for (int j = 0; j < 3; ++j) {
+            outside = outside || x[j] < this->settings.boundsMin[j] || x[j] > this->settings.boundsMax[j];
+        }
+        if (outside || (this->settings.lifetime > 0.0f && particle.age > this->settings.lifetime)) {
+            this->remove(i);
+        } else {
+            ++i;
+        }
+    }
+
+    this->pending += this->settings.rate * dt;
+    while (this->pending >= 1.0f && (int)this->particles.size() < this->settings.maxAlive) {
+        this->spawn();
+        this->pending -= 1.0f;
+    }
+    if ((int)this->particles.size() >= this->settings.maxAlive) {
+        // Do not spawn a burst once room frees up.
+        this->pending = 0.0f;
+    }
+}
+
+void SphereEmitter::step(float dt) {
+    this->update(dt);
+    auto start = std::chrono::steady_clock::now();
+    this->physx->step(dt);
+    this->recordStep(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+
+void SphereEmitter::clear() {
+    while (!this->particles.empty()) {
+        this->remove(this->particles.size() - 1);
+    }
+    this->pending = 0.0f;
+}
+
+bool SphereEmitter::writeCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        std::cout << "EMITTER::ERROR::Could not open " << path << " for writing." << std::endl;
+        return false;
+    }
+    std::fprintf(file, "step,alive,step_ms\n");
+    for (std::size_t s = 0; s < this->samples.size(); ++s) {
+        std::fprintf(file, "%zu,%d,%.4f\n", s, this->samples[s].alive, this->samples[s].stepMilliseconds);
+    }
+    std::fclose(file);
+    return true;
+}
+
+void SphereEmitter::spawn() {
+    int prototype = this->random() % NUM_PROTOTYPES;
+    Sphere* model;
+    if (!this->idle[prototype].empty()) {
+        model = this->idle[prototype].back();
+        this->idle[prototype].pop_back();
+    } else {
+        model = this->models.create(this->prototypes[prototype]);
+    }
+
+    const EmitterSettings& s = this->settings;
+    model->_translation[0] = s.origin.x + (this->uniform() - 0.5f) * 2.0f * s.spread;
+    model->_translation[1] = s.origin.y;
+    model->_translation[2] = s.origin.z + (this->uniform() - 0.5f) * 2.0f * s.spread;
+    model->updateTransforms();
+    model->meshes[0].material.setDiffuseColor(glm::vec3(this->uniform(), this->uniform(), this->uniform()));
+
+    float mass = ((this->uniform() + 1.0f) * 10.0f) * glm::pow(model->radius, 3);
+    glm::vec3 velocity((this->uniform() - 0.5f) * 2.0f * s.speed, (this->uniform() - 0.5f) * 2.0f * s.speed, (this->uniform() - 0.5f) * 2.0f * s.speed);
+    BodyHandle body = this->physx->createBody(SPHERE, model, mass, velocity);
+    this->physx->getBody(body)->enableGravity();
+    if (this->scene != nullptr) {
+        this->scene->addModel(model);
+    }
+    this->particles.push_back({body, model, prototype, 0.0f});
+    ++this->spawnedCount;
+}
+
+void SphereEmitter::remove(std::size_t i) {
+    Particle& particle = this->particles[i];
+    this->physx->removeBody(particle.body);
+    if (this->scene != nullptr) {
+        this->scene->removeModel(particle.model);
+    }
+    this->idle[particle.prototype].push_back(particle.model);
+    particle = this->particles.back();
+    this->particles.pop_back();
+    ++this->removedCount;
+}
@@ -0,0 +1,199 @@
+/** @file Emitter.hpp
+ *  @brief Class definition for an emitter that keeps pouring spheres into a collision scene.
+ *
+ *  @details Spheres are spawned at a fixed rate over a square above the scene and removed once
+ *  they leave a box or outlive their lifetime, so the number of live bodies climbs until spawning
+ *  and removal balance out. The sphere meshes are generated once, for a few radii: spawned models
+ *  are copies of these prototypes, sharing their vertex buffers. Models are kept in a Pool and
+ *  reused when their sphere is removed, and bodies live in the slot map of the simulation, so
+ *  once the number of live spheres has peaked spawning and removing them no longer touches the
+ *  heap. Every step records its time against the number of live bodies, which makes the emitter
+ *  the scalability test of the collision engine.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <glm/glm/glm.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Model.hpp"
+#include "Physics.hpp"
+#include "Scene.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct EmitterSettings
+ * @brief Where, how fast and for how long an emitter spawns spheres.
+ */
+typedef struct EmitterSettings {
+    //! Spheres spawned per second.
+    float rate = 200.0f;
+    //! Seconds a sphere lives. 0 keeps spheres until they leave the bounds.
+    float lifetime = 20.0f;
+    //! Largest number of spheres alive at once. Spawning pauses while it is reached.
+    int maxAlive = 10000;
+    //! Centre of the square spheres are spawned over, and half its size.
+    glm::vec3 origin = glm::vec3(0.0f, 40.0f, 0.0f);
+    float spread = 20.0f;
+    //! Largest component of the random initial velocity.
+    float speed = 5.0f;
+    //! Smallest and largest radius of the spheres.
+    float minRadius = 0.5f;
+    float maxRadius = 1.5f;
+    //! Spheres that leave this box are removed.
+    glm::vec3 boundsMin = glm::vec3(-50.0f, -20.0f, -50.0f);
+    glm::vec3 boundsMax = glm::vec3(50.0f, 100.0f, 50.0f);
+} EmitterSettings;
+
+/**
+ * @struct EmitterSample
+ * @brief Time of one step of the simulation and the number of spheres it simulated.
+ */
+typedef struct EmitterSample {
+    int alive;
+    double stepMilliseconds;
+} EmitterSample;
+
+/** @class SphereEmitter
+ *  @brief Spawns spheres into a simulation, and optionally a scene, and removes them again.
+ *  @details The simulation and the scene must outlive the emitter, which removes its spheres
+ *  from both when destroyed.
+ */
+class SphereEmitter {
+   public:
+    //! Number of radii meshes are generated for.
+    static const int NUM_PROTOTYPES = 4;
+
+    EmitterSettings settings;
+
+    /**
+	 * @brief Construct a new SphereEmitter
+	 *
+	 * @param physx The simulation the spheres are added to.
+	 * @param settings
+	 * @param seed Seed of the positions, sizes, colours and velocities of the spheres.
+	 * @param residency COUNT_ONLY for headless runs.
+	 * @param scene Scene the models are added to for rendering, or nullptr.
+	 */
+    SphereEmitter(Physx* physx, const EmitterSettings& settings = EmitterSettings(), unsigned seed = 1, MeshResidency residency = GPU_ONLY, Scene* scene = nullptr);
+
+    SphereEmitter(const SphereEmitter&) = delete;
+    SphereEmitter& operator=(const SphereEmitter&) = delete;
+
+    ~SphereEmitter() {
+        this->clear();
+    }
+
+    /**
+	 * @brief Remove the spheres that left the bounds or outlived their lifetime, then spawn the spheres due in dt.
+	 * @details Call before stepping the simulation.
+	 *
+	 * @param dt
+	 */
+    void update(float dt);
+
+    /**
+	 * @brief Update the emitter, step the simulation and record the time of the step.
+	 *
+	 * @param dt
+	 */
+    void step(float dt);
+
+    /**
+	 * @brief Record the time of a step taken elsewhere, against the current number of spheres.
+	 *
+	 * @param milliseconds
+	 */
+    void recordStep(double milliseconds) {
+        this->samples.push_back({(int)this->particles.size(), milliseconds});
+    }
+
+    /**
+	 * @brief Remove every sphere of the emitter. The recorded samples are kept.
+	 */
+    void clear();
+
+    /**
+	 * @brief Get the number of spheres alive.
+	 *
+	 * @return int
+	 */
+    int getAliveCount() const {
+        return this->particles.size();
+    }
+
+    std::uint64_t getSpawnedCount() const {
+        return this->spawnedCount;
+    }
+
+    std::uint64_t getRemovedCount() const {
+        return this->removedCount;
+    }
+
+    /**
+	 * @brief Get the recorded steps, oldest first.
+	 *
+	 * @return const std::vector<EmitterSample>&
+	 */
+    const std::vector<EmitterSample>& getSamples() const {
+        return this->samples;
+    }
+
+    /**
+	 * @brief Write the recorded steps as CSV, one row per step.
+	 *
+	 * @param path
+	 * @return true If the file was written.
+	 */
+    bool writeCSV(const std::string& path) const;
+
+   private:
+    struct Particle {
+        BodyHandle body;
+        Sphere* model;
+        int prototype;
+        float age;
+    };
+
+    Physx* physx;
+    Scene* scene;
+    std::minstd_rand random;
+
+    //! Spheres the spawned models are copied from.
+    std::vector<Sphere> prototypes;
+    //! Every model the emitter created, alive or idle.
+    Pool<Sphere> models;
+    //! Models of removed spheres, per prototype, waiting to be spawned again.
+    std::vector<Sphere*> idle[NUM_PROTOTYPES];
+    std::vector<Particle> particles;
+
+    //! Spheres due but not yet spawned.
+    float pending;
+    std::uint64_t spawnedCount;
+    std::uint64_t removedCount;
+    std::vector<EmitterSample> samples;
+
+    float uniform() {
+        return (1.0f * (this->random() - std::minstd_rand::min())) / (std::minstd_rand::max() - std::minstd_rand::min());
+    }
+
+    void spawn();
+
+    void remove(std::size_t i);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,399 @@
+/** @file FMM.cpp
+ *  @brief Implementation of the Fast Multipole Method simulation, see FMM.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "FMM.hpp"
+
+FMMPhysx::FMMPhysx(int order, float theta, int leafSize, float softening) {
+    this->order = order;
+    this->theta = theta;
+    this->leafSize = leafSize;
+    this->softening = softening;
+}
+
+void FMMPhysx::computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations) {
+    this->masses.resize(this->objects.size());
+    for (std::size_t i = 0; i < this->objects.size(); ++i) {
+        this->masses[i] = this->objects[i]->mass;
+    }
+    this->evaluate(positions, this->masses, accelerations);
+}
+
+void FMMPhysx::evaluate(const std::vector<glm::vec3>& positions, const std::vector<float>& masses, std::vector<glm::vec3>& accelerations) {
+    int numBodies = positions.size();
+    accelerations.assign(numBodies, glm::vec3(0.0f));
+    if (numBodies == 0) {
+        return;
+    }
+    if (this->tableOrder != this->order) {
+        this->buildTables();
+    }
+
+    this->buildTree(positions, masses);
+    this->upwardPass();
+    this->m2lCount = 0;
+    this->p2pCount = 0;
+    this->interact(0, 0);
+    this->downwardPass();
+
+    for (int s = 0; s < numBodies; ++s) {
+        accelerations[this->index[s]] = glm::vec3(this->ax[s], this->ay[s], this->az[s]);
+    }
+}
+
+void FMMPhysx::step(float dt) {
+    this->updateObjects();
+    this->integrate(dt);
+    for (PhysxObject* p : this->objects) {
+        p->model->_translation[0] = p->model->worldPosition.x;
+        p->model->_translation[1] = p->model->worldPosition.y;
+        p->model->_translation[2] = p->model->worldPosition.z;
+        p->model->updateTransforms();
+    }
+}
+
+double FMMPhysx::binomial(int n, int k) {
+    double b = 1.0;
+    for (int i = 1; i <= k; ++i) {
+        b = b * (n - k + i) / i;
+    }
+    return b;
+}
+
+void FMMPhysx::buildTables() {
+    int p = std::min(std::max(1, this->order), FMM_MAX_ORDER);
+    this->order = p;
+    this->exponents.clear();
+    this->coefficientOf.assign((p + 1) * (p + 1) * (p + 1), -1);
+    for (int degree = 0; degree <= p; ++degree) {
+        for (int i = degree; i >= 0; --i) {
+            for (int j = degree - i; j >= 0; --j) {
+                int k = degree - i - j;
+                this->coefficientOf[(i * (p + 1) + j) * (p + 1) + k] = this->exponents.size() / 3;
+                this->exponents.insert(this->exponents.end(), {i, j, k});
+            }
+        }
+    }
+    this->numCoefficients = this->exponents.size() / 3;
+
+    this->previous.assign(3 * this->numCoefficients, -1);
+    this->previous2.assign(3 * this->numCoefficients, -1);
+    this->gradient.assign(3 * this->numCoefficients, -1);
+    this->shiftTerms.clear();
+    this->m2lTerms.clear();
+    for (int c = 0; c < this->numCoefficients; ++c) {
+        const int* n = &this->exponents[3 * c];
+        for (int axis = 0; axis < 3; ++axis) {
+            int e[3] = {n[0], n[1], n[2]};
+            e[axis] -= 1;
+            if (e[axis] >= 0) {
+                this->previous[3 * c + axis] = this->coefficient(e[0], e[1], e[2]);
+            }
+            e[axis] -= 1;
+            if (e[axis] >= 0) {
+                this->previous2[3 * c + axis] = this->coefficient(e[0], e[1], e[2]);
+            }
+            e[axis] += 3;
+            if (n[0] + n[1] + n[2] < p) {
+                this->gradient[3 * c + axis] = this->coefficient(e[0], e[1], e[2]);
+            }
+        }
+
+        for (int q = 0; q < this->numCoefficients; ++q) {
+            const int* k = &this->exponents[3 * q];
+            if (k[0] <= n[0] && k[1] <= n[1] && k[2] <= n[2]) {
+                double b = binomial(n[0], k[0]) * binomial(n[1], k[1]) * binomial(n[2], k[2]);
+                this->shiftTerms.push_back({c, q, this->coefficient(n[0] - k[0], n[1] - k[1], n[2] - k[2]), b});
+            }
+            if (n[0] + n[1] + n[2] + k[0] + k[1] + k[2] <= p) {
+                double b = binomial(n[0] + k[0], n[0]) * binomial(n[1] + k[1], n[1]) * binomial(n[2] + k[2], n[2]);
+                this->m2lTerms.push_back({c, this->coefficient(n[0] + k[0], n[1] + k[1], n[2] + k[2]), q, b});
+            }
+        }
+    }
+    this->tableOrder = p;
+}
+
+void FMMPhysx::monomials(const double d[3], double* out) const {
+    double powers[3][FMM_MAX_ORDER + 1];
+    for (int axis = 0; axis < 3; ++axis) {
+        powers[axis][0] = 1.0;
+        for (int e = 1; e <= this->order; ++e) {
+            powers[axis][e] = powers[axis][e - 1] * d[axis];
+        }
+    }
+    for (int c = 0; c < this->numCoefficients; ++c) {
+        const int* n = &this->exponents[3 * c];
+        out[c] = powers[0][n[0]] * powers[1][n[1]] * powers[2][n[2]];
+    }
+}
+
+void FMMPhysx::derivatives(const double r[3], double* out) const {
+    double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+    out[0] = 1.0 / std::sqrt(r2);
+    for (int c = 1; c < this->numCoefficients; ++c) {
+        const int* n = &this->exponents[3 * c];
+        int degree = n[0] + n[1] + n[2];
+        double first = 0.0, second = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (this->previous[3 * c + axis] >= 0) {
+                first += r[axis] * out[this->previous[3 * c + axis]];
+            }
+            if (this->previous2[3 * c + axis] >= 0) {
+                second += out[this->previous2[3 * c + axis]];
+            }
+        }
+        out[c] = -((2 * degree - 1) * first + (degree - 1) * second) / (degree * r2);
+    }
+}
+
+void FMMPhysx::buildTree(const std::vector<glm::vec3>& positions, const std::vector<float>& masses) {
+    int numBodies = positions.size();
+    this->index.resize(numBodies);
+    this->scratch.resize(numBodies);
+    glm::vec3 lower = positions[0], upper = positions[0];
+    for (int i = 0; i < numBodies; ++i) {
+        this->index[i] = i;
+        lower = glm::min(lower, positions[i]);
+        upper = glm::max(upper, positions[i]);
+    }
+    glm::vec3 middle = (lower + upper) * 0.5f;
+    float half = std::max(std::max(upper.x - lower.x, upper.y - lower.y), upper.z - lower.z) * 0.5f;
+
+    this->cells.clear();
+    this->cells.push_back(Cell());
+    this->buildCell(0, 0, numBodies, middle, half, 0, positions, masses);
+
+    this->x.resize(numBodies);
+    this->y.resize(numBodies);
+    this->z.resize(numBodies);
+    this->m.resize(numBodies);
+    for (int s = 0; s < numBodies; ++s) {
+        this->x[s] = positions[this->index[s]].x;
+        this->y[s] = positions[this->index[s]].y;
+        this->z[s] = positions[this->index[s]].z;
+        this->m[s] = masses[this->index[s]];
+    }
+    this->ax.assign(numBodies, 0.0f);
+    this->ay.assign(numBodies, 0.0f);
+    this->az.assign(numBodies, 0.0f);
+}
+
+void FMMPhysx::buildCell(int c, int begin, int end, glm::vec3 middle, float half, int depth, const std::vector<glm::vec3>& positions, const std::vector<float>& masses) {
+    double mass = 0.0, center[3] = {0.0, 0.0, 0.0};
+    for (int s = begin; s < end; ++s) {
+        const glm::vec3& p = positions[this->index[s]];
+        mass += masses[this->index[s]];
+        center[0] += (double)masses[this->index[s]] * p.x;
+        center[1] += (double)masses[this->index[s]] * p.y;
+        center[2] += (double)masses[this->index[s]] * p.z;
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        center[axis] = (mass > 0.0) ? center[axis] / mass : middle[axis];
+    }
+    double radius2 = 0.0;
+    for (int s = begin; s < end; ++s) {
+        const glm::vec3& p = positions[this->index[s]];
+        double dx = p.x - center[0], dy = p.y - center[1], dz = p.z - center[2];
+        radius2 = std::max(radius2, dx * dx + dy * dy + dz * dz);
+    }
+
+    Cell& cell = this->cells[c];
+    cell.center[0] = center[0];
+    cell.center[1] = center[1];
+    cell.center[2] = center[2];
+    cell.radius = std::sqrt(radius2);
+    cell.begin = begin;
+    cell.end = end;
+    cell.firstChild = 0;
+    cell.numChildren = 0;
+    if (end - begin <= this->leafSize || depth >= FMM_MAX_DEPTH) {
+        return;
+    }
+
+    // Counting sort of the bodies into the octants.
+    int counts[9] = {0};
+    for (int s = begin; s < end; ++s) {
+        ++counts[this->octant(positions[this->index[s]], middle) + 1];
+    }
+    for (int o = 0; o < 8; ++o) {
+        counts[o + 1] += counts[o];
+    }
+    int starts[9];
+    std::copy(counts, counts + 9, starts);
+    for (int s = begin; s < end; ++s) {
+        this->scratch[begin + starts[this->octant(positions[this->index[s]], middle)]++] = this->index[s];
+    }
+    std::copy(this->scratch.begin() + begin, this->scratch.begin() + end, this->index.begin() + begin);
+
+    int numChildren = 0;
+    for (int o = 0; o < 8; ++o) {
+        numChildren += (counts[o + 1] > counts[o]) ? 1 : 0;
+    }
+    int firstChild = this->cells.size();
+    this->cells[c].firstChild = firstChild;
+    this->cells[c].numChildren = numChildren;
+    this->cells.resize(firstChild + numChildren);
+
+    int child = firstChild;
+    for (int o = 0; o < 8; ++o) {
+        if (counts[o + 1] == counts[o]) {
+            continue;
+        }
+        glm::vec3 offset((o & 1) ? 0.5f : -0.5f, (o & 2) ? 0.5f : -0.5f, (o & 4) ? 0.5f : -0.5f);
+        this->buildCell(child++, begin + counts[o], begin + counts[o + 1], middle + offset * half, half * 0.5f, depth + 1, positions, masses);
+    }
+}
+
+void FMMPhysx::upwardPass() {
+    int nc = this->numCoefficients;
+    // Sized for every cell the tree has room for, so that trees growing as the bodies move do not reallocate.
+    this->multipoles.reserve(this->cells.capacity() * nc);
+    this->locals.reserve(this->cells.capacity() * nc);
+    this->multipoles.assign(this->cells.size() * nc, 0.0);
+    this->powers.resize(nc);
+    double* powers = this->powers.data();
+    for (int c = this->cells.size() - 1; c >= 0; --c) {
+        const Cell& cell = this->cells[c];
+        double* multipole = &this->multipoles[c * nc];
+        if (cell.numChildren == 0) {
+            for (int s = cell.begin; s < cell.end; ++s) {
+                double d[3] = {cell.center[0] - this->x[s], cell.center[1] - this->y[s], cell.center[2] - this->z[s]};
+                this->monomials(d, powers);
+                for (int k = 0; k < nc; ++k) {
+                    multipole[k] += this->m[s] * powers[k];
+                }
+            }
+            continue;
+        }
+        for (int child = cell.firstChild; child < cell.firstChild + cell.numChildren; ++child) {
+            const double* childMultipole = &this->multipoles[child * nc];
+            double t[3] = {cell.center[0] - this->cells[child].center[0], cell.center[1] - this->cells[child].center[1], cell.center[2] - this->cells[child].center[2]};
+            this->monomials(t, powers);
+            for (const ShiftTerm& term : this->shiftTerms) {
+                multipole[term.to] += term.coefficient * powers[term.with] * childMultipole[term.from];
+            }
+        }
+    }
+    this->locals.assign(this->cells.size() * nc, 0.0);
+}
+
+void FMMPhysx::interact(int a, int b) {
+    const Cell& target = this->cells[a];
+    const Cell& source = this->cells[b];
+    if (a == b) {
+        if (target.numChildren == 0) {
+            this->p2p(target, source);
+            return;
+        }
+        for (int i = target.firstChild; i < target.firstChild + target.numChildren; ++i) {
+            for (int j = target.firstChild; j < target.firstChild + target.numChildren; ++j) {
+                this->interact(i, j);
+            }
+        }
+        return;
+    }
+
+    double r[3] = {target.center[0] - source.center[0], target.center[1] - source.center[1], target.center[2] - source.center[2]};
+    double distance = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    if (target.radius + source.radius < this->theta * distance) {
+        // Few bodies are cheaper to sum directly than to translate.
+        if ((double)(target.end - target.begin) * (source.end - source.begin) < this->m2lTerms.size()) {
+            this->p2p(target, source);
+        } else {
+            this->m2l(a, b, r);
+        }
+        return;
+    }
+    if (target.numChildren == 0 && source.numChildren == 0) {
+        this->p2p(target, source);
+        return;
+    }
+    if (source.numChildren == 0 || (target.numChildren != 0 && target.radius >= source.radius)) {
+        for (int i = target.firstChild; i < target.firstChild + target.numChildren; ++i) {
+            this->interact(i, b);
+        }
+    } else {
+        for (int j = source.firstChild; j < source.firstChild + source.numChildren; ++j) {
+            this->interact(a, j);
+        }
+    }
+}
+
+void FMMPhysx::m2l(int a, int b, const double r[3]) {
+    // (FMM_MAX_ORDER + 1)(FMM_MAX_ORDER + 2)(FMM_MAX_ORDER + 3) / 6 coefficients at most.
+    double coefficients[969];
+    this->derivatives(r, coefficients);
+    double* local = &this->locals[a * this->numCoefficients];
+    const double* multipole = &this->multipoles[b * this->numCoefficients];
+    for (const ShiftTerm& term : this->m2lTerms) {
+        local[term.to] += term.coefficient * coefficients[term.from] * multipole[term.with];
+    }
+    ++this->m2lCount;
+}
+
+void FMMPhysx::p2p(const Cell& target, const Cell& source) {
+    float softening2 = this->softening * this->softening;
+    for (int i = target.begin; i < target.end; i += NBODY_TILE) {
+        float tx[NBODY_TILE], ty[NBODY_TILE], tz[NBODY_TILE], sx[NBODY_TILE] = {0.0f}, sy[NBODY_TILE] = {0.0f}, sz[NBODY_TILE] = {0.0f};
+        int count = std::min(NBODY_TILE, target.end - i);
+        for (int t = 0; t < NBODY_TILE; ++t) {
+            int s = i + std::min(t, count - 1);
+            tx[t] = this->x[s], ty[t] = this->y[s], tz[t] = this->z[s];
+        }
+        if (this->deterministic) {
+            NBodyPhysx::accelerationTileExact(tx, ty, tz, this->x.data(), this->y.data(), this->z.data(), this->m.data(), source.begin, source.end, softening2, sx, sy, sz);
+        } else {
+            NBodyPhysx::accelerationTile(tx, ty, tz, this->x.data(), this->y.data(), this->z.data(), this->m.data(), source.begin, source.end, softening2, sx, sy, sz);
+        }
+        for (int t = 0; t < count; ++t) {
+            this->ax[i + t] += sx[t];
+            this->ay[i + t] += sy[t];
+            this->az[i + t] += sz[t];
+        }
+    }
+    this->p2pCount += (long long)(target.end - target.begin) * (source.end - source.begin);
+}
+
+void FMMPhysx::downwardPass() {
+    int nc = this->numCoefficients;
+    this->powers.resize(nc);
+    double* powers = this->powers.data();
+    for (std::size_t c = 0; c < this->cells.size(); ++c) {
+        const Cell& cell = this->cells[c];
+        const double* local = &this->locals[c * nc];
+        if (cell.numChildren == 0) {
+            for (int s = cell.begin; s < cell.end; ++s) {
+                double e[3] = {this->x[s] - cell.center[0], this->y[s] - cell.center[1], this->z[s] - cell.center[2]};
+                this->monomials(e, powers);
+                double g[3] = {0.0, 0.0, 0.0};
+                for (int n = 0; n < nc; ++n) {
+                    const int* exponent = &this->exponents[3 * n];
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (this->gradient[3 * n + axis] >= 0) {
+                            g[axis] += (exponent[axis] + 1) * local[this->gradient[3 * n + axis]] * powers[n];
+                        }
+                    }
+                }
+                this->ax[s] += g[0];
+                this->ay[s] += g[1];
+                this->az[s] += g[2];
+            }
+            continue;
+        }
+        for (int child = cell.firstChild; child < cell.firstChild + cell.numChildren; ++child) {
+            double* childLocal = &this->locals[child * nc];
+            double s[3] = {this->cells[child].center[0] - cell.center[0], this->cells[child].center[1] - cell.center[1], this->cells[child].center[2] - cell.center[2]};
+            this->monomials(s, powers);
+            // L'_q = sum over n >= q of C(n, q) s^(n - q) L_n.
+            for (const ShiftTerm& term : this->shiftTerms) {
+                childLocal[term.from] += term.coefficient * powers[term.with] * local[term.to];
+            }
+        }
+    }
+}
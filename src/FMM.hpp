@@ -0,0 +1,226 @@
+/** @file FMM.hpp
+ *  @brief Class definition for an N-body gravity simulation with the fast multipole method.
+ *
+ *  @details The bodies are sorted into an adaptive octree. Every cell gets a Cartesian Taylor
+ *  expansion of its mass (multipole, built leaves first) and of the field of the far cells
+ *  (local, pushed down to the leaves). A dual tree walk pairs the cells: well separated
+ *  pairs exchange their field through one multipole to local translation, close leaves sum
+ *  their bodies directly with the NBodyPhysx kernel. The work grows as O(n) for a fixed order
+ *  and opening angle.
+ *
+ *  The derivatives of 1/r are the Taylor coefficients a_n = D^n(1/r) / n!, computed with the
+ *  recurrence |n| r^2 a_n + (2|n| - 1) sum_i x_i a_{n - e_i} + (|n| - 1) sum_i a_{n - 2e_i} = 0.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef FMM_H
+#define FMM_H
+
+#include <vector>
+
+#include "NBody.hpp"
+#include "Physics.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Deepest level of the octree, cells of coincident bodies are not split further.
+const int FMM_MAX_DEPTH = 21;
+//! Highest supported order of the expansions.
+const int FMM_MAX_ORDER = 16;
+
+/** @class FMMPhysx
+ *  @brief Handles the Physics for an N-body simulation with the fast multipole method.
+ *  @details Gravity is scaled like SolarSystemPhysx, a = m / r^2 with G = 1. The order of the
+ *  expansions and the opening angle trade accuracy for speed, see benchmarks/fmm_benchmark.cpp.
+ *  The softening only applies to the bodies summed directly.
+ */
+class FMMPhysx : public Physx {
+   public:
+    //! Highest order of the expansions, at most FMM_MAX_ORDER. The forces are accurate to order - 1.
+    int order;
+    //! Opening angle, two cells interact through their expansions when (r1 + r2) < theta * distance.
+    float theta;
+    //! Largest number of bodies in a leaf cell.
+    int leafSize;
+    //! Softening length of the direct sums.
+    float softening;
+
+    /**
+	 * @brief Construct a new FMMPhysx
+	 *
+	 * @param order Highest order of the expansions.
+	 * @param theta Opening angle.
+	 * @param leafSize Largest number of bodies in a leaf cell.
+	 * @param softening Softening length of the direct sums.
+	 */
+    FMMPhysx(int order = 4, float theta = 0.5f, int leafSize = 64, float softening = 0.0f);
+
+    virtual PhysxEngine getEngine() const {
+        return FMM_ENGINE;
+    }
+
+    virtual void computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations);
+
+    /**
+	 * @brief Compute the gravitational acceleration of every body from all the others.
+	 *
+	 * @param positions
+	 * @param masses
+	 * @param accelerations Resized to the number of bodies.
+	 */
+    void evaluate(const std::vector<glm::vec3>& positions, const std::vector<float>& masses, std::vector<glm::vec3>& accelerations);
+
+    virtual void step(float dt);
+
+    /**
+	 * @brief Get the number of octree cells of the last evaluation.
+	 *
+	 * @return int
+	 */
+    int getCellCount() const {
+        return this->cells.size();
+    }
+
+    /**
+	 * @brief Get the number of multipole to local translations of the last evaluation.
+	 *
+	 * @return long long
+	 */
+    long long getM2LCount() const {
+        return this->m2lCount;
+    }
+
+    /**
+	 * @brief Get the number of body pairs summed directly in the last evaluation.
+	 *
+	 * @return long long
+	 */
+    long long getP2PCount() const {
+        return this->p2pCount;
+    }
+
+   private:
+    /**
+	 * @struct Cell
+	 * @brief A cube of the octree holding the sorted bodies [begin, end).
+	 */
+    typedef struct Cell {
+        //! Expansion center, the center of mass of the bodies.
+        double center[3];
+        //! Distance from the center to the farthest body.
+        double radius;
+        int begin, end;
+        //! Children are stored next to each other, numChildren is 0 for a leaf.
+        int firstChild, numChildren;
+    } Cell;
+
+    /**
+	 * @struct ShiftTerm
+	 * @brief One term of a sum over coefficient pairs: out[to] += coefficient * a[from] * b[with].
+	 */
+    typedef struct ShiftTerm {
+        int to, from, with;
+        double coefficient;
+    } ShiftTerm;
+
+    std::vector<Cell> cells;
+    //! Original index of every sorted body.
+    std::vector<int> index, scratch;
+    //! Sorted positions, masses and accelerations.
+    std::vector<float> x, y, z, m, ax, ay, az;
+    std::vector<float> masses;
+    //! Multipole and local coefficients, numCoefficients per cell.
+    std::vector<double> multipoles, locals;
+    //! Monomials of a displacement, scratch of the passes kept between steps.
+    std::vector<double> powers;
+
+    //! Order the tables below were built for.
+    int tableOrder = -1;
+    int numCoefficients = 0;
+    //! Exponents (i, j, k) of every coefficient, ordered by degree.
+    std::vector<int> exponents;
+    //! Coefficient of every exponent, (order + 1)^3 entries.
+    std::vector<int> coefficientOf;
+    //! Coefficients n - e_i and n - 2e_i used by the derivative recurrence, -1 when an exponent would be negative.
+    std::vector<int> previous, previous2;
+    //! Coefficient n + e_i of every n of degree below the order, -1 otherwise.
+    std::vector<int> gradient;
+    //! Multipole or local shift to a new center: to = k, from = q, with = k - q, coefficient = C(k, q).
+    std::vector<ShiftTerm> shiftTerms;
+    //! Multipole to local: to = n, from = k + n (derivative), with = k (multipole), coefficient = C(k + n, n).
+    std::vector<ShiftTerm> m2lTerms;
+
+    long long m2lCount = 0, p2pCount = 0;
+
+    int coefficient(int i, int j, int k) const {
+        return this->coefficientOf[(i * (this->order + 1) + j) * (this->order + 1) + k];
+    }
+
+    static double binomial(int n, int k);
+
+    /**
+	 * @brief Build the index tables of the expansions for the current order.
+	 */
+    void buildTables();
+
+    /**
+	 * @brief Fill out with the monomials d_x^i d_y^j d_z^k of every coefficient.
+	 */
+    void monomials(const double d[3], double* out) const;
+
+    /**
+	 * @brief Fill out with the Taylor coefficients of 1/r at r.
+	 */
+    void derivatives(const double r[3], double* out) const;
+
+    /**
+	 * @brief Sort the bodies into the octree.
+	 */
+    void buildTree(const std::vector<glm::vec3>& positions, const std::vector<float>& masses);
+
+    /**
+	 * @brief Fill cells[c] with the sorted bodies [begin, end) of the cube around middle and split it into octants.
+	 */
+    void buildCell(int c, int begin, int end, glm::vec3 middle, float half, int depth, const std::vector<glm::vec3>& positions, const std::vector<float>& masses);
+
+    static int octant(const glm::vec3& p, const glm::vec3& middle) {
+        return ((p.x > middle.x) ? 1 : 0) | ((p.y > middle.y) ? 2 : 0) | ((p.z > middle.z) ? 4 : 0);
+    }
+
+    /**
+	 * @brief Build the multipoles, of the bodies for the leaves and of the children for the other cells.
+	 * @details Children always come after their parent, so going backwards visits them first.
+	 */
+    void upwardPass();
+
+    /**
+	 * @brief Dual tree walk adding the field of the bodies of cell b to the bodies of cell a.
+	 */
+    void interact(int a, int b);
+
+    /**
+	 * @brief Add the multipole of cell b to the local expansion of cell a, r is the vector from b to a.
+	 */
+    void m2l(int a, int b, const double r[3]);
+
+    /**
+	 * @brief Add the pull of the bodies of source to the bodies of target.
+	 * @details The targets go through the NBodyPhysx kernel in tiles, the last tile is padded
+	 * with copies of the last target whose results are dropped.
+	 */
+    void p2p(const Cell& target, const Cell& source);
+
+    /**
+	 * @brief Shift the local expansions down to the children and evaluate them at the bodies of the leaves.
+	 * @details Parents always come before their children, so going forwards visits them first.
+	 */
+    void downwardPass();
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
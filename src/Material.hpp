@@ -1,4 +1,4 @@
-/** @file Material.cpp
+/** @file Material.hpp
  *  @brief Class definition for a Material of a Model.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -8,9 +8,6 @@
 #define MATERIAL_H
 
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/matrix_transform.hpp>
-
-using namespace std;
 
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,449 @@
+/** @file Model.cpp
+ *  @brief Implementation of meshes, models and the procedurally generated shapes, see Model.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ *  @author G Sathyaram (wreck-count)
+ */
+
+#include <GL/glew.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <glm/glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Model.hpp"
+
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, Material material, MeshResidency residency) : material(material) {
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->indexCount = this->indices.size();
+    this->residency = residency;
+    this->VAO = this->VBO = this->EBO = 0;
+
+    if (residency == GPU_ONLY || residency == GPU_AND_CPU) {
+        setupMesh();
+    }
+
+    if (residency == GPU_ONLY || residency == COUNT_ONLY) {
+        std::vector<Vertex>().swap(this->vertices);
+        std::vector<unsigned int>().swap(this->indices);
+    }
+}
+
+void Mesh::setupMesh() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+
+    // vertex positions
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    // vertex colors
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glBindVertexArray(0);
+}
+
+Model::Model(std::string const& path, MeshResidency residency) {
+    loadmodel(path, residency);
+    this->sourcePath = path;
+
+    for (int i = 0; i < 3; ++i) {
+        _translation[i] = _rotation[i] = 0.0f;
+        _scale[i] = 1.0f;
+    }
+
+    this->worldPosition = glm::vec3(0.0f);
+    this->translation = glm::vec3(0.0f, 0.0f, 0.0f);
+    this->rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+    this->scale = glm::vec3(1.0f, 1.0f, 1.0f);
+    this->modelMatrix = glm::mat4(1.0f);
+    this->matrixDirty = false;
+    this->transformVersion = 0;
+    visibility = true;
+    control = false;
+}
+
+void Model::updateTransforms() {
+    this->worldPosition = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
+    this->translation = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
+    glm::vec3 rotation = glm::vec3(this->_rotation[0], this->_rotation[1], this->_rotation[2]);
+    glm::vec3 scale = glm::vec3(this->_scale[0], this->_scale[1], this->_scale[2]);
+    // The physics only ever moves a model: the rotation and scale columns stay as they are.
+    if (rotation != this->rotation || scale != this->scale) {
+        this->rotation = rotation;
+        this->scale = scale;
+        this->matrixDirty = true;
+    }
+    this->modelMatrix[3] = glm::vec4(this->translation, 1.0f);
+    ++this->transformVersion;
+}
+
+void Model::updateGlobalTransforms(float* translation, float* rotation, float* scale) {
+    if (this->control) {
+        for (int i = 0; i < 3; ++i) {
+            translation[i] = _translation[i];
+            rotation[i] = _rotation[i];
+            scale[i] = _scale[i];
+        }
+    }
+}
+
+void Model::reset() {
+    for (int i = 0; i < 3; ++i) {
+        _translation[i] = _rotation[i] = 0.0f;
+        _scale[i] = 1.0f;
+    }
+
+    this->updateTransforms();
+    visibility = true;
+    control = false;
+}
+
+Model::Model(Mesh mesh) {
+    this->meshes.push_back(mesh);
+    this->numMeshes = meshes.size();
+    for (int i = 0; i < 3; ++i) {
+        _translation[i] = _rotation[i] = 0.0f;
+        _scale[i] = 1.0f;
+    }
+    this->worldPosition = glm::vec3(0.0f);
+    this->translation = glm::vec3(0.0f, 0.0f, 0.0f);
+    this->rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+    this->scale = glm::vec3(1.0f, 1.0f, 1.0f);
+    this->modelMatrix = glm::mat4(1.0f);
+    this->matrixDirty = false;
+    this->transformVersion = 0;
+    visibility = true;
+    control = false;
+}
+
+void Model::updateModelMatrix() const {
+    this->composeRotationScale();
+    this->modelMatrix[3] = glm::vec4(this->translation, 1.0f);
+}
+
+void Model::composeRotationScale() const {
+    // Rx * Ry * Rz multiplied out, every column scaled by the scale along its axis.
+    glm::vec3 angles = glm::radians(this->rotation);
+    float sx = std::sin(angles.x), cx = std::cos(angles.x);
+    float sy = std::sin(angles.y), cy = std::cos(angles.y);
+    float sz = std::sin(angles.z), cz = std::cos(angles.z);
+    this->modelMatrix[0] = glm::vec4(cy * cz, sx * sy * cz + cx * sz, sx * sz - cx * sy * cz, 0.0f) * this->scale.x;
+    this->modelMatrix[1] = glm::vec4(-cy * sz, cx * cz - sx * sy * sz, cx * sy * sz + sx * cz, 0.0f) * this->scale.y;
+    this->modelMatrix[2] = glm::vec4(sy, -sx * cy, cx * cy, 0.0f) * this->scale.z;
+    this->matrixDirty = false;
+}
+
+void Model::composeModelMatrices(Model* const* models, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (models[i]->matrixDirty) {
+            models[i]->composeRotationScale();
+        }
+    }
+}
+
+void Model::loadmodel(const std::string path, MeshResidency residency) {
+    Assimp::Importer importer;
+
+    const aiScene* scene = importer.ReadFile(path, aiProcessPreset_TargetRealtime_Quality);
+
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        std::cout << "ASSIMP::ERROR::" + std::string(importer.GetErrorString()) << std::endl;
+        return;
+    }
+
+    numMeshes = scene->mNumMeshes;
+    this->meshes.reserve(numMeshes);
+
+    // glm::mat4 blenderToOpenGL = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 blenderToOpenGL(1.0f);
+
+    for (std::uint32_t i = 0u; i < scene->mNumMeshes; ++i) {
+        aiMesh* mesh = scene->mMeshes[i];
+
+        // Extract Material for this Mesh
+        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+
+        aiColor4D ambientColor;
+        aiGetMaterialColor(material, AI_MATKEY_COLOR_AMBIENT, &ambientColor);
+
+        aiColor4D diffuseColor;
+        aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
+
+        aiColor4D specularColor;
+        aiGetMaterialColor(material, AI_MATKEY_COLOR_SPECULAR, &specularColor);
+
+        float shininess;
+        aiGetMaterialFloat(material, AI_MATKEY_SHININESS, &shininess);
+
+        Material meshMaterial = Material(
+            glm::vec4(ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a),
+            glm::vec4(diffuseColor.r, diffuseColor.g, diffuseColor.b, diffuseColor.a),
+            glm::vec4(specularColor.r, specularColor.g, specularColor.b, shininess),
+            shininess);
+
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh->mNumVertices);
+
+        for (std::uint32_t j = 0; j < mesh->mNumVertices; ++j) {
+            Vertex vertex;
+            glm::vec3 posVector;
+            posVector.x = mesh->mVertices[j].x;
+            posVector.y = mesh->mVertices[j].y;
+            posVector.z = mesh->mVertices[j].z;
+
+            glm::vec3 normalVector;
+            normalVector.x = mesh->mNormals[j].x;
+            normalVector.y = mesh->mNormals[j].y;
+            normalVector.z = mesh->mNormals[j].z;
+
+            glm::vec4 transformed = blenderToOpenGL * glm::vec4(posVector, 1.0);
+            vertex.position = glm::vec3(transformed.x, transformed.y, transformed.z);
+
+            transformed = blenderToOpenGL * glm::vec4(normalVector, 1.0);
+            vertex.normal = glm::vec3(transformed.x, transformed.y, transformed.z);
+
+            vertices.push_back(vertex);
+        }
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(mesh->mNumFaces * 3u);
+        for (std::uint32_t k = 0u; k < mesh->mNumFaces; ++k) {
+            indices.push_back(mesh->mFaces[k].mIndices[0u]);
+            indices.push_back(mesh->mFaces[k].mIndices[1u]);
+            indices.push_back(mesh->mFaces[k].mIndices[2u]);
+        }
+        this->meshes.push_back(Mesh(std::move(vertices), std::move(indices), meshMaterial, residency));
+    }
+}
+
+Sphere::Sphere(float radius, unsigned resolution, MeshResidency residency) : Model(Sphere::generateSphere(radius, resolution, residency)) {
+    this->radius = radius;
+    this->resolution = resolution;
+    this->type = SPHERE_MODEL;
+}
+
+Mesh Sphere::generateSphere(float radius, unsigned resolution, MeshResidency residency) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    unsigned indexCount = 6 * resolution * (resolution - 1);
+    unsigned vertCount = (resolution + 1) * (resolution + 1);
+
+    indices.resize(indexCount);
+    vertices.resize(vertCount);
+
+    float lonStep = (2 * PI) / resolution;
+    float latStep = PI / resolution;
+
+    for (unsigned lat = 0, v = 0; lat <= resolution; lat++) {
+        for (unsigned lon = 0; lon <= resolution; lon++, v++) {
+            vertices[v].normal = glm::vec3(
+                cos(lon * lonStep) * sin(lat * latStep),
+                cos(lat * latStep - PI),
+                sin(lon * lonStep) * sin(lat * latStep));
+
+            vertices[v].position = glm::vec3(
+                radius * vertices[v].normal.x,
+                radius * vertices[v].normal.y,
+                radius * vertices[v].normal.z);
+        }
+    }
+    unsigned i = 0;
+    unsigned v = resolution + 1;
+    for (unsigned lon = 0; lon < resolution; lon++, v++) {
+        indices[i++] = lon;
+        indices[i++] = v;
+        indices[i++] = v + 1;
+    }
+
+    v = resolution + 1;
+    for (unsigned lat = 1; lat < resolution - 1; lat++, v++) {
+        for (unsigned lon = 0; lon < resolution; lon++, v++) {
+            indices[i++] = v;
+            indices[i++] = v + resolution + 1;
+            indices[i++] = v + 1;
+
+            indices[i++] = v + 1;
+            indices[i++] = v + resolution + 1;
+            indices[i++] = v + resolution + 2;
+        }
+    }
+
+    for (unsigned lon = 0; lon < resolution; lon++, v++) {
+        indices[i++] = v;
+        indices[i++] = v + resolution + 1;
+        indices[i++] = v + 1;
+    }
+
+    Material material;
+
+    return Mesh(std::move(vertices), std::move(indices), material, residency);
+}
+
+Plane::Plane(std::string const& path, MeshResidency residency) : Model(path, residency) {
+    this->normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->type = PLANE_MODEL;
+}
+
+Plane::Plane(unsigned scale, MeshResidency residency) : Model(Plane::generatePlane(scale, residency)) {
+    this->normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    this->generatedScale = scale;
+    this->type = PLANE_MODEL;
+}
+
+void Plane::updateTransforms() {
+    this->worldPosition = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
+    this->translation = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
+    this->rotation = glm::vec3(this->_rotation[0], this->_rotation[1], this->_rotation[2]);
+    this->scale = glm::vec3(this->_scale[0], this->_scale[1], this->_scale[2]);
+
+    glm::mat4 normalRotator = glm::translate(glm::mat4(1.0f), this->translation);
+    normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    this->normal = glm::vec3(normalRotator * glm::vec4(this->normal, 1.0f));
+    this->normal = glm::normalize(this->normal);
+
+    this->updateOdist();
+    this->updateModelMatrix();
+    ++this->transformVersion;
+}
+
+void Plane::updateOdist() {
+    this->Odist = -1.0f * glm::dot(this->worldPosition, this->normal) / glm::sqrt(glm::dot(this->normal, this->normal));
+    ++this->version;
+}
+
+Mesh Plane::generatePlane(unsigned scale, MeshResidency residency) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    unsigned indexCount = 6;
+    unsigned vertCount = 4;
+
+    indices.resize(indexCount);
+    vertices.resize(vertCount);
+
+    vertices[0].position = glm::vec3(scale, 0, scale);
+    vertices[0].normal = glm::vec3(0, 1, 0);
+
+    vertices[1].position = glm::vec3(scale, 0, -scale);
+    vertices[1].normal = glm::vec3(0, 1, 0);
+
+    vertices[2].position = glm::vec3(-scale, 0, scale);
+    vertices[2].normal = glm::vec3(0, 1, 0);
+
+    vertices[3].position = glm::vec3(-scale, 0, -scale);
+    vertices[3].normal = glm::vec3(0, 1, 0);
+
+    indices[0] = 3;
+    indices[1] = 1;
+    indices[2] = 2;
+    indices[3] = 2;
+    indices[4] = 1;
+    indices[5] = 0;
+
+    Material material;
+
+    return Mesh(std::move(vertices), std::move(indices), material, residency);
+}
+
+Box::Box(float halfSize, MeshResidency residency) : Model(Box::generateBox(halfSize, residency)) {
+    this->halfSize = halfSize;
+    this->type = BOX_MODEL;
+}
+
+Mesh Box::generateBox(float halfSize, MeshResidency residency) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve(24);
+    indices.reserve(36);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = -1; side <= 1; side += 2) {
+            glm::vec3 normal(0.0f);
+            normal[axis] = (float)side;
+            glm::vec3 u(0.0f), v(0.0f);
+            u[(axis + 1) % 3] = 1.0f;
+            v[(axis + 2) % 3] = 1.0f;
+            // Wind the face counter clockwise seen from outside.
+            if (side < 0) {
+                std::swap(u, v);
+            }
+
+            unsigned first = vertices.size();
+            const float corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+            for (int c = 0; c < 4; ++c) {
+                Vertex vertex;
+                vertex.position = (normal + corners[c][0] * u + corners[c][1] * v) * halfSize;
+                vertex.normal = normal;
+                vertices.push_back(vertex);
+            }
+            indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+        }
+    }
+
+    Material material;
+
+    return Mesh(std::move(vertices), std::move(indices), material, residency);
+}
+
+Capsule::Capsule(float radius, float halfHeight, unsigned resolution, MeshResidency residency) : Model(Capsule::generateCapsule(radius, halfHeight, resolution, residency)) {
+    this->radius = radius;
+    this->halfHeight = halfHeight;
+    this->resolution = resolution;
+    this->type = CAPSULE_MODEL;
+}
+
+Mesh Capsule::generateCapsule(float radius, float halfHeight, unsigned resolution, MeshResidency residency) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    unsigned half = std::max(1u, resolution / 2);
+
+    float lonStep = (2 * PI) / resolution;
+    float latStep = PI / (2 * half);
+
+    unsigned rings = 0;
+    for (unsigned lat = 0; lat <= 2 * half; lat++) {
+        // The equator is written twice, once for each cap.
+        for (int copy = 0; copy < ((lat == half) ? 2 : 1); ++copy) {
+            float offset = (lat < half || (lat == half && copy == 0)) ? -halfHeight : halfHeight;
+            for (unsigned lon = 0; lon <= resolution; lon++) {
+                Vertex vertex;
+                vertex.normal = glm::vec3(
+                    cos(lon * lonStep) * sin(lat * latStep),
+                    cos(lat * latStep - PI),
+                    sin(lon * lonStep) * sin(lat * latStep));
+                vertex.position = radius * vertex.normal + glm::vec3(0.0f, offset, 0.0f);
+                vertices.push_back(vertex);
+            }
+            ++rings;
+        }
+    }
+
+    for (unsigned ring = 0; ring + 1 < rings; ring++) {
+        unsigned v = ring * (resolution + 1);
+        for (unsigned lon = 0; lon < resolution; lon++, v++) {
+            indices.insert(indices.end(), {v, v + resolution + 1, v + 1, v + 1, v + resolution + 1, v + resolution + 2});
+        }
+    }
+
+    Material material;
+
+    return Mesh(std::move(vertices), std::move(indices), material, residency);
+}
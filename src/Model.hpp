@@ -1,4 +1,4 @@
-/** @file Model.cpp
+/** @file Model.hpp
  *  @brief Class definition for a Model.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -8,19 +8,14 @@
 #ifndef MODEL_H
 #define MODEL_H
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
-#include <iostream>
 
 #include "Material.hpp"
 
-using namespace std;
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -38,16 +33,30 @@ typedef struct Vertex {
     glm::vec3 normal;
 } Vertex;
 
+/**
+ * @enum MeshResidency
+ * @brief Decides which copies of a Mesh's data are kept alive once the Mesh is built.
+ * @details After the upload only the index count and the GPU handles are needed for rendering,
+ * so the CPU side copies are released by default. Meshes used by physics or picking opt in to keep them.
+ */
+enum MeshResidency {
+    GPU_ONLY,     /* Upload to the GPU and release the CPU copies. (Default) */
+    GPU_AND_CPU,  /* Upload to the GPU and keep the CPU copies. */
+    CPU_ONLY,     /* Keep the CPU copies without any OpenGL calls. (Headless) */
+    COUNT_ONLY    /* Keep only the index count without any OpenGL calls. (Headless) */
+};
+
 /** @class Mesh
  *  @brief Data class for a Mesh object.
  *  @details This class that stores all the vertices of a mesh and the index strcuture of the faces and also created the VAO, VBO, and EBO for the Mesh.
+ *  Depending on the MeshResidency, the vertices and indices are released after the upload and only the index count is kept.
  */
 class Mesh {
    public:
-    //! @brief List of all vertices of the current Mesh.
+    //! @brief List of all vertices of the current Mesh. (Empty unless the residency keeps CPU copies.)
     std::vector<Vertex> vertices;
 
-    //! @brief List of all indices of the current Mesh's vertices. (Read as triples, since we deal with Triangulated Polygons.)
+    //! @brief List of all indices of the current Mesh's vertices. (Read as triples, since we deal with Triangulated Polygons.) (Empty unless the residency keeps CPU copies.)
     std::vector<unsigned int> indices;
 
     //! @brief Material of the object.
@@ -55,13 +64,13 @@ class Mesh {
 
     /**
 	 * @brief Default Constructor.
+	 * 
+	 * @param vertices 
+	 * @param indices 
+	 * @param material 
+	 * @param residency Which copies of the mesh data to keep after construction.
 	*/
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, Material material) : material(material) {
-        this->vertices = vertices;
-        this->indices = indices;
-
-        setupMesh();
-    }
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, Material material, MeshResidency residency = GPU_ONLY);
 
     /** @brief getVertexArrayObjectPointer - Return the VAO index in memory for the current Mesh.
  	*
@@ -71,30 +80,49 @@ class Mesh {
         return this->VAO;
     }
 
-   private:
-    unsigned int VAO, VBO, EBO;
+    /** @brief getIndexCount - Return the number of indices drawn for the current Mesh.
+ 	*
+ 	* @return unsigned int - The index count.
+ 	*/
+    unsigned int getIndexCount() const {
+        return this->indexCount;
+    }
 
-    void setupMesh() {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+    /** @brief getResidency - Return the residency policy the Mesh was built with.
+ 	*
+ 	* @return MeshResidency
+ 	*/
+    MeshResidency getResidency() const {
+        return this->residency;
+    }
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    /** @brief hasCPUData - Check whether the vertices and indices are still available on the CPU.
+ 	*
+ 	* @return true When the CPU copies are kept.
+ 	* @return false When only the index count is kept.
+ 	*/
+    bool hasCPUData() const {
+        return this->residency == GPU_AND_CPU || this->residency == CPU_ONLY;
+    }
 
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+   private:
+    unsigned int VAO, VBO, EBO;
+    unsigned int indexCount;
+    MeshResidency residency;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    void setupMesh();
+};
 
-        // vertex positions
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex colors
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        glBindVertexArray(0);
-    }
+/**
+ * @enum ModelType
+ * @brief Decides how a Model was created, so that it can be recreated from a scene file.
+ */
+enum ModelType {
+    GENERIC_MODEL, /* Loaded from a Wavefront Object file. */
+    SPHERE_MODEL,  /* Procedurally generated Sphere. */
+    PLANE_MODEL,   /* Plane, either loaded from a file or procedurally generated. */
+    BOX_MODEL,     /* Procedurally generated Box. */
+    CAPSULE_MODEL  /* Procedurally generated Capsule. */
 };
 
 /** @class Model
@@ -117,6 +145,11 @@ class Model {
     //! @brief Number of meshes for the model.
     std::uint32_t numMeshes;
 
+    //! @brief How the model was created.
+    ModelType type = GENERIC_MODEL;
+    //! @brief Path of the Wavefront Object file the model was loaded from. (Empty for generated models.)
+    std::string sourcePath;
+
     glm::vec3 worldPosition;
 
     glm::vec3 translation;
@@ -125,8 +158,14 @@ class Model {
     //! @brief Scaling vector (sx,sy,sz) used in the Transformation operation's matrix.
     glm::vec3 scale;
 
-    //! @brief The Model matrix that transforms the object in the world coordinate space.
-    glm::mat4 modelMatrix;
+    //! @brief The Model matrix that transforms the object in the world coordinate space. Read it with getModelMatrix().
+    mutable glm::mat4 modelMatrix;
+    //! @brief Whether the rotation and scale columns of the Model matrix are out of date.
+    mutable bool matrixDirty;
+    //! @brief Incremented whenever the transforms change, so a Scene knows which world matrices to update.
+    std::uint32_t transformVersion;
+    //! @brief Index of the model in the Scene it was added to, -1 while it is in none. Kept by Scene.
+    int sceneIndex = -1;
 
     //! @brief The 3-tuple to store the updates values of translation from the GUI.
     float _translation[3];
@@ -139,46 +178,20 @@ class Model {
 	 * @brief Construct a new Model object from the OBJ file specified using the path.
 	 * 
 	 * @param path Absolute path to the location of the model's Wavefront Object file in the OS.
+	 * @param residency Which copies of the mesh data to keep after loading. Use GPU_AND_CPU for models needed by physics or picking.
 	*/
-    Model(std::string const& path) {
-        loadmodel(path);
-
-        for (int i = 0; i < 3; ++i) {
-            _translation[i] = _rotation[i] = 0.0f;
-            _scale[i] = 1.0f;
-        }
-
-        this->worldPosition = glm::vec3(0.0f);
-        this->translation = glm::vec3(0.0f, 0.0f, 0.0f);
-        this->rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-        this->scale = glm::vec3(1.0f, 1.0f, 1.0f);
-        this->modelMatrix = glm::mat4(1.0f);
-        visibility = true;
-        control = false;
-    }
+    Model(std::string const& path, MeshResidency residency = GPU_ONLY);
 
     /** @brief updateTransforms - Transform the object properties.
  	* @details Applies the translation, rotation, and scaling transformations to the current model as updated in the GUI.
+	* A new translation is written straight into the Model matrix. A new rotation or scale only marks the matrix dirty,
+	* it is rebuilt when it is next read or by composeModelMatrices() before rendering.
 	* 
  	* @return void
  	*/
-    void updateTransforms() {
-        this->worldPosition = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
-        this->translation = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
-        this->rotation = glm::vec3(this->_rotation[0], this->_rotation[1], this->_rotation[2]);
-        this->scale = glm::vec3(this->_scale[0], this->_scale[1], this->_scale[2]);
-        this->updateModelMatrix();
-    }
+    void updateTransforms();
 
-    void updateGlobalTransforms(float* translation, float* rotation, float* scale) {
-        if (this->control) {
-            for (int i = 0; i < 3; ++i) {
-                translation[i] = _translation[i];
-                rotation[i] = _rotation[i];
-                scale[i] = _scale[i];
-            }
-        }
-    }
+    void updateGlobalTransforms(float* translation, float* rotation, float* scale);
 
     /** @brief reset - Reset all the Model properties.
  	* @details Resets all the model properties i.e. translation and rotation 0 scaling to 1.
@@ -186,16 +199,7 @@ class Model {
 	* 
  	* @return void
  	*/
-    void reset() {
-        for (int i = 0; i < 3; ++i) {
-            _translation[i] = _rotation[i] = 0.0f;
-            _scale[i] = 1.0f;
-        }
-
-        this->updateTransforms();
-        visibility = true;
-        control = false;
-    }
+    void reset();
 
     /**
 	 * @brief Get the Model Matrix of the current Model
@@ -203,122 +207,50 @@ class Model {
 	 * @return const glm::mat4& 
 	 */
     const glm::mat4& getModelMatrix() const {
+        if (this->matrixDirty) {
+            this->updateModelMatrix();
+        }
         return this->modelMatrix;
     }
 
+    /**
+	 * @brief Rebuild the Model matrices of the dirty models among the given ones.
+	 * @details A scalar loop that rebuilds the rotation and scale columns of each dirty model from the
+	 * closed form of Rx * Ry * Rz, with one sine and cosine per axis. The renderer calls this before
+	 * drawing, so every model rotated or scaled since the last frame is updated in one pass instead of
+	 * one model at a time while drawing.
+	 *
+	 * @param models
+	 * @param count
+	 */
+    static void composeModelMatrices(Model* const* models, std::size_t count);
+
    protected:
     /**
     * @brief Construct a new Model object using the mesh provided.
     * 
     * @param mesh 
     */
-    Model(Mesh mesh) {
-        this->meshes.push_back(mesh);
-        this->numMeshes = meshes.size();
-        for (int i = 0; i < 3; ++i) {
-            _translation[i] = _rotation[i] = 0.0f;
-            _scale[i] = 1.0f;
-        }
-        this->worldPosition = glm::vec3(0.0f);
-        this->translation = glm::vec3(0.0f, 0.0f, 0.0f);
-        this->rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-        this->scale = glm::vec3(1.0f, 1.0f, 1.0f);
-        this->modelMatrix = glm::mat4(1.0f);
-        visibility = true;
-        control = false;
-    }
+    Model(Mesh mesh);
 
     /**
 	 * @brief Update the Model Matric based on the
 	 * transformations made to the Model in the 3D scene.
 	 */
-    void updateModelMatrix() {
-        this->modelMatrix = glm::translate(glm::mat4(1.0f), this->translation);
-        this->modelMatrix = glm::rotate(this->modelMatrix, glm::radians(this->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        this->modelMatrix = glm::rotate(this->modelMatrix, glm::radians(this->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        this->modelMatrix = glm::rotate(this->modelMatrix, glm::radians(this->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        this->modelMatrix = glm::scale(this->modelMatrix, this->scale);
-    }
+    void updateModelMatrix() const;
+
+    /**
+	 * @brief Write the rotation and scale columns of the Model matrix, rotated by x, then y, then z.
+	 */
+    void composeRotationScale() const;
 
     /**
 	 * @brief Read an OBJ file specified using the path to read Model data
 	 * 
 	 * @param path 
+	 * @param residency 
 	 */
-    void loadmodel(const std::string path) {
-        Assimp::Importer importer;
-
-        const aiScene* scene = importer.ReadFile(path, aiProcessPreset_TargetRealtime_Quality);
-
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            std::cout << "ASSIMP::ERROR::" + std::string(importer.GetErrorString()) << std::endl;
-            return;
-        }
-
-        numMeshes = scene->mNumMeshes;
-        this->meshes.reserve(numMeshes);
-
-        // glm::mat4 blenderToOpenGL = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        glm::mat4 blenderToOpenGL(1.0f);
-
-        for (std::uint32_t i = 0u; i < scene->mNumMeshes; ++i) {
-            aiMesh* mesh = scene->mMeshes[i];
-
-            // Extract Material for this Mesh
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-            aiColor4D ambientColor;
-            aiGetMaterialColor(material, AI_MATKEY_COLOR_AMBIENT, &ambientColor);
-
-            aiColor4D diffuseColor;
-            aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
-
-            aiColor4D specularColor;
-            aiGetMaterialColor(material, AI_MATKEY_COLOR_SPECULAR, &specularColor);
-
-            float shininess;
-            aiGetMaterialFloat(material, AI_MATKEY_SHININESS, &shininess);
-
-            Material meshMaterial = Material(
-                glm::vec4(ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a),
-                glm::vec4(diffuseColor.r, diffuseColor.g, diffuseColor.b, diffuseColor.a),
-                glm::vec4(specularColor.r, specularColor.g, specularColor.b, shininess),
-                shininess);
-
-            std::vector<Vertex> vertices;
-            vertices.reserve(mesh->mNumVertices);
-
-            for (std::uint32_t j = 0; j < mesh->mNumVertices; ++j) {
-                Vertex vertex;
-                glm::vec3 posVector;
-                posVector.x = mesh->mVertices[j].x;
-                posVector.y = mesh->mVertices[j].y;
-                posVector.z = mesh->mVertices[j].z;
-
-                glm::vec3 normalVector;
-                normalVector.x = mesh->mNormals[j].x;
-                normalVector.y = mesh->mNormals[j].y;
-                normalVector.z = mesh->mNormals[j].z;
-
-                glm::vec4 transformed = blenderToOpenGL * glm::vec4(posVector, 1.0);
-                vertex.position = glm::vec3(transformed.x, transformed.y, transformed.z);
-
-                transformed = blenderToOpenGL * glm::vec4(normalVector, 1.0);
-                vertex.normal = glm::vec3(transformed.x, transformed.y, transformed.z);
-
-                vertices.push_back(vertex);
-            }
-
-            std::vector<std::uint32_t> indices;
-            indices.reserve(mesh->mNumFaces * 3u);
-            for (std::uint32_t k = 0u; k < mesh->mNumFaces; ++k) {
-                indices.push_back(mesh->mFaces[k].mIndices[0u]);
-                indices.push_back(mesh->mFaces[k].mIndices[1u]);
-                indices.push_back(mesh->mFaces[k].mIndices[2u]);
-            }
-            this->meshes.push_back(Mesh(vertices, indices, meshMaterial));
-        }
-    }
+    void loadmodel(const std::string path, MeshResidency residency = GPU_ONLY);
 };
 
 /** @class Sphere
@@ -328,16 +260,17 @@ class Model {
 class Sphere : public Model {
    public:
     float radius;
+    //! Resolution the sphere mesh was generated with.
+    unsigned resolution;
 
     /**
 	 * @brief Construct a new Sphere object
 	 * 
 	 * @param radius 
 	 * @param resolution 
+	 * @param residency 
 	 */
-    Sphere(float radius, unsigned resolution) : Model(Sphere::generateSphere(radius, resolution)) {
-        this->radius = radius;
-    }
+    Sphere(float radius, unsigned resolution, MeshResidency residency = GPU_ONLY);
 
     /**
 	 * @brief Procedurally generate a sphere mesh using the resolution and radius
@@ -345,65 +278,10 @@ class Sphere : public Model {
 	 * @param resolution 
 	 * @param resolution 
 	 * @param radius 
+	 * @param residency 
 	 * @return Mesh 
 	 */
-    static Mesh generateSphere(float radius, unsigned resolution) {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-
-        unsigned indexCount = 6 * resolution * (resolution - 1);
-        unsigned vertCount = (resolution + 1) * (resolution + 1);
-
-        indices.resize(indexCount);
-        vertices.resize(vertCount);
-
-        float lonStep = (2 * PI) / resolution;
-        float latStep = PI / resolution;
-
-        for (unsigned lat = 0, v = 0; lat <= resolution; lat++) {
-            for (unsigned lon = 0; lon <= resolution; lon++, v++) {
-                vertices[v].normal = glm::vec3(
-                    cos(lon * lonStep) * sin(lat * latStep),
-                    cos(lat * latStep - PI),
-                    sin(lon * lonStep) * sin(lat * latStep));
-
-                vertices[v].position = glm::vec3(
-                    radius * vertices[v].normal.x,
-                    radius * vertices[v].normal.y,
-                    radius * vertices[v].normal.z);
-            }
-        }
-        unsigned i = 0;
-        unsigned v = resolution + 1;
-        for (unsigned lon = 0; lon < resolution; lon++, v++) {
-            indices[i++] = lon;
-            indices[i++] = v;
-            indices[i++] = v + 1;
-        }
-
-        v = resolution + 1;
-        for (unsigned lat = 1; lat < resolution - 1; lat++, v++) {
-            for (unsigned lon = 0; lon < resolution; lon++, v++) {
-                indices[i++] = v;
-                indices[i++] = v + resolution + 1;
-                indices[i++] = v + 1;
-
-                indices[i++] = v + 1;
-                indices[i++] = v + resolution + 1;
-                indices[i++] = v + resolution + 2;
-            }
-        }
-
-        for (unsigned lon = 0; lon < resolution; lon++, v++) {
-            indices[i++] = v;
-            indices[i++] = v + resolution + 1;
-            indices[i++] = v + 1;
-        }
-
-        Material material;
-
-        return Mesh(vertices, indices, material);
-    }
+    static Mesh generateSphere(float radius, unsigned resolution, MeshResidency residency = GPU_ONLY);
 };
 
 /** @class Plane
@@ -414,89 +292,105 @@ class Plane : public Model {
    public:
     glm::vec3 normal;
     float Odist = 0.0f;
+    //! Incremented whenever the normal or Odist change, so colliders can cache the plane equation.
+    unsigned version = 0;
+    //! Scale the plane mesh was generated with. (0 when loaded from a file.)
+    unsigned generatedScale = 0;
 
     /**
 	 * @brief Construct a new Plane object from the OBJ file specified in the path.
 	 * 
 	 * @param path 
+	 * @param residency 
 	 */
-    Plane(std::string const& path) : Model(path) {
-        this->normal = glm::vec3(0.0f, 1.0f, 0.0f);
-    }
+    Plane(std::string const& path, MeshResidency residency = GPU_ONLY);
 
     /**
 	 * @brief Construct a new Plane object
 	 * 
 	 * @param scale 
+	 * @param residency 
 	 */
-    Plane(unsigned scale) : Model(Plane::generatePlane(scale)) {
-        this->normal = glm::vec3(0.0f, 1.0f, 0.0f);
-    }
+    Plane(unsigned scale, MeshResidency residency = GPU_ONLY);
 
     /**
 	 * @brief Updates the model matrix and the normal of the
 	 * plane based on the transforms applied to the Model.
 	 */
-    void updateTransforms() {
-        this->worldPosition = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
-        this->translation = glm::vec3(this->_translation[0], this->_translation[1], this->_translation[2]);
-        this->rotation = glm::vec3(this->_rotation[0], this->_rotation[1], this->_rotation[2]);
-        this->scale = glm::vec3(this->_scale[0], this->_scale[1], this->_scale[2]);
-
-        glm::mat4 normalRotator = glm::translate(glm::mat4(1.0f), this->translation);
-        normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        normalRotator = glm::rotate(normalRotator, glm::radians(this->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        this->normal = glm::vec3(normalRotator * glm::vec4(this->normal, 1.0f));
-        this->normal = glm::normalize(this->normal);
-
-        this->updateOdist();
-        this->updateModelMatrix();
-    }
+    void updateTransforms();
 
-    void updateOdist() {
-        this->Odist = -1.0f * glm::dot(this->worldPosition, this->normal) / glm::sqrt(glm::dot(this->normal, this->normal));
-    }
+    void updateOdist();
 
     /**
 	 * @brief Procedurally generate a sphere mesh using the resolution and radius
 	 * 
 	 * @param scale 
+	 * @param residency 
 	 * @return Mesh 
 	 */
-    static Mesh generatePlane(unsigned scale) {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-
-        unsigned indexCount = 6;
-        unsigned vertCount = 4;
-
-        indices.resize(indexCount);
-        vertices.resize(vertCount);
-
-        vertices[0].position = glm::vec3(scale, 0, scale);
-        vertices[0].normal = glm::vec3(0, 1, 0);
+    static Mesh generatePlane(unsigned scale, MeshResidency residency = GPU_ONLY);
+};
 
-        vertices[1].position = glm::vec3(scale, 0, -scale);
-        vertices[1].normal = glm::vec3(0, 1, 0);
+/** @class Box
+ *  @brief Class for a Box model inherited from Model class.
+ *  @details A cube centered on the origin of the model, scaled per axis by the model's scale.
+ */
+class Box : public Model {
+   public:
+    //! Half the side of the cube before scaling.
+    float halfSize;
 
-        vertices[2].position = glm::vec3(-scale, 0, scale);
-        vertices[2].normal = glm::vec3(0, 1, 0);
+    /**
+	 * @brief Construct a new Box object
+	 * 
+	 * @param halfSize 
+	 * @param residency 
+	 */
+    Box(float halfSize, MeshResidency residency = GPU_ONLY);
 
-        vertices[3].position = glm::vec3(-scale, 0, -scale);
-        vertices[3].normal = glm::vec3(0, 1, 0);
+    /**
+	 * @brief Procedurally generate a box mesh, 4 vertices per face so that the faces are flat shaded.
+	 * 
+	 * @param halfSize 
+	 * @param residency 
+	 * @return Mesh 
+	 */
+    static Mesh generateBox(float halfSize, MeshResidency residency = GPU_ONLY);
+};
 
-        indices[0] = 3;
-        indices[1] = 1;
-        indices[2] = 2;
-        indices[3] = 2;
-        indices[4] = 1;
-        indices[5] = 0;
+/** @class Capsule
+ *  @brief Class for a Capsule model inherited from Model class.
+ *  @details A cylinder along the model's y axis capped by two half spheres.
+ */
+class Capsule : public Model {
+   public:
+    float radius;
+    //! Half the length of the cylinder between the centers of the caps.
+    float halfHeight;
+    //! Resolution the capsule mesh was generated with.
+    unsigned resolution;
 
-        Material material;
+    /**
+	 * @brief Construct a new Capsule object
+	 * 
+	 * @param radius 
+	 * @param halfHeight 
+	 * @param resolution 
+	 * @param residency 
+	 */
+    Capsule(float radius, float halfHeight, unsigned resolution, MeshResidency residency = GPU_ONLY);
 
-        return Mesh(vertices, indices, material);
-    }
+    /**
+	 * @brief Procedurally generate a capsule mesh: the rings of a sphere, with the lower half moved
+	 * down and the upper half moved up by halfHeight. The equator ring is doubled to close the cylinder.
+	 * 
+	 * @param radius 
+	 * @param halfHeight 
+	 * @param resolution Number of segments around, and between the poles.
+	 * @param residency 
+	 * @return Mesh 
+	 */
+    static Mesh generateCapsule(float radius, float halfHeight, unsigned resolution, MeshResidency residency = GPU_ONLY);
 };
 
 #ifdef __cplusplus
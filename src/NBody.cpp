@@ -0,0 +1,208 @@
+/** @file NBody.cpp
+ *  @brief Implementation of the N-body simulation, see NBody.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "NBody.hpp"
+
+NBodyPhysx::NBodyPhysx(float softening, int numThreads) {
+    this->softening = softening;
+    this->numThreads = (numThreads > 0) ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+const char* NBodyPhysx::kernelName() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__) && defined(__FMA__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+void NBodyPhysx::computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations) {
+    int numObjects = this->objects.size();
+    int padded = (numObjects + NBODY_TILE - 1) / NBODY_TILE * NBODY_TILE;
+    this->x.assign(padded, 0.0f);
+    this->y.assign(padded, 0.0f);
+    this->z.assign(padded, 0.0f);
+    // Padding bodies have no mass and pull on nothing.
+    this->m.assign(padded, 0.0f);
+    this->ax.resize(padded);
+    this->ay.resize(padded);
+    this->az.resize(padded);
+    for (int i = 0; i < numObjects; ++i) {
+        this->x[i] = positions[i].x;
+        this->y[i] = positions[i].y;
+        this->z[i] = positions[i].z;
+        this->m[i] = this->objects[i]->mass;
+    }
+
+    this->computeSoA(padded);
+
+    for (int i = 0; i < numObjects; ++i) {
+        accelerations[i] = glm::vec3(this->ax[i], this->ay[i], this->az[i]);
+    }
+}
+
+void NBodyPhysx::accelerationKernel(const float* x, const float* y, const float* z, const float* m, int n, float softening2,
+                                   float* ax, float* ay, float* az, int begin, int end, bool exact) {
+    std::fill(ax + begin, ax + end, 0.0f);
+    std::fill(ay + begin, ay + end, 0.0f);
+    std::fill(az + begin, az + end, 0.0f);
+    for (int block = 0; block < n; block += NBODY_BLOCK_SIZE) {
+        int blockEnd = std::min(n, block + NBODY_BLOCK_SIZE);
+        for (int i = begin; i < end; i += NBODY_TILE) {
+            if (exact) {
+                accelerationTileExact(x + i, y + i, z + i, x, y, z, m, block, blockEnd, softening2, ax + i, ay + i, az + i);
+            } else {
+                accelerationTile(x + i, y + i, z + i, x, y, z, m, block, blockEnd, softening2, ax + i, ay + i, az + i);
+            }
+        }
+    }
+}
+
+void NBodyPhysx::step(float dt) {
+    this->updateObjects();
+    this->integrate(dt);
+    for (PhysxObject* p : this->objects) {
+        p->model->_translation[0] = p->model->worldPosition.x;
+        p->model->_translation[1] = p->model->worldPosition.y;
+        p->model->_translation[2] = p->model->worldPosition.z;
+        p->model->updateTransforms();
+    }
+}
+
+void NBodyPhysx::computeSoA(int n) {
+    float softening2 = this->softening * this->softening;
+    int tiles = n / NBODY_TILE;
+    int threads = std::max(1, std::min(this->numThreads, tiles));
+    // Waking the workers costs more than small systems take to compute.
+    if (n < 1024) {
+        threads = 1;
+    }
+
+    auto task = [&](int t) {
+        int begin = tiles * t / threads * NBODY_TILE;
+        int end = tiles * (t + 1) / threads * NBODY_TILE;
+        accelerationKernel(this->x.data(), this->y.data(), this->z.data(), this->m.data(), n, softening2,
+                           this->ax.data(), this->ay.data(), this->az.data(), begin, end, this->deterministic);
+    };
+    this->pool.run(threads, task);
+}
+
+#if defined(__AVX512F__)
+void NBodyPhysx::accelerationTile(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                 int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az) {
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 threeHalves = _mm512_set1_ps(1.5f);
+    const __m512 eps2 = _mm512_set1_ps(softening2);
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 xi0 = _mm512_loadu_ps(xi), xi1 = _mm512_loadu_ps(xi + 16);
+    __m512 yi0 = _mm512_loadu_ps(yi), yi1 = _mm512_loadu_ps(yi + 16);
+    __m512 zi0 = _mm512_loadu_ps(zi), zi1 = _mm512_loadu_ps(zi + 16);
+    __m512 ax0 = _mm512_loadu_ps(ax), ax1 = _mm512_loadu_ps(ax + 16);
+    __m512 ay0 = _mm512_loadu_ps(ay), ay1 = _mm512_loadu_ps(ay + 16);
+    __m512 az0 = _mm512_loadu_ps(az), az1 = _mm512_loadu_ps(az + 16);
+    for (int j = jBegin; j < jEnd; ++j) {
+        __m512 xj = _mm512_set1_ps(x[j]), yj = _mm512_set1_ps(y[j]), zj = _mm512_set1_ps(z[j]), mj = _mm512_set1_ps(m[j]);
+        __m512 dx0 = _mm512_sub_ps(xj, xi0), dx1 = _mm512_sub_ps(xj, xi1);
+        __m512 dy0 = _mm512_sub_ps(yj, yi0), dy1 = _mm512_sub_ps(yj, yi1);
+        __m512 dz0 = _mm512_sub_ps(zj, zi0), dz1 = _mm512_sub_ps(zj, zi1);
+        __m512 r0 = _mm512_fmadd_ps(dx0, dx0, _mm512_fmadd_ps(dy0, dy0, _mm512_fmadd_ps(dz0, dz0, eps2)));
+        __m512 r1 = _mm512_fmadd_ps(dx1, dx1, _mm512_fmadd_ps(dy1, dy1, _mm512_fmadd_ps(dz1, dz1, eps2)));
+        // 1 / sqrt(r) to 14 bits, then one Newton step: s = s * (1.5 - 0.5 * r * s * s).
+        __m512 s0 = _mm512_maskz_rsqrt14_ps(0xFFFF, r0), s1 = _mm512_maskz_rsqrt14_ps(0xFFFF, r1);
+        s0 = _mm512_mul_ps(s0, _mm512_fnmadd_ps(_mm512_mul_ps(half, r0), _mm512_mul_ps(s0, s0), threeHalves));
+        s1 = _mm512_mul_ps(s1, _mm512_fnmadd_ps(_mm512_mul_ps(half, r1), _mm512_mul_ps(s1, s1), threeHalves));
+        // Without softening a target is at distance 0 from itself, r is 0 and its own pull is masked out.
+        __m512 f0 = _mm512_maskz_mul_ps(_mm512_cmp_ps_mask(r0, zero, _CMP_GT_OQ), mj, _mm512_mul_ps(s0, _mm512_mul_ps(s0, s0)));
+        __m512 f1 = _mm512_maskz_mul_ps(_mm512_cmp_ps_mask(r1, zero, _CMP_GT_OQ), mj, _mm512_mul_ps(s1, _mm512_mul_ps(s1, s1)));
+        ax0 = _mm512_fmadd_ps(dx0, f0, ax0), ax1 = _mm512_fmadd_ps(dx1, f1, ax1);
+        ay0 = _mm512_fmadd_ps(dy0, f0, ay0), ay1 = _mm512_fmadd_ps(dy1, f1, ay1);
+        az0 = _mm512_fmadd_ps(dz0, f0, az0), az1 = _mm512_fmadd_ps(dz1, f1, az1);
+    }
+    _mm512_storeu_ps(ax, ax0), _mm512_storeu_ps(ax + 16, ax1);
+    _mm512_storeu_ps(ay, ay0), _mm512_storeu_ps(ay + 16, ay1);
+    _mm512_storeu_ps(az, az0), _mm512_storeu_ps(az + 16, az1);
+}
+
+#elif defined(__AVX2__) && defined(__FMA__)
+/**
+ * @brief The AVX2 kernel for 16 targets. 4 vectors of targets would not fit the 16 registers.
+ */
+static void accelerationHalfTile(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                 int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    const __m256 eps2 = _mm256_set1_ps(softening2);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 xi0 = _mm256_loadu_ps(xi), xi1 = _mm256_loadu_ps(xi + 8);
+    __m256 yi0 = _mm256_loadu_ps(yi), yi1 = _mm256_loadu_ps(yi + 8);
+    __m256 zi0 = _mm256_loadu_ps(zi), zi1 = _mm256_loadu_ps(zi + 8);
+    __m256 ax0 = _mm256_loadu_ps(ax), ax1 = _mm256_loadu_ps(ax + 8);
+    __m256 ay0 = _mm256_loadu_ps(ay), ay1 = _mm256_loadu_ps(ay + 8);
+    __m256 az0 = _mm256_loadu_ps(az), az1 = _mm256_loadu_ps(az + 8);
+    for (int j = jBegin; j < jEnd; ++j) {
+        __m256 xj = _mm256_set1_ps(x[j]), yj = _mm256_set1_ps(y[j]), zj = _mm256_set1_ps(z[j]), mj = _mm256_set1_ps(m[j]);
+        __m256 dx0 = _mm256_sub_ps(xj, xi0), dx1 = _mm256_sub_ps(xj, xi1);
+        __m256 dy0 = _mm256_sub_ps(yj, yi0), dy1 = _mm256_sub_ps(yj, yi1);
+        __m256 dz0 = _mm256_sub_ps(zj, zi0), dz1 = _mm256_sub_ps(zj, zi1);
+        __m256 r0 = _mm256_fmadd_ps(dx0, dx0, _mm256_fmadd_ps(dy0, dy0, _mm256_fmadd_ps(dz0, dz0, eps2)));
+        __m256 r1 = _mm256_fmadd_ps(dx1, dx1, _mm256_fmadd_ps(dy1, dy1, _mm256_fmadd_ps(dz1, dz1, eps2)));
+        // 1 / sqrt(r) to 12 bits, then one Newton step: s = s * (1.5 - 0.5 * r * s * s).
+        __m256 s0 = _mm256_rsqrt_ps(r0), s1 = _mm256_rsqrt_ps(r1);
+        s0 = _mm256_mul_ps(s0, _mm256_fnmadd_ps(_mm256_mul_ps(half, r0), _mm256_mul_ps(s0, s0), threeHalves));
+        s1 = _mm256_mul_ps(s1, _mm256_fnmadd_ps(_mm256_mul_ps(half, r1), _mm256_mul_ps(s1, s1), threeHalves));
+        // Without softening a target is at distance 0 from itself, r is 0 and its own pull is masked out.
+        __m256 f0 = _mm256_and_ps(_mm256_cmp_ps(r0, zero, _CMP_GT_OQ), _mm256_mul_ps(mj, _mm256_mul_ps(s0, _mm256_mul_ps(s0, s0))));
+        __m256 f1 = _mm256_and_ps(_mm256_cmp_ps(r1, zero, _CMP_GT_OQ), _mm256_mul_ps(mj, _mm256_mul_ps(s1, _mm256_mul_ps(s1, s1))));
+        ax0 = _mm256_fmadd_ps(dx0, f0, ax0), ax1 = _mm256_fmadd_ps(dx1, f1, ax1);
+        ay0 = _mm256_fmadd_ps(dy0, f0, ay0), ay1 = _mm256_fmadd_ps(dy1, f1, ay1);
+        az0 = _mm256_fmadd_ps(dz0, f0, az0), az1 = _mm256_fmadd_ps(dz1, f1, az1);
+    }
+    _mm256_storeu_ps(ax, ax0), _mm256_storeu_ps(ax + 8, ax1);
+    _mm256_storeu_ps(ay, ay0), _mm256_storeu_ps(ay + 8, ay1);
+    _mm256_storeu_ps(az, az0), _mm256_storeu_ps(az + 8, az1);
+}
+
+void NBodyPhysx::accelerationTile(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                 int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az) {
+    for (int t = 0; t < NBODY_TILE; t += 16) {
+        accelerationHalfTile(xi + t, yi + t, zi + t, x, y, z, m, jBegin, jEnd, softening2, ax + t, ay + t, az + t);
+    }
+}
+
+#else
+void NBodyPhysx::accelerationTile(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                 int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az) {
+    accelerationTileExact(xi, yi, zi, x, y, z, m, jBegin, jEnd, softening2, ax, ay, az);
+}
+#endif
+
+void NBodyPhysx::accelerationTileExact(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                      int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az) {
+    for (int t = 0; t < NBODY_TILE; ++t) {
+        float sx = ax[t], sy = ay[t], sz = az[t];
+        for (int j = jBegin; j < jEnd; ++j) {
+            float dx = x[j] - xi[t], dy = y[j] - yi[t], dz = z[j] - zi[t];
+            float r = dx * dx + dy * dy + dz * dz + softening2;
+            // Without softening a target is at distance 0 from itself, r is 0 and its own pull is skipped.
+            float s = (r > 0.0f) ? 1.0f / std::sqrt(r) : 0.0f;
+            float f = m[j] * s * s * s;
+            sx += dx * f;
+            sy += dy * f;
+            sz += dz * f;
+        }
+        ax[t] = sx, ay[t] = sy, az[t] = sz;
+    }
+}
@@ -0,0 +1,138 @@
+/** @file NBody.hpp
+ *  @brief Class definition for an all-pairs N-body gravity simulation with a SIMD kernel.
+ *
+ *  @details Every body attracts every other body. The positions and masses are packed into
+ *  separate x, y, z and mass arrays (structure of arrays) and the accelerations are summed by a
+ *  tiled kernel: the target bodies of a tile stay in registers, 2 vectors at a time, while the
+ *  source bodies of an L1 sized block are broadcast one at a time. The inverse distance comes from the hardware
+ *  reciprocal square root refined by one Newton step, and a softening length keeps close
+ *  encounters finite. The targets are split across a pool of threads that lives as long as the simulation.
+ *  The kernel is picked when NBody.cpp is compiled: AVX-512 when built with it (e.g. -march=native),
+ *  else AVX2 with FMA, else a scalar loop. Nothing in this header depends on it. In deterministic mode the scalar loop always runs,
+ *  with an exact square root, so the accelerations are the same for every build and thread count.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef NBODY_H
+#define NBODY_H
+
+#include <vector>
+
+#include "Physics.hpp"
+#include "ThreadPool.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Number of source bodies per block, 4 arrays of 2048 floats fill 32 KB of L1.
+const int NBODY_BLOCK_SIZE = 2048;
+
+//! Number of target bodies per tile, 2 AVX-512 registers. The same for every build, the SIMD width
+//! is only known inside NBody.cpp, so code built with other flags agrees with the engine on it.
+const int NBODY_TILE = 32;
+
+/** @class NBodyPhysx
+ *  @brief Handles the Physics for an N-body simulation where all bodies attract each other.
+ *  @details Gravity is scaled like SolarSystemPhysx, a = m / r^2 with G = 1. The bodies are advanced
+ *  with the selected integrator, so every force evaluation of the integrator runs the kernel.
+ */
+class NBodyPhysx : public Physx {
+   public:
+    //! Softening length, the force between two bodies is m / (r^2 + softening^2).
+    float softening;
+    //! Number of threads the kernel is split across.
+    int numThreads;
+
+    /**
+	 * @brief Construct a new NBodyPhysx
+	 *
+	 * @param softening Softening length.
+	 * @param numThreads Number of threads, 0 for one per core.
+	 */
+    NBodyPhysx(float softening = 0.05f, int numThreads = 0);
+
+    virtual PhysxEngine getEngine() const {
+        return NBODY_ENGINE;
+    }
+
+    /**
+	 * @brief Name of the kernel compiled in.
+	 *
+	 * @return const char*
+	 */
+    static const char* kernelName();
+
+    virtual void computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations);
+
+    /**
+	 * @brief Sum the accelerations of the targets [begin, end) from all n sources.
+	 *
+	 * @details All arrays hold at least n floats, n and begin are multiples of NBODY_TILE.
+	 *
+	 * @param x Source and target x positions.
+	 * @param y
+	 * @param z
+	 * @param m Source masses.
+	 * @param n Number of bodies.
+	 * @param softening2 Softening length squared.
+	 * @param ax Output x accelerations.
+	 * @param ay
+	 * @param az
+	 * @param begin First target.
+	 * @param end One past the last target.
+	 * @param exact Use accelerationTileExact() instead of the SIMD kernel.
+	 */
+    static void accelerationKernel(const float* x, const float* y, const float* z, const float* m, int n, float softening2,
+                                   float* ax, float* ay, float* az, int begin, int end, bool exact = false);
+
+    virtual void step(float dt);
+
+   private:
+    //! Positions, masses and accelerations of the bodies as separate padded arrays.
+    std::vector<float> x, y, z, m, ax, ay, az;
+    //! Workers the targets are split across, kept from one force evaluation to the next.
+    ThreadPool pool;
+
+    /**
+	 * @brief Run the kernel over n padded bodies, split across the threads by whole tiles.
+	 */
+    void computeSoA(int n);
+
+   public:
+    /**
+	 * @brief Add the pull of the sources [jBegin, jEnd) to a tile of NBODY_TILE targets.
+	 * @details A body may be among its own sources. With softening its pull on itself is 0 since
+	 * dx, dy and dz are, and without softening r is 0 and the source is skipped, as FMMPhysx relies on.
+	 *
+	 * @param xi Target x positions, NBODY_TILE floats.
+	 * @param yi
+	 * @param zi
+	 * @param x Source x positions.
+	 * @param y
+	 * @param z
+	 * @param m Source masses.
+	 * @param jBegin First source.
+	 * @param jEnd One past the last source.
+	 * @param softening2 Softening length squared.
+	 * @param ax Target x accelerations, NBODY_TILE floats added to.
+	 * @param ay
+	 * @param az
+	 */
+    static void accelerationTile(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                 int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az);
+
+    /**
+	 * @brief accelerationTile() with plain float operations in a fixed order and an exact square root.
+	 * @details Every target sums its sources one after the other, from jBegin up. Built with
+	 * -ffp-contract=off this gives the same bits on every CPU.
+	 */
+    static void accelerationTileExact(const float* xi, const float* yi, const float* zi, const float* x, const float* y, const float* z, const float* m,
+                                      int jBegin, int jEnd, float softening2, float* ax, float* ay, float* az);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
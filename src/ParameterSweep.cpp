@@ -0,0 +1,153 @@
+/** @file ParameterSweep.cpp
+ *  @brief Implementation of the parameter sweep, see ParameterSweep.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "ParameterSweep.hpp"
+
+ParameterSweep::ParameterSweep(int numSteps, float dt, int numThreads) {
+    this->numSteps = numSteps;
+    this->dt = dt;
+    this->numThreads = (numThreads > 0) ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ParameterSweep::addGrid(const std::vector<unsigned>& seeds, const std::vector<int>& sphereCounts, const std::vector<float>& massScales, const std::vector<float>& airViscosities) {
+    for (int numSpheres : sphereCounts) {
+        for (float massScale : massScales) {
+            for (float airViscosity : airViscosities) {
+                for (unsigned seed : seeds) {
+                    this->add({seed, numSpheres, massScale, airViscosity});
+                }
+            }
+        }
+    }
+}
+
+void ParameterSweep::run(bool progress) {
+    int count = this->worlds.size();
+    this->results.assign(count, SweepResult());
+    std::atomic<int> next(0), finished(0);
+
+    auto worker = [&]() {
+        Arena arena;
+        for (int w = next++; w < count; w = next++) {
+            this->results[w] = this->runWorld(this->worlds[w], arena);
+            arena.reset();
+            int done = ++finished;
+            if (progress && (done % 100 == 0 || done == count)) {
+                std::printf("\r%d / %d worlds", done, count);
+                std::fflush(stdout);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < std::min(this->numThreads, count); ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    if (progress && count > 0) {
+        std::printf("\n");
+    }
+}
+
+bool ParameterSweep::writeCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        std::cout << "SWEEP::ERROR::Could not open " << path << " for writing." << std::endl;
+        return false;
+    }
+    std::fprintf(file, "seed,spheres,mass_scale,air_viscosity,steps,kinetic_energy,mean_height,max_height,sleeping,escaped,contacts,state_hash,ms\n");
+    for (const SweepResult& r : this->results) {
+        std::fprintf(file, "%u,%d,%g,%g,%d,%.6g,%.6g,%.6g,%d,%d,%d,%016" PRIx64 ",%.3f\n", r.parameters.seed, r.parameters.numSpheres,
+                     r.parameters.massScale, r.parameters.airViscosity, this->numSteps, r.kineticEnergy, r.meanHeight, r.maxHeight,
+                     r.sleeping, r.escaped, r.contacts, r.stateHash, r.milliseconds);
+    }
+    std::fclose(file);
+    return true;
+}
+
+SweepResult ParameterSweep::runWorld(const SweepParameters& parameters, Arena& arena) const {
+    auto start = std::chrono::steady_clock::now();
+    // Each world draws from its own generator, rand() is shared between the threads.
+    std::minstd_rand random(parameters.seed + 1);
+    auto uniform = [&random]() {
+        return (1.0f * (random() - std::minstd_rand::min())) / (std::minstd_rand::max() - std::minstd_rand::min());
+    };
+
+    CollisionPhysx physx;
+    physx.enableDeterministic();
+
+    const float rotations[5][3] = {{0, 0, 0}, {90, 0, 0}, {0, 0, 90}, {0, 0, -90}, {-90, 0, 0}};
+    const float translations[5][3] = {{0, -12, 0}, {0, 0, -this->boxSize}, {-this->boxSize, 0, 0}, {this->boxSize, 0, 0}, {0, 0, this->boxSize}};
+    for (int p = 0; p < 5; ++p) {
+        Plane* plane = arenaNew<Plane>(arena, 10u, COUNT_ONLY);
+        for (int i = 0; i < 3; ++i) {
+            plane->_translation[i] = translations[p][i];
+            plane->_rotation[i] = rotations[p][i];
+        }
+        plane->updateTransforms();
+        physx.addObject(arenaNew<PhysxObject>(arena, PLANE, plane, 2.0f, glm::vec3(0.0f)));
+    }
+
+    for (int i = 0; i < parameters.numSpheres; ++i) {
+        Sphere* sphere = arenaNew<Sphere>(arena, ((uniform() + 0.5f) * 5.0f) / 2.0f, 4u, COUNT_ONLY);
+        for (int j = 0; j < 3; ++j) {
+            sphere->_translation[j] = uniform() * 30.0f;
+        }
+        sphere->updateTransforms();
+        float mass = parameters.massScale * ((uniform() + 1.0f) * 10.0f) * glm::pow(sphere->radius, 3);
+        glm::vec3 velocity;
+        for (int j = 0; j < 3; ++j) {
+            velocity[j] = (uniform() - 0.5f) * 10.0f;
+        }
+        PhysxObject* body = arenaNew<PhysxObject>(arena, SPHERE, sphere, mass, velocity);
+        body->enableGravity();
+        if (parameters.airViscosity > 0.0f) {
+            body->enableAirResistance();
+            body->airViscosity = parameters.airViscosity;
+        }
+        physx.addObject(body);
+    }
+
+    for (int s = 0; s < this->numSteps; ++s) {
+        physx.step(this->dt);
+    }
+
+    SweepResult result = SweepResult();
+    result.parameters = parameters;
+    result.maxHeight = -1e30f;
+    int numSpheres = 0;
+    for (PhysxObject* p : physx.getObjects()) {
+        if (p->shape != SPHERE) {
+            continue;
+        }
+        glm::vec3 position = p->model->worldPosition;
+        result.kineticEnergy += 0.5f * p->mass * glm::dot(p->velocity, p->velocity);
+        result.meanHeight += position.y;
+        result.maxHeight = std::max(result.maxHeight, position.y);
+        result.sleeping += p->sleeping ? 1 : 0;
+        result.escaped += (std::abs(position.x) > this->boxSize || std::abs(position.z) > this->boxSize || position.y < -12.0f) ? 1 : 0;
+        ++numSpheres;
+    }
+    result.meanHeight = (numSpheres > 0) ? result.meanHeight / numSpheres : 0.0f;
+    result.maxHeight = (numSpheres > 0) ? result.maxHeight : 0.0f;
+    result.contacts = physx.getContactCount();
+    result.stateHash = SimulationHistory(&physx).stateHash();
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
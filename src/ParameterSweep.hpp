@@ -0,0 +1,153 @@
+/** @file ParameterSweep.hpp
+ *  @brief Class definition for running many variants of the collision scene across all cores.
+ *
+ *  @details Every variant is an independent headless CollisionPhysx world built like the box of
+ *  main.cpp, from its own seed, sphere count, mass scale and air viscosity. Worker threads take
+ *  the next world from a shared counter, so long worlds do not hold the others back. Every worker
+ *  creates the Plane, Sphere and PhysxObject shells of its worlds in its own Arena and resets it
+ *  once a world is done. Only the shells come from the arena: the meshes the models generate, their
+ *  vertex and index vectors and the containers of CollisionPhysx still use the global heap.
+ *  Worlds run in deterministic mode, so a row of the summary can be reproduced from its seed.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <glm/glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Model.hpp"
+#include "Physics.hpp"
+#include "Snapshot.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct SweepParameters
+ * @brief The parameters one world of a sweep differs in.
+ */
+typedef struct SweepParameters {
+    //! Seed of the sizes, positions, masses and velocities of the spheres.
+    unsigned seed;
+    //! Number of spheres, NUM_SPHERES in main.cpp.
+    int numSpheres;
+    //! Factor on the masses main.cpp gives the spheres.
+    float massScale;
+    //! Viscosity of the air, see PhysxObject::airViscosity. 0 disables air resistance.
+    float airViscosity;
+} SweepParameters;
+
+/**
+ * @struct SweepResult
+ * @brief State of a world of a sweep after its last step.
+ */
+typedef struct SweepResult {
+    SweepParameters parameters;
+    //! Total kinetic energy of the spheres.
+    float kineticEnergy;
+    //! Mean and largest height of the sphere centres.
+    float meanHeight;
+    float maxHeight;
+    //! Number of spheres at rest.
+    int sleeping;
+    //! Number of spheres that left the box.
+    int escaped;
+    //! Number of contacts found in the last step.
+    int contacts;
+    //! Hash of the final state, see SimulationHistory::stateHash().
+    std::uint64_t stateHash;
+    //! Wall clock time the world took to build and simulate.
+    double milliseconds;
+} SweepResult;
+
+/** @class ParameterSweep
+ *  @brief Runs a list of collision worlds on a pool of threads and collects a summary of each.
+ */
+class ParameterSweep {
+   public:
+    //! Number of worker threads.
+    int numThreads;
+    //! Number of steps and the time step every world is simulated with.
+    int numSteps;
+    float dt;
+    //! Half the size of the box the spheres are dropped in.
+    float boxSize = 50.0f;
+
+    /**
+	 * @brief Construct a new ParameterSweep
+	 *
+	 * @param numSteps
+	 * @param dt
+	 * @param numThreads Number of threads, 0 for one per core.
+	 */
+    ParameterSweep(int numSteps = 300, float dt = 0.01f, int numThreads = 0);
+
+    /**
+	 * @brief Add a world to the sweep.
+	 *
+	 * @param parameters
+	 */
+    void add(const SweepParameters& parameters) {
+        this->worlds.push_back(parameters);
+    }
+
+    /**
+	 * @brief Add a world for every combination of the given values.
+	 */
+    void addGrid(const std::vector<unsigned>& seeds, const std::vector<int>& sphereCounts, const std::vector<float>& massScales, const std::vector<float>& airViscosities);
+
+    /**
+	 * @brief Get the number of worlds in the sweep.
+	 *
+	 * @return int
+	 */
+    int getWorldCount() const {
+        return this->worlds.size();
+    }
+
+    /**
+	 * @brief Simulate every world. Results are kept in the order the worlds were added.
+	 *
+	 * @param progress Print the number of finished worlds while running.
+	 */
+    void run(bool progress = false);
+
+    /**
+	 * @brief Get the results of the last run, one per world in the order they were added.
+	 *
+	 * @return const std::vector<SweepResult>&
+	 */
+    const std::vector<SweepResult>& getResults() const {
+        return this->results;
+    }
+
+    /**
+	 * @brief Write the results of the last run as CSV, one row per world.
+	 *
+	 * @param path
+	 * @return true If the file was written.
+	 */
+    bool writeCSV(const std::string& path) const;
+
+   private:
+    std::vector<SweepParameters> worlds;
+    std::vector<SweepResult> results;
+
+    /**
+	 * @brief Build one world, with its model and body shells in the arena, simulate it and summarise its final state.
+	 */
+    SweepResult runWorld(const SweepParameters& parameters, Arena& arena) const;
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,1270 @@
+/** @file Physics.cpp
+ *  @brief Implementation of the physics objects, the shared integrators and the solar system and collision simulations, see Physics.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ *  @author G Sathyaram (wreck-count)
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Physics.hpp"
+
+PhysxObject::PhysxObject(PhysxShape shape, Model* model, float mass, glm::vec3 initVelocity) {
+    this->shape = shape;
+    this->model = model;
+    this->mass = mass;
+    this->velocity = glm::vec3(initVelocity);
+    this->force = this->mass * glm::vec3(0.0f);
+    this->gravityEnabled = false;
+    this->airResistanceEnabled = false;
+}
+
+void PhysxObject::wake() {
+    this->sleeping = false;
+    this->sleepTimer = 0.0f;
+}
+
+void PhysxObject::recomputeTotalForce() {
+    this->force = this->mass * glm::vec3(0.0f);
+
+    if (gravityEnabled) {
+        this->force += this->mass * glm::vec3(0, -g, 0);
+    }
+
+    if (airResistanceEnabled) {
+        if (this->shape == PhysxShape::SPHERE) {
+            Sphere* s = static_cast<Sphere*>(this->model);
+            this->force -= this->mass * (6.0f * 3.1415f * this->airViscosity * s->radius) * this->velocity;
+        }
+    }
+}
+
+void Physx::addObject(PhysxObject* object) {
+    this->beginObjectsChange();
+    object->id = this->objects.size();
+    this->objects.push_back(object);
+    this->previousIds.push_back(NEW_OBJECT);
+}
+
+bool Physx::removeObject(PhysxObject* object) {
+    if (object->id >= this->objects.size() || this->objects[object->id] != object) {
+        return false;
+    }
+    this->detachObject(object->id);
+    return true;
+}
+
+BodyHandle Physx::createBody(PhysxShape shape, Model* model, float mass, glm::vec3 initVelocity) {
+    const PhysxObject* before = this->bodies.data();
+    BodyHandle handle = this->bodies.insert(shape, model, mass, initVelocity);
+    if (this->bodies.data() != before) {
+        // The array has moved, point the objects at the new places of the bodies added before.
+        for (std::size_t b = 0; b + 1 < this->bodies.size(); ++b) {
+            this->objects[this->bodies[b].id] = &this->bodies[b];
+        }
+    }
+    this->addObject(this->bodies.get(handle));
+    return handle;
+}
+
+bool Physx::removeBody(BodyHandle handle) {
+    PhysxObject* body = this->bodies.get(handle);
+    if (body == nullptr) {
+        return false;
+    }
+    this->detachObject(body->id);
+    std::size_t position = this->bodies.erase(handle);
+    if (position < this->bodies.size()) {
+        this->objects[this->bodies[position].id] = &this->bodies[position];
+    }
+    return true;
+}
+
+BodyHandle Physx::getHandle(const PhysxObject* object) const {
+    std::ptrdiff_t position = object - this->bodies.data();
+    if (this->bodies.empty() || position < 0 || position >= (std::ptrdiff_t)this->bodies.size()) {
+        return BodyHandle();
+    }
+    return this->bodies.handleAt(position);
+}
+
+void Physx::computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations) {
+    int numObjects = this->objects.size();
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        glm::vec3 a = glm::vec3(0.0f);
+        if (p->gravityEnabled) {
+            a += glm::vec3(0, -g, 0);
+        }
+        if (p->airResistanceEnabled && p->shape == PhysxShape::SPHERE) {
+            a -= (6.0f * 3.1415f * p->airViscosity * static_cast<Sphere*>(p->model)->radius) * velocities[i];
+        }
+        accelerations[i] = a;
+    }
+}
+
+void Physx::updateObjects() {
+    if (!this->objectsChanged) {
+        return;
+    }
+    this->newIds.assign(this->syncedCount, -1);
+    for (std::size_t i = 0; i < this->objects.size(); ++i) {
+        if (this->previousIds[i] != NEW_OBJECT) {
+            this->newIds[this->previousIds[i]] = i;
+        }
+    }
+    this->objectsChanged = false;
+    this->previousIds.clear();
+    this->syncedCount = this->objects.size();
+    this->onObjectsChanged(this->newIds);
+}
+
+void Physx::beginObjectsChange() {
+    if (!this->objectsChanged) {
+        this->previousIds.resize(this->objects.size());
+        for (std::size_t i = 0; i < this->objects.size(); ++i) {
+            this->previousIds[i] = i;
+        }
+        this->objectsChanged = true;
+    }
+    ++this->objectsVersion;
+}
+
+void Physx::detachObject(unsigned id) {
+    this->beginObjectsChange();
+    std::size_t last = this->objects.size() - 1;
+    this->objects[id] = this->objects[last];
+    this->objects[id]->id = id;
+    this->previousIds[id] = this->previousIds[last];
+    this->objects.pop_back();
+    this->previousIds.pop_back();
+}
+
+void Physx::integrate(float dt) {
+    int numObjects = this->objects.size();
+    this->positions.resize(numObjects);
+    this->velocities.resize(numObjects);
+    this->accelerations.resize(numObjects);
+    for (int i = 0; i < numObjects; ++i) {
+        this->positions[i] = this->objects[i]->model->worldPosition;
+        this->velocities[i] = this->objects[i]->velocity;
+    }
+
+    std::vector<glm::vec3>& x = this->positions;
+    std::vector<glm::vec3>& v = this->velocities;
+    std::vector<glm::vec3>& a = this->accelerations;
+    switch (this->integrator) {
+        case EXPLICIT_EULER:
+            this->computeAccelerations(x, v, a);
+            for (int i = 0; i < numObjects; ++i) {
+                x[i] += v[i] * dt;
+                v[i] += a[i] * dt;
+            }
+            break;
+
+        case SEMI_IMPLICIT_EULER:
+            this->computeAccelerations(x, v, a);
+            for (int i = 0; i < numObjects; ++i) {
+                v[i] += a[i] * dt;
+                x[i] += v[i] * dt;
+            }
+            break;
+
+        case LEAPFROG:
+            this->leapfrog(dt, 0.5f, 1.0f, 0.5f);
+            break;
+
+        case YOSHIDA4: {
+            // w1 = 1 / (2 - 2^(1/3)), w0 = -2^(1/3) / (2 - 2^(1/3))
+            const float w1 = 1.35120719195965763f;
+            const float w0 = -1.70241438391931527f;
+            this->leapfrog(w1 * dt, 0.5f, 1.0f, 0.0f);
+            this->leapfrog(w0 * dt, 0.5f * (w0 + w1) / w0, 1.0f, 0.0f);
+            this->leapfrog(w1 * dt, 0.5f * (w0 + w1) / w1, 1.0f, 0.5f);
+            break;
+        }
+
+        case RK4:
+            this->rungeKutta4(dt);
+            break;
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        this->objects[i]->model->worldPosition = x[i];
+        this->objects[i]->velocity = v[i];
+    }
+}
+
+void Physx::leapfrog(float dt, float before, float kick, float after) {
+    int numObjects = this->objects.size();
+    for (int i = 0; i < numObjects; ++i) {
+        this->positions[i] += this->velocities[i] * (before * dt);
+    }
+    this->computeAccelerations(this->positions, this->velocities, this->accelerations);
+    for (int i = 0; i < numObjects; ++i) {
+        this->velocities[i] += this->accelerations[i] * (kick * dt);
+        this->positions[i] += this->velocities[i] * (after * dt);
+    }
+}
+
+void Physx::rungeKutta4(float dt) {
+    int numObjects = this->objects.size();
+    std::vector<glm::vec3>& x = this->positions;
+    std::vector<glm::vec3>& v = this->velocities;
+    std::vector<glm::vec3>& a = this->accelerations;
+    this->k1x.resize(numObjects);
+    this->k1v.resize(numObjects);
+    this->k2x.resize(numObjects);
+    this->k2v.resize(numObjects);
+    this->k3x.resize(numObjects);
+    this->k3v.resize(numObjects);
+
+    // k1x, k1v hold the stage derivative sums, k2x, k2v the stage state and k3x, k3v the stage derivatives.
+    this->computeAccelerations(x, v, a);
+    for (int i = 0; i < numObjects; ++i) {
+        this->k1x[i] = v[i];
+        this->k1v[i] = a[i];
+        this->k2x[i] = x[i] + v[i] * (0.5f * dt);
+        this->k2v[i] = v[i] + a[i] * (0.5f * dt);
+    }
+
+    const float stageWeights[3] = {2.0f, 2.0f, 1.0f};
+    const float nextStep[3] = {0.5f, 1.0f, 0.0f};
+    for (int stage = 0; stage < 3; ++stage) {
+        this->computeAccelerations(this->k2x, this->k2v, this->k3v);
+        for (int i = 0; i < numObjects; ++i) {
+            this->k3x[i] = this->k2v[i];
+            this->k1x[i] += stageWeights[stage] * this->k3x[i];
+            this->k1v[i] += stageWeights[stage] * this->k3v[i];
+            this->k2x[i] = x[i] + this->k3x[i] * (nextStep[stage] * dt);
+            this->k2v[i] = v[i] + this->k3v[i] * (nextStep[stage] * dt);
+        }
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        x[i] += this->k1x[i] * (dt / 6.0f);
+        v[i] += this->k1v[i] * (dt / 6.0f);
+    }
+}
+
+void SolarSystemPhysx::enableAdaptiveTimeStep(float accuracy, int maxLevel) {
+    this->adaptiveTimeStep = true;
+    this->timeStepAccuracy = accuracy;
+    this->maxTimeStepLevel = maxLevel;
+}
+
+void SolarSystemPhysx::computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations) {
+    int numObjects = this->objects.size();
+    float sunMass = this->objects[0]->mass;
+    accelerations[0] = glm::vec3(0.0f);
+    for (int i = 1; i < numObjects; ++i) {
+        glm::vec3 r = positions[0] - positions[i];
+        float distance2 = glm::dot(r, r);
+        accelerations[i] = r * (sunMass / (distance2 * glm::sqrt(distance2)));
+    }
+}
+
+void SolarSystemPhysx::step(float dt) {
+    this->updateObjects();
+    int numObjects = this->objects.size();
+    if (this->adaptiveTimeStep) {
+        this->stepAdaptive(dt);
+    } else {
+        // The sun is held in place whatever velocity it was given.
+        glm::vec3 sunVelocity = this->objects[0]->velocity;
+        this->objects[0]->velocity = glm::vec3(0.0f);
+        this->integrate(dt);
+        this->objects[0]->velocity = sunVelocity;
+        this->bodyUpdates += numObjects - 1;
+    }
+    for (int i = 1; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        p->model->_translation[0] = p->model->worldPosition.x;
+        p->model->_translation[1] = p->model->worldPosition.y;
+        p->model->_translation[2] = p->model->worldPosition.z;
+        p->model->updateTransforms();
+    }
+}
+
+glm::vec3 SolarSystemPhysx::sunAcceleration(glm::vec3 position, glm::vec3 velocity, glm::vec3& jerk) {
+    PhysxObject* sun = this->objects[0];
+    glm::vec3 r = sun->model->worldPosition - position;
+    glm::vec3 v = -velocity;
+    float distance2 = glm::dot(r, r);
+    float inverseDistance3 = 1.0f / (distance2 * glm::sqrt(distance2));
+    jerk = sun->mass * inverseDistance3 * (v - (3.0f * glm::dot(r, v) / distance2) * r);
+    return r * (sun->mass * inverseDistance3);
+}
+
+int SolarSystemPhysx::chooseLevel(glm::vec3 acceleration, glm::vec3 jerk, float dt) {
+    float j = glm::length(jerk);
+    if (j == 0.0f) {
+        return 0;
+    }
+    float h = this->timeStepAccuracy * glm::length(acceleration) / j;
+    int level = 0;
+    while (level < this->maxTimeStepLevel && dt / (1 << level) > h) {
+        ++level;
+    }
+    return level;
+}
+
+void SolarSystemPhysx::stepAdaptive(float dt) {
+    int numObjects = this->objects.size();
+    this->levels.assign(numObjects, 0);
+    this->blockAccelerations.resize(numObjects);
+    this->nextTicks.assign(numObjects, 0);
+    this->elapsedTimes.assign(numObjects, 0.0);
+    for (int i = 1; i < numObjects; ++i) {
+        glm::vec3 jerk;
+        this->blockAccelerations[i] = this->sunAcceleration(this->objects[i]->model->worldPosition, this->objects[i]->velocity, jerk);
+        this->levels[i] = this->chooseLevel(this->blockAccelerations[i], jerk, dt);
+    }
+
+    const int ticks = 1 << this->maxTimeStepLevel;
+    for (int tick = 0; tick < ticks;) {
+        int nextTick = ticks;
+        for (int i = 1; i < numObjects; ++i) {
+            if (this->nextTicks[i] == tick) {
+                PhysxObject* p = this->objects[i];
+                float h = dt / (1 << this->levels[i]);
+                p->velocity += this->blockAccelerations[i] * (0.5f * h);
+                p->model->worldPosition += p->velocity * h;
+                glm::vec3 jerk;
+                this->blockAccelerations[i] = this->sunAcceleration(p->model->worldPosition, p->velocity, jerk);
+                p->velocity += this->blockAccelerations[i] * (0.5f * h);
+                this->elapsedTimes[i] += h;
+                this->nextTicks[i] = tick + (ticks >> this->levels[i]);
+                ++this->bodyUpdates;
+
+                // The planet is now at the end of its sub-step, where every finer sub-step starts.
+                int level = this->chooseLevel(this->blockAccelerations[i], jerk, dt);
+                if (level < this->levels[i]) {
+                    int coarser = this->levels[i] - 1;
+                    level = (this->nextTicks[i] % (ticks >> coarser) == 0) ? coarser : this->levels[i];
+                }
+                this->levels[i] = level;
+            }
+            nextTick = std::min(nextTick, this->nextTicks[i]);
+        }
+        tick = nextTick;
+    }
+}
+
+CollisionPhysx::CollisionPhysx() {
+    for (int a = 0; a < NUM_PHYSX_SHAPES; ++a) {
+        for (int b = 0; b < NUM_PHYSX_SHAPES; ++b) {
+            this->kernels[a][b] = nullptr;
+        }
+    }
+    this->setKernel(SPHERE, SPHERE, &CollisionPhysx::collideSpheres);
+    this->setKernel(SPHERE, PLANE, &CollisionPhysx::collideSpherePlanes);
+    this->setKernel(SPHERE, BOX, &CollisionPhysx::collideSphereBoxes);
+    this->setKernel(SPHERE, CAPSULE, &CollisionPhysx::collideSphereCapsules);
+    this->setKernel(SPHERE, TRIANGLE_MESH, &CollisionPhysx::collideSphereMeshes);
+
+    this->distances[PLANE] = &CollisionPhysx::distanceToPlane;
+    this->distances[SPHERE] = &CollisionPhysx::distanceToSphere;
+    this->distances[BOX] = &CollisionPhysx::distanceToBox;
+    this->distances[CAPSULE] = &CollisionPhysx::distanceToCapsule;
+    this->distances[TRIANGLE_MESH] = &CollisionPhysx::distanceToMesh;
+}
+
+void CollisionPhysx::enableSleeping(float velocity, float time) {
+    this->sleepingEnabled = true;
+    this->sleepVelocity = velocity;
+    this->sleepTime = time;
+}
+
+void CollisionPhysx::enableContactSolver(int iterations) {
+    this->contactSolver = true;
+    this->solverIterations = iterations;
+}
+
+void CollisionPhysx::step(float dt) {
+    this->updateObjects();
+    this->stepArena.reset();
+    this->contacts = nullptr;
+    this->numContacts = 0;
+    this->contactCache.beginStep();
+    if (this->sleepingEnabled) {
+        this->wakeMovedObjects();
+    }
+
+    if (this->contactSolver) {
+        this->stepSolver(dt);
+    } else if (this->continuousCollision) {
+        this->stepContinuous(dt);
+    } else {
+        this->stepDiscrete(dt);
+    }
+
+    // Contacts between bodies that are not simulated, e.g. within a sleeping island, are kept as they were.
+    this->contactCache.endStep([this](const ContactPoint& c) {
+        return !this->objects[c.one]->isAwake() && !this->objects[c.two]->isAwake();
+    });
+
+    if (this->sleepingEnabled) {
+        this->updateSleeping(dt);
+    } else {
+        this->activeCount = 0;
+        for (PhysxObject* p : this->objects) {
+            this->activeCount += (p->shape == PhysxShape::SPHERE) ? 1 : 0;
+        }
+    }
+}
+
+void CollisionPhysx::stepDiscrete(float dt) {
+    int numObjects = this->objects.size();
+    // Resolving a hit only changes velocities, so all overlaps can be found from the positions up front.
+    this->findHits(false, dt);
+    for (const ShapeHit& hit : this->sphereHits) {
+        PhysxObject* p = this->objects[hit.sphere];
+        PhysxObject* q = this->objects[hit.other];
+        // The hits resolved before may have turned the pair apart already.
+        if (glm::dot(q->model->worldPosition - p->model->worldPosition, p->velocity) >= 0) {
+            this->resolveCollision(p, q, hit.normal, hit.depth);
+        }
+    }
+    for (const ShapeHit& hit : this->staticHits) {
+        if (this->objects[hit.sphere]->isAwake()) {
+            this->resolveCollision(this->objects[hit.sphere], this->objects[hit.other], hit.normal, hit.depth);
+        }
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = objects[i];
+        if (p->isAwake()) {
+            if (p->gravityEnabled || p->airResistanceEnabled) {
+                // Moved once with the old and once with the new velocity, the model is updated after the second move.
+                p->model->worldPosition += p->velocity * dt;
+                p->recomputeTotalForce();
+                p->velocity += (p->force / p->mass) * dt;
+            }
+            this->stepSphere(p, dt);
+        }
+    }
+}
+
+void CollisionPhysx::stepSolver(float dt) {
+    int numObjects = this->objects.size();
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->isAwake() && (p->gravityEnabled || p->airResistanceEnabled)) {
+            p->recomputeTotalForce();
+            p->velocity += (p->force / p->mass) * dt;
+        }
+    }
+
+    this->findHits(true, dt);
+    // Every hit makes at most one contact.
+    std::size_t maxContacts = this->sphereHits.size() + this->staticHits.size();
+    this->contacts = static_cast<Contact*>(this->stepArena.allocate(maxContacts * sizeof(Contact), alignof(Contact)));
+    for (const ShapeHit& hit : this->sphereHits) {
+        this->addContact(this->objects[hit.sphere], this->objects[hit.other], hit.normal, hit.depth, dt);
+    }
+    // After the sphere pairs, so spheres they woke up meet the static bodies too.
+    for (const ShapeHit& hit : this->staticHits) {
+        if (this->objects[hit.sphere]->isAwake()) {
+            this->addContact(this->objects[hit.sphere], this->objects[hit.other], hit.normal, hit.depth, dt);
+        }
+    }
+
+    // The restitution targets use the approach velocities from before any impulse is applied.
+    Contact* begin = this->contacts;
+    Contact* end = this->contacts + this->numContacts;
+    for (Contact* c = begin; c != end; ++c) {
+        this->prepareContact(*c, dt);
+    }
+    for (Contact* c = begin; c != end; ++c) {
+        this->warmStartContact(*c);
+    }
+    for (int iteration = 0; iteration < this->solverIterations; ++iteration) {
+        for (Contact* c = begin; c != end; ++c) {
+            this->solveContact(*c);
+        }
+    }
+
+    for (Contact* c = begin; c != end; ++c) {
+        c->cached->normalImpulse = c->normalImpulse;
+        c->cached->frictionImpulse = c->frictionImpulse;
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->isAwake()) {
+            this->stepSphere(p, dt);
+        }
+    }
+}
+
+void CollisionPhysx::stepContinuous(float dt) {
+    this->updateColliders();
+    int numObjects = this->objects.size();
+    int numSpheres = 0;
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->isAwake()) {
+            ++numSpheres;
+            if (p->gravityEnabled || p->airResistanceEnabled) {
+                p->recomputeTotalForce();
+                p->velocity += (p->force / p->mass) * dt;
+            }
+        }
+    }
+
+    this->localTime.assign(numObjects, 0.0f);
+    this->version.assign(numObjects, 0u);
+    this->impacts.clear();
+    for (int i = 0; i < numObjects; ++i) {
+        this->predictImpacts(i, i, 0.0f, dt);
+    }
+
+    int maxImpacts = this->maxImpactsPerBody * numSpheres;
+    for (int count = 0; count < maxImpacts && !this->impacts.empty();) {
+        std::pop_heap(this->impacts.begin(), this->impacts.end(), std::greater<ImpactEvent>());
+        ImpactEvent impact = this->impacts.back();
+        this->impacts.pop_back();
+        if (impact.versionOne != this->version[impact.one] || impact.versionTwo != this->version[impact.two]) {
+            continue;
+        }
+
+        this->advanceTo(impact.one, impact.time);
+        this->advanceTo(impact.two, impact.time);
+        int sphere = (this->objects[impact.one]->shape == SPHERE) ? impact.one : impact.two;
+        int other = (sphere == impact.one) ? impact.two : impact.one;
+        glm::vec3 normal;
+        float distance = (this->*this->distances[this->objects[other]->shape])(other, this->objects[sphere]->model->worldPosition, normal);
+        this->resolveCollision(this->objects[sphere], this->objects[other], normal, static_cast<Sphere*>(this->objects[sphere]->model)->radius - distance);
+        ++this->version[impact.one];
+        ++this->version[impact.two];
+        this->predictImpacts(impact.one, numObjects, impact.time, dt);
+        this->predictImpacts(impact.two, numObjects, impact.time, dt);
+        ++count;
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        if (this->objects[i]->isAwake()) {
+            this->advanceTo(i, dt);
+            this->stepSphere(this->objects[i], 0.0f);
+        }
+    }
+}
+
+float CollisionPhysx::sweepPlaneSphere(const Plane* plane, glm::vec3 position, glm::vec3 velocity, float radius, float maxTime) {
+    float distance = glm::dot(position - plane->worldPosition, plane->normal);
+    float speed = glm::dot(velocity, plane->normal);
+    if (distance < 0.0f) {
+        distance = -distance;
+        speed = -speed;
+    }
+    if (speed >= 0.0f) {
+        return -1.0f;
+    }
+    float t = (distance - radius) / -speed;
+    if (t < 0.0f) {
+        return 0.0f;
+    }
+    return (t <= maxTime) ? t : -1.0f;
+}
+
+float CollisionPhysx::sweepStatic(int object, glm::vec3 position, glm::vec3 velocity, float radius, float maxTime) {
+    DistanceQuery distanceTo = this->distances[this->objects[object]->shape];
+    float t = 0.0f;
+    for (int iteration = 0; iteration < 16; ++iteration) {
+        glm::vec3 normal;
+        float gap = (this->*distanceTo)(object, position + velocity * t, normal) - radius;
+        float speed = glm::dot(velocity, normal);
+        if (speed >= 0.0f) {
+            return -1.0f;
+        }
+        if (gap <= 1e-3f * radius) {
+            break;
+        }
+        t += gap / -speed;
+        if (t > maxTime) {
+            return -1.0f;
+        }
+    }
+    return t;
+}
+
+float CollisionPhysx::sweepSphereSphere(glm::vec3 positionOne, glm::vec3 velocityOne, float radiusOne, glm::vec3 positionTwo, glm::vec3 velocityTwo, float radiusTwo, float maxTime) {
+    glm::vec3 dp = positionTwo - positionOne;
+    glm::vec3 dv = velocityTwo - velocityOne;
+    float radii = radiusOne + radiusTwo;
+    float b = glm::dot(dp, dv);
+    if (b >= 0.0f) {
+        return -1.0f;
+    }
+    float c = glm::dot(dp, dp) - radii * radii;
+    if (c <= 0.0f) {
+        return 0.0f;
+    }
+    float a = glm::dot(dv, dv);
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return -1.0f;
+    }
+    float t = c / (-b + glm::sqrt(discriminant));
+    return (t <= maxTime) ? t : -1.0f;
+}
+
+glm::vec3 CollisionPhysx::positionAt(int i, float time) {
+    PhysxObject* p = this->objects[i];
+    if (p->shape != PhysxShape::SPHERE) {
+        return p->model->worldPosition;
+    }
+    return p->model->worldPosition + p->velocity * (time - this->localTime[i]);
+}
+
+void CollisionPhysx::advanceTo(int i, float time) {
+    PhysxObject* p = this->objects[i];
+    if (p->shape == PhysxShape::SPHERE) {
+        p->model->worldPosition += p->velocity * (time - this->localTime[i]);
+        this->localTime[i] = time;
+    }
+}
+
+void CollisionPhysx::predictImpacts(int i, int end, float now, float dt) {
+    PhysxObject* p = this->objects[i];
+    glm::vec3 position = this->positionAt(i, now);
+    for (int j = 0; j < end; ++j) {
+        PhysxObject* q = this->objects[j];
+        if (j == i || (!p->isAwake() && !q->isAwake())) {
+            continue;
+        }
+        float t = -1.0f;
+        if (p->shape == SPHERE and q->shape == SPHERE) {
+            t = this->sweepSphereSphere(position, p->velocity, static_cast<Sphere*>(p->model)->radius, this->positionAt(j, now), q->velocity, static_cast<Sphere*>(q->model)->radius, dt - now);
+        } else if (p->shape == SPHERE) {
+            t = this->sweepStatic(j, position, p->velocity, static_cast<Sphere*>(p->model)->radius, dt - now);
+        } else if (q->shape == SPHERE) {
+            t = this->sweepStatic(i, this->positionAt(j, now), q->velocity, static_cast<Sphere*>(q->model)->radius, dt - now);
+        }
+        if (t >= 0.0f) {
+            this->impacts.push_back({now + t, i, j, this->version[i], this->version[j]});
+            std::push_heap(this->impacts.begin(), this->impacts.end(), std::greater<ImpactEvent>());
+        }
+    }
+}
+
+void CollisionPhysx::setKernel(PhysxShape a, PhysxShape b, CollisionKernel kernel) {
+    this->kernels[a][b] = kernel;
+    this->kernels[b][a] = kernel;
+}
+
+void CollisionPhysx::updateBuckets() {
+    if (this->bucketVersion == this->objectsVersion) {
+        return;
+    }
+    for (std::vector<int>& bucket : this->buckets) {
+        bucket.clear();
+    }
+    this->bucketSlot.resize(this->objects.size());
+    for (std::size_t i = 0; i < this->objects.size(); ++i) {
+        std::vector<int>& bucket = this->buckets[this->objects[i]->shape];
+        this->bucketSlot[i] = bucket.size();
+        bucket.push_back(i);
+    }
+    this->bucketVersion = this->objectsVersion;
+
+    std::size_t numPlanes = this->buckets[PLANE].size();
+    this->planeNx.resize(numPlanes);
+    this->planeNy.resize(numPlanes);
+    this->planeNz.resize(numPlanes);
+    this->planeD.resize(numPlanes);
+    // Planes carry no version yet equal to this, so all of them are read below.
+    this->planeVersions.assign(numPlanes, ~0u);
+    this->boxes.resize(this->buckets[BOX].size());
+    this->capsules.resize(this->buckets[CAPSULE].size());
+    this->meshes.assign(this->buckets[TRIANGLE_MESH].size(), MeshCollider());
+}
+
+void CollisionPhysx::updateColliders() {
+    this->updateBuckets();
+
+    for (std::size_t k = 0; k < this->buckets[PLANE].size(); ++k) {
+        Plane* plane = static_cast<Plane*>(this->objects[this->buckets[PLANE][k]]->model);
+        if (plane->version != this->planeVersions[k]) {
+            this->planeNx[k] = plane->normal.x;
+            this->planeNy[k] = plane->normal.y;
+            this->planeNz[k] = plane->normal.z;
+            this->planeD[k] = plane->Odist;
+            this->planeVersions[k] = plane->version;
+        }
+    }
+
+    for (std::size_t k = 0; k < this->buckets[BOX].size(); ++k) {
+        Box* box = static_cast<Box*>(this->objects[this->buckets[BOX][k]]->model);
+        const glm::mat4& matrix = box->getModelMatrix();
+        BoxCollider& collider = this->boxes[k];
+        collider.center = glm::vec3(matrix[3]);
+        for (int axis = 0; axis < 3; ++axis) {
+            glm::vec3 column = glm::vec3(matrix[axis]);
+            float length = glm::length(column);
+            collider.axes[axis] = column / length;
+            collider.extents[axis] = box->halfSize * length;
+        }
+    }
+
+    for (std::size_t k = 0; k < this->buckets[CAPSULE].size(); ++k) {
+        Capsule* capsule = static_cast<Capsule*>(this->objects[this->buckets[CAPSULE][k]]->model);
+        const glm::mat4& matrix = capsule->getModelMatrix();
+        CapsuleCollider& collider = this->capsules[k];
+        collider.a = glm::vec3(matrix * glm::vec4(0.0f, -capsule->halfHeight, 0.0f, 1.0f));
+        collider.b = glm::vec3(matrix * glm::vec4(0.0f, capsule->halfHeight, 0.0f, 1.0f));
+        // The radius follows the scale across the axis, which is taken to be uniform.
+        collider.radius = capsule->radius * glm::length(glm::vec3(matrix[0]));
+    }
+
+    for (std::size_t k = 0; k < this->buckets[TRIANGLE_MESH].size(); ++k) {
+        Model* model = this->objects[this->buckets[TRIANGLE_MESH][k]]->model;
+        MeshCollider& collider = this->meshes[k];
+        if (!collider.built || collider.matrix != model->getModelMatrix()) {
+            this->buildMeshCollider(model, collider);
+        }
+    }
+}
+
+void CollisionPhysx::buildMeshCollider(Model* model, MeshCollider& collider) {
+    const glm::mat4& matrix = model->getModelMatrix();
+    bool missing = false;
+    std::vector<glm::vec3> corners;
+    for (const Mesh& mesh : model->meshes) {
+        if (!mesh.hasCPUData()) {
+            missing = true;
+            continue;
+        }
+        for (std::size_t i = 0; i < mesh.indices.size() / 3 * 3; ++i) {
+            corners.push_back(glm::vec3(matrix * glm::vec4(mesh.vertices[mesh.indices[i]].position, 1.0f)));
+        }
+    }
+    if (missing && !collider.built) {
+        std::cout << "PHYSX::ERROR::TRIANGLE_MESH_WITHOUT_CPU_DATA::Keep the meshes on the CPU with GPU_AND_CPU to collide with them." << std::endl;
+    }
+    collider.bvh.build(corners);
+    collider.matrix = matrix;
+    collider.built = true;
+}
+
+void CollisionPhysx::findHits(bool moving, float dt) {
+    this->updateColliders();
+    this->gatherSpheres(moving, dt);
+    this->sphereHits.clear();
+    this->staticHits.clear();
+    // Every sphere resting on the ground is the common peak, do not grow into it one hit at a time.
+    this->staticHits.reserve(this->buckets[SPHERE].size());
+    for (int a = 0; a < NUM_PHYSX_SHAPES; ++a) {
+        for (int b = a; b < NUM_PHYSX_SHAPES; ++b) {
+            CollisionKernel kernel = this->kernels[a][b];
+            if (kernel != nullptr && !this->buckets[a].empty() && !this->buckets[b].empty()) {
+                (this->*kernel)(moving, dt);
+            }
+        }
+    }
+}
+
+void CollisionPhysx::gatherSpheres(bool moving, float dt) {
+    const std::vector<int>& spheres = this->buckets[SPHERE];
+    std::size_t count = spheres.size();
+    std::size_t padded = (count + 3) / 4 * 4;
+    this->sphereX.resize(padded);
+    this->sphereY.resize(padded);
+    this->sphereZ.resize(padded);
+    this->sphereVx.resize(padded);
+    this->sphereVy.resize(padded);
+    this->sphereVz.resize(padded);
+    this->sphereRadius.resize(padded);
+    this->sphereReach.resize(padded);
+    this->sphereAwake.resize(padded);
+    this->sphereGap.resize(padded);
+    for (std::size_t s = 0; s < padded; ++s) {
+        if (s >= count) {
+            this->sphereX[s] = this->sphereY[s] = this->sphereZ[s] = 0.0f;
+            this->sphereVx[s] = this->sphereVy[s] = this->sphereVz[s] = 0.0f;
+            this->sphereRadius[s] = 0.0f;
+            this->sphereReach[s] = -1.0f;
+            this->sphereAwake[s] = 0;
+            continue;
+        }
+        PhysxObject* p = this->objects[spheres[s]];
+        float radius = static_cast<Sphere*>(p->model)->radius;
+        this->sphereX[s] = p->model->worldPosition.x;
+        this->sphereY[s] = p->model->worldPosition.y;
+        this->sphereZ[s] = p->model->worldPosition.z;
+        this->sphereVx[s] = p->velocity.x;
+        this->sphereVy[s] = p->velocity.y;
+        this->sphereVz[s] = p->velocity.z;
+        this->sphereRadius[s] = radius;
+        this->sphereReach[s] = moving ? radius + this->contactMargin + glm::length(p->velocity) * dt : radius;
+        this->sphereAwake[s] = p->isAwake() ? 1 : 0;
+    }
+}
+
+void CollisionPhysx::collideSpheres(bool moving, float dt) {
+    const std::vector<int>& spheres = this->buckets[SPHERE];
+    int count = spheres.size();
+    const float* x = this->sphereX.data();
+    const float* y = this->sphereY.data();
+    const float* z = this->sphereZ.data();
+    const float* vx = this->sphereVx.data();
+    const float* vy = this->sphereVy.data();
+    const float* vz = this->sphereVz.data();
+    const float* radius = this->sphereRadius.data();
+    const std::uint8_t* awake = this->sphereAwake.data();
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < i; ++j) {
+            if (!awake[i] && !awake[j]) {
+                continue;
+            }
+            float dx = x[i] - x[j], dy = y[i] - y[j], dz = z[i] - z[j];
+            float radii = radius[i] + radius[j];
+            float reach = radii;
+            if (moving) {
+                float dvx = vx[i] - vx[j], dvy = vy[i] - vy[j], dvz = vz[i] - vz[j];
+                reach += this->contactMargin + std::sqrt(dvx * dvx + dvy * dvy + dvz * dvz) * dt;
+            }
+            float distance2 = dx * dx + dy * dy + dz * dz;
+            if (distance2 <= reach * reach) {
+                float distance = std::sqrt(distance2);
+                glm::vec3 normal = (distance > 0.0f) ? glm::vec3(dx, dy, dz) / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+                this->sphereHits.push_back({spheres[i], spheres[j], normal, radii - distance});
+            }
+        }
+    }
+}
+
+void CollisionPhysx::collideSpherePlanes(bool moving, float dt) {
+    const std::vector<int>& spheres = this->buckets[SPHERE];
+    int padded = this->sphereX.size();
+    const float* x = this->sphereX.data();
+    const float* y = this->sphereY.data();
+    const float* z = this->sphereZ.data();
+    const float* reach = this->sphereReach.data();
+    for (std::size_t k = 0; k < this->buckets[PLANE].size(); ++k) {
+        int plane = this->buckets[PLANE][k];
+        glm::vec3 n = glm::vec3(this->planeNx[k], this->planeNy[k], this->planeNz[k]);
+#if defined(__SSE2__)
+        const __m128 nx = _mm_set1_ps(n.x), ny = _mm_set1_ps(n.y), nz = _mm_set1_ps(n.z), d = _mm_set1_ps(this->planeD[k]);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        for (int s = 0; s < padded; s += 4) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(x + s)), _mm_mul_ps(ny, _mm_loadu_ps(y + s))),
+                                         _mm_add_ps(_mm_mul_ps(nz, _mm_loadu_ps(z + s)), d));
+            int mask = _mm_movemask_ps(_mm_cmple_ps(_mm_andnot_ps(signBit, distance), _mm_loadu_ps(reach + s)));
+            if (mask != 0) {
+                float distances[4];
+                _mm_storeu_ps(distances, distance);
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (mask & (1 << lane)) {
+                        float signedDistance = distances[lane];
+                        this->staticHits.push_back({spheres[s + lane], plane, (signedDistance < 0.0f) ? -n : n, this->sphereRadius[s + lane] - std::fabs(signedDistance)});
+                    }
+                }
+            }
+        }
+#else
+        const float d = this->planeD[k];
+        for (int s = 0; s < padded; ++s) {
+            // Summed in the same order as the SIMD lanes above, so both give the same distances.
+            float signedDistance = (n.x * x[s] + n.y * y[s]) + (n.z * z[s] + d);
+            if (std::fabs(signedDistance) <= reach[s]) {
+                this->staticHits.push_back({spheres[s], plane, (signedDistance < 0.0f) ? -n : n, this->sphereRadius[s] - std::fabs(signedDistance)});
+            }
+        }
+#endif
+    }
+}
+
+void CollisionPhysx::collideSphereBoxes(bool moving, float dt) {
+    int padded = this->sphereX.size();
+    const float* x = this->sphereX.data();
+    const float* y = this->sphereY.data();
+    const float* z = this->sphereZ.data();
+    const float* reach = this->sphereReach.data();
+    float* gap = this->sphereGap.data();
+    for (std::size_t k = 0; k < this->boxes.size(); ++k) {
+        const BoxCollider& box = this->boxes[k];
+        const glm::vec3 c = box.center, u = box.axes[0], v = box.axes[1], w = box.axes[2], e = box.extents;
+        for (int s = 0; s < padded; ++s) {
+            float dx = x[s] - c.x, dy = y[s] - c.y, dz = z[s] - c.z;
+            float qu = std::fabs(dx * u.x + dy * u.y + dz * u.z) - e.x;
+            float qv = std::fabs(dx * v.x + dy * v.y + dz * v.z) - e.y;
+            float qw = std::fabs(dx * w.x + dy * w.y + dz * w.z) - e.z;
+            float ou = std::max(qu, 0.0f), ov = std::max(qv, 0.0f), ow = std::max(qw, 0.0f);
+            float inside = std::min(std::max(qu, std::max(qv, qw)), 0.0f);
+            gap[s] = std::sqrt(ou * ou + ov * ov + ow * ow) + inside - reach[s];
+        }
+        this->collectStaticHits(this->buckets[BOX][k]);
+    }
+}
+
+void CollisionPhysx::collideSphereCapsules(bool moving, float dt) {
+    int padded = this->sphereX.size();
+    const float* x = this->sphereX.data();
+    const float* y = this->sphereY.data();
+    const float* z = this->sphereZ.data();
+    const float* reach = this->sphereReach.data();
+    float* gap = this->sphereGap.data();
+    for (std::size_t k = 0; k < this->capsules.size(); ++k) {
+        const CapsuleCollider& capsule = this->capsules[k];
+        const glm::vec3 a = capsule.a, ab = capsule.b - capsule.a;
+        const float length2 = glm::dot(ab, ab);
+        const float inverseLength2 = (length2 > 0.0f) ? 1.0f / length2 : 0.0f;
+        const float radius = capsule.radius;
+        for (int s = 0; s < padded; ++s) {
+            float dx = x[s] - a.x, dy = y[s] - a.y, dz = z[s] - a.z;
+            float t = std::min(std::max((dx * ab.x + dy * ab.y + dz * ab.z) * inverseLength2, 0.0f), 1.0f);
+            dx -= t * ab.x, dy -= t * ab.y, dz -= t * ab.z;
+            gap[s] = std::sqrt(dx * dx + dy * dy + dz * dz) - radius - reach[s];
+        }
+        this->collectStaticHits(this->buckets[CAPSULE][k]);
+    }
+}
+
+void CollisionPhysx::collideSphereMeshes(bool moving, float dt) {
+    const std::vector<int>& spheres = this->buckets[SPHERE];
+    int count = spheres.size();
+    int padded = this->sphereX.size();
+    const float* x = this->sphereX.data();
+    const float* y = this->sphereY.data();
+    const float* z = this->sphereZ.data();
+    const float* reach = this->sphereReach.data();
+    float* gap = this->sphereGap.data();
+    for (std::size_t k = 0; k < this->meshes.size(); ++k) {
+        const MeshCollider& mesh = this->meshes[k];
+        if (mesh.bvh.empty()) {
+            continue;
+        }
+        const glm::vec3 lower = mesh.bvh.getRoot().lower, upper = mesh.bvh.getRoot().upper;
+        for (int s = 0; s < padded; ++s) {
+            float dx = std::max(std::max(lower.x - x[s], x[s] - upper.x), 0.0f);
+            float dy = std::max(std::max(lower.y - y[s], y[s] - upper.y), 0.0f);
+            float dz = std::max(std::max(lower.z - z[s], z[s] - upper.z), 0.0f);
+            gap[s] = std::sqrt(dx * dx + dy * dy + dz * dz) - reach[s];
+        }
+        for (int s = 0; s < count; ++s) {
+            if (gap[s] > 0.0f) {
+                continue;
+            }
+            glm::vec3 normal;
+            float distance = this->distanceToTriangles(mesh, glm::vec3(x[s], y[s], z[s]), reach[s], normal);
+            if (distance <= reach[s]) {
+                this->staticHits.push_back({spheres[s], this->buckets[TRIANGLE_MESH][k], normal, this->sphereRadius[s] - distance});
+            }
+        }
+    }
+}
+
+void CollisionPhysx::collectStaticHits(int object) {
+    const std::vector<int>& spheres = this->buckets[SPHERE];
+    DistanceQuery distanceTo = this->distances[this->objects[object]->shape];
+    int count = spheres.size();
+    for (int s = 0; s < count; ++s) {
+        if (this->sphereGap[s] > 0.0f) {
+            continue;
+        }
+        glm::vec3 normal;
+        float distance = (this->*distanceTo)(object, glm::vec3(this->sphereX[s], this->sphereY[s], this->sphereZ[s]), normal);
+        if (distance <= this->sphereReach[s]) {
+            this->staticHits.push_back({spheres[s], object, normal, this->sphereRadius[s] - distance});
+        }
+    }
+}
+
+float CollisionPhysx::distanceToSphere(int object, glm::vec3 point, glm::vec3& normal) {
+    Sphere* sphere = static_cast<Sphere*>(this->objects[object]->model);
+    glm::vec3 d = point - sphere->worldPosition;
+    float length = glm::length(d);
+    normal = (length > 0.0f) ? d / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    return length - sphere->radius;
+}
+
+float CollisionPhysx::distanceToPlane(int object, glm::vec3 point, glm::vec3& normal) {
+    int k = this->bucketSlot[object];
+    glm::vec3 n = glm::vec3(this->planeNx[k], this->planeNy[k], this->planeNz[k]);
+    float distance = glm::dot(n, point) + this->planeD[k];
+    normal = (distance < 0.0f) ? -n : n;
+    return std::fabs(distance);
+}
+
+float CollisionPhysx::distanceToBox(int object, glm::vec3 point, glm::vec3& normal) {
+    const BoxCollider& box = this->boxes[this->bucketSlot[object]];
+    glm::vec3 d = point - box.center;
+    glm::vec3 outside = glm::vec3(0.0f);
+    float inside = -1e30f;
+    for (int axis = 0; axis < 3; ++axis) {
+        float local = glm::dot(d, box.axes[axis]);
+        float q = std::fabs(local) - box.extents[axis];
+        glm::vec3 face = (local < 0.0f) ? -box.axes[axis] : box.axes[axis];
+        if (q > 0.0f) {
+            outside += q * face;
+        }
+        if (q > inside) {
+            inside = q;
+            normal = face;
+        }
+    }
+    float length = glm::length(outside);
+    if (length > 0.0f) {
+        normal = outside / length;
+        return length;
+    }
+    return inside;
+}
+
+float CollisionPhysx::distanceToCapsule(int object, glm::vec3 point, glm::vec3& normal) {
+    const CapsuleCollider& capsule = this->capsules[this->bucketSlot[object]];
+    glm::vec3 ab = capsule.b - capsule.a;
+    float length2 = glm::dot(ab, ab);
+    float t = (length2 > 0.0f) ? glm::clamp(glm::dot(point - capsule.a, ab) / length2, 0.0f, 1.0f) : 0.0f;
+    glm::vec3 d = point - (capsule.a + t * ab);
+    float length = glm::length(d);
+    normal = (length > 0.0f) ? d / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    return length - capsule.radius;
+}
+
+float CollisionPhysx::distanceToTriangles(const MeshCollider& mesh, glm::vec3 point, float maxDistance, glm::vec3& normal) {
+    glm::vec3 closest;
+    int triangle;
+    float distance = mesh.bvh.nearest(point, maxDistance, closest, triangle);
+    if (triangle < 0) {
+        normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    } else if (distance > 0.0f) {
+        normal = (point - closest) / distance;
+    } else {
+        normal = mesh.bvh.faceNormal(triangle);
+    }
+    return distance;
+}
+
+void CollisionPhysx::addContact(PhysxObject* one, PhysxObject* two, glm::vec3 normal, float depth, float dt) {
+    float approach = -glm::dot(one->velocity - two->velocity, normal);
+    if (-depth > this->contactMargin + std::max(approach, 0.0f) * dt) {
+        return;
+    }
+    this->wakeIfSleeping(one);
+    this->wakeIfSleeping(two);
+
+    Contact c;
+    c.one = one;
+    c.two = two;
+    c.cached = &this->contactCache.touch(one->id, two->id, normal, depth);
+    c.normal = normal;
+    c.depth = depth;
+    c.normalImpulse = c.cached->normalImpulse;
+    c.frictionImpulse = c.cached->frictionImpulse - glm::dot(c.cached->frictionImpulse, normal) * normal;
+    this->contacts[this->numContacts++] = c;
+}
+
+void CollisionPhysx::prepareContact(Contact& c, float dt) {
+    c.inverseMassOne = 1.0f / c.one->mass;
+    c.inverseMassTwo = (c.two->shape == PhysxShape::SPHERE) ? 1.0f / c.two->mass : 0.0f;
+    c.normalMass = 1.0f / (c.inverseMassOne + c.inverseMassTwo);
+    c.friction = glm::sqrt(c.one->friction * c.two->friction);
+    c.restitution = std::max(c.one->restitution, c.two->restitution);
+
+    float normalVelocity = glm::dot(c.one->velocity - c.two->velocity, c.normal);
+    if (c.depth < 0.0f) {
+        // Still apart: the bodies may close the gap, but no more.
+        c.velocityBias = c.depth / dt;
+    } else {
+        c.velocityBias = this->baumgarte * std::max(c.depth - this->penetrationSlop, 0.0f) / dt;
+    }
+    if (-normalVelocity > this->restitutionThreshold && -normalVelocity * dt >= -c.depth) {
+        c.velocityBias = std::max(c.velocityBias, -c.restitution * normalVelocity);
+    }
+}
+
+void CollisionPhysx::warmStartContact(Contact& c) {
+    glm::vec3 impulse = c.normalImpulse * c.normal + c.frictionImpulse;
+    c.one->velocity += impulse * c.inverseMassOne;
+    c.two->velocity -= impulse * c.inverseMassTwo;
+}
+
+void CollisionPhysx::solveContact(Contact& c) {
+    float normalVelocity = glm::dot(c.one->velocity - c.two->velocity, c.normal);
+    float impulse = std::max(c.normalImpulse + c.normalMass * (c.velocityBias - normalVelocity), 0.0f);
+    glm::vec3 p = (impulse - c.normalImpulse) * c.normal;
+    c.normalImpulse = impulse;
+    c.one->velocity += p * c.inverseMassOne;
+    c.two->velocity -= p * c.inverseMassTwo;
+
+    glm::vec3 relative = c.one->velocity - c.two->velocity;
+    glm::vec3 tangentVelocity = relative - glm::dot(relative, c.normal) * c.normal;
+    glm::vec3 friction = c.frictionImpulse - tangentVelocity * c.normalMass;
+    float maxFriction = c.friction * c.normalImpulse;
+    float length = glm::length(friction);
+    if (length > maxFriction) {
+        friction *= maxFriction / length;
+    }
+    p = friction - c.frictionImpulse;
+    c.frictionImpulse = friction;
+    c.one->velocity += p * c.inverseMassOne;
+    c.two->velocity -= p * c.inverseMassTwo;
+}
+
+void CollisionPhysx::resolveCollision(PhysxObject* sphere, PhysxObject* other, glm::vec3 normal, float depth) {
+    this->wakeIfSleeping(sphere);
+    this->wakeIfSleeping(other);
+    glm::vec3 before = sphere->velocity;
+    if (other->shape == SPHERE) {
+        this->solveSphereSphereCollision(sphere, other);
+    } else {
+        sphere->velocity -= 2.0f * glm::dot(sphere->velocity, normal) * normal;
+    }
+    ContactPoint& contact = this->contactCache.touch(sphere->id, other->id, normal, depth);
+    contact.normalImpulse = sphere->mass * std::fabs(glm::dot(sphere->velocity - before, normal));
+    contact.frictionImpulse = glm::vec3(0.0f);
+}
+
+void CollisionPhysx::wakeIfSleeping(PhysxObject* p) {
+    if (p->sleeping) {
+        p->wake();
+    }
+}
+
+void CollisionPhysx::onObjectsChanged(const std::vector<int>& newIds) {
+    this->orphans.clear();
+    this->contactCache.remapIds(newIds, this->orphans);
+    for (unsigned id : this->orphans) {
+        this->wakeIfSleeping(this->objects[id]);
+    }
+}
+
+void CollisionPhysx::wakeMovedObjects() {
+    for (PhysxObject* p : this->objects) {
+        if (p->sleeping) {
+            Model* m = p->model;
+            glm::vec3 translation = glm::vec3(m->_translation[0], m->_translation[1], m->_translation[2]);
+            if (translation != p->sleepPosition || m->worldPosition != p->sleepPosition) {
+                p->wake();
+                m->updateTransforms();
+            }
+        }
+    }
+}
+
+int CollisionPhysx::findIsland(int i) {
+    while (this->islandParent[i] != i) {
+        this->islandParent[i] = this->islandParent[this->islandParent[i]];
+        i = this->islandParent[i];
+    }
+    return i;
+}
+
+void CollisionPhysx::updateSleeping(float dt) {
+    int numObjects = this->objects.size();
+    this->islandParent.resize(numObjects);
+    for (int i = 0; i < numObjects; ++i) {
+        this->islandParent[i] = i;
+    }
+
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->shape != PhysxShape::SPHERE) {
+            continue;
+        }
+        Sphere* sp = static_cast<Sphere*>(p->model);
+        for (int j = 0; j < i; ++j) {
+            PhysxObject* q = this->objects[j];
+            if (q->shape != PhysxShape::SPHERE || (p->sleeping && q->sleeping)) {
+                continue;
+            }
+            Sphere* sq = static_cast<Sphere*>(q->model);
+            float reach = sp->radius + sq->radius + this->contactMargin;
+            glm::vec3 d = sp->worldPosition - sq->worldPosition;
+            if (glm::dot(d, d) <= reach * reach) {
+                this->wakeIfSleeping(p);
+                this->wakeIfSleeping(q);
+                this->islandParent[this->findIsland(i)] = this->findIsland(j);
+            }
+        }
+    }
+
+    this->islandSleepTimer.assign(numObjects, this->sleepTime);
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->isAwake()) {
+            if (glm::length(p->velocity) < this->sleepVelocity) {
+                p->sleepTimer += dt;
+            } else {
+                p->sleepTimer = 0.0f;
+            }
+            int root = this->findIsland(i);
+            this->islandSleepTimer[root] = std::min(this->islandSleepTimer[root], p->sleepTimer);
+        }
+    }
+
+    this->activeCount = 0;
+    for (int i = 0; i < numObjects; ++i) {
+        PhysxObject* p = this->objects[i];
+        if (p->isAwake()) {
+            if (this->islandSleepTimer[this->findIsland(i)] >= this->sleepTime) {
+                p->sleeping = true;
+                p->velocity = glm::vec3(0.0f);
+                p->sleepPosition = p->model->worldPosition;
+            } else {
+                ++this->activeCount;
+            }
+        }
+    }
+}
+
+bool CollisionPhysx::testPlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere) {
+    Plane* p = static_cast<Plane*>(plane->model);
+    Sphere* s = static_cast<Sphere*>(sphere->model);
+    float dist = std::fabs(glm::dot(s->worldPosition - p->worldPosition, p->normal));
+    return (dist <= s->radius);
+}
+
+void CollisionPhysx::solvePlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere) {
+    Plane* p = static_cast<Plane*>(plane->model);
+    glm::vec3 ncap = p->normal;
+    if (glm::length(sphere->velocity) > 0.0f) {
+        glm::vec3 lcap = glm::normalize(sphere->velocity);
+        float dotnl = glm::dot(ncap, lcap);
+        glm::vec3 rcap = 2 * dotnl * ncap - lcap;
+        rcap = glm::normalize(rcap);
+        sphere->velocity = (-1.0f) * rcap * glm::length(sphere->velocity);
+    }
+    return;
+}
+
+bool CollisionPhysx::testSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo) {
+    Sphere* sOne = static_cast<Sphere*>(sphereOne->model);
+    Sphere* sTwo = static_cast<Sphere*>(sphereTwo->model);
+
+    bool cond1 = (glm::distance(sOne->worldPosition, sTwo->worldPosition) <= (sOne->radius + sTwo->radius));
+    bool cond2 = (glm::dot(sTwo->worldPosition - sOne->worldPosition, sphereOne->velocity) >= 0);
+    return cond1 && cond2;
+}
+
+void CollisionPhysx::solveSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo) {
+    Sphere* s1 = static_cast<Sphere*>(sphereOne->model);
+    Sphere* s2 = static_cast<Sphere*>(sphereTwo->model);
+    glm::vec3 d = glm::normalize(s2->worldPosition - s1->worldPosition);
+    glm::vec3 _v1 = sphereOne->velocity - sphereTwo->velocity;
+    glm::vec3 __v2 = (2.0f) * d * (sphereOne->mass / (sphereTwo->mass + sphereOne->mass)) * glm::dot(_v1, d);
+    glm::vec3 u2 = sphereTwo->velocity + __v2;
+    glm::vec3 u1 = (sphereOne->mass * sphereOne->velocity + sphereTwo->mass * sphereTwo->velocity - sphereTwo->mass * u2) / sphereOne->mass;
+    sphereOne->velocity = u1;
+    sphereTwo->velocity = u2;
+    return;
+}
+
+void CollisionPhysx::stepSphere(PhysxObject* sphere, float dt) {
+    Sphere* s = static_cast<Sphere*>(sphere->model);
+    s->worldPosition += sphere->velocity * dt;
+    s->_translation[0] = s->worldPosition.x;
+    s->_translation[1] = s->worldPosition.y;
+    s->_translation[2] = s->worldPosition.z;
+    s->updateTransforms();
+}
@@ -1,4 +1,4 @@
-/** @file Physics.cpp
+/** @file Physics.hpp
  *  @brief Class definition for a Physics.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -9,9 +9,16 @@
 #define PHYSICS_H
 
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/type_ptr.hpp>
-#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "Arena.hpp"
+#include "ContactCache.hpp"
 #include "Model.hpp"
+#include "SlotMap.hpp"
+#include "TriangleBVH.hpp"
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,11 +36,49 @@ const float SUN_MASS = 1.989E7;
 /**
  * @enum PhysxShape
  * @brief Shape of the Object used in the physics simulation.
+ * @details Only spheres are moved by the collision simulation, the other shapes are static colliders.
  * 
  */
 enum PhysxShape {
     PLANE,
     SPHERE,
+    BOX,
+    CAPSULE,
+    //! Triangles of a model whose meshes are kept on the CPU.
+    TRIANGLE_MESH,
+};
+
+//! Number of shapes in PhysxShape.
+const int NUM_PHYSX_SHAPES = 5;
+
+/**
+ * @enum PhysxEngine
+ * @brief Type of the Physics Simulator attached to a scene.
+ * 
+ */
+enum PhysxEngine {
+    COLLISION_ENGINE,
+    SOLAR_SYSTEM_ENGINE,
+    NBODY_ENGINE,
+    FMM_ENGINE,
+};
+
+/**
+ * @enum IntegratorType
+ * @brief Numerical method used to advance positions and velocities over a time step.
+ * 
+ */
+enum IntegratorType {
+    //! Position from the old velocity, then velocity from the old position. First order.
+    EXPLICIT_EULER,
+    //! Velocity first, then position from the new velocity. First order, symplectic.
+    SEMI_IMPLICIT_EULER,
+    //! Drift-kick-drift leapfrog, the position form of velocity Verlet. Second order, symplectic.
+    LEAPFROG,
+    //! Yoshida's composition of three leapfrog steps. Fourth order, symplectic.
+    YOSHIDA4,
+    //! Classical Runge-Kutta. Fourth order, not symplectic.
+    RK4,
 };
 
 /**
@@ -54,6 +99,22 @@ typedef struct PhysxObject {
 
     bool gravityEnabled = false;
     bool airResistanceEnabled = false;
+    //! Viscosity of the air, used for the Stokes drag on spheres when air resistance is enabled.
+    float airViscosity = 0.007f;
+
+    //! Identifier of the object within its simulation, set by Physx::addObject().
+    unsigned id = 0;
+    //! Fraction of the approach speed kept after an impact, used by the contact solver.
+    float restitution = 0.5f;
+    //! Coulomb friction coefficient, used by the contact solver.
+    float friction = 0.3f;
+
+    //! Whether the object is at rest and skipped by the simulation until it is woken.
+    bool sleeping = false;
+    //! Time the object has spent below the sleep velocity.
+    float sleepTimer = 0.0f;
+    //! Position the object fell asleep at, moving it away from here wakes it.
+    glm::vec3 sleepPosition = glm::vec3(0.0f);
 
     /**
 	 * @brief Construct a new PhysxObject
@@ -63,15 +124,7 @@ typedef struct PhysxObject {
 	 * @param mass 
 	 * @param initVelocity 
 	 */
-    PhysxObject(PhysxShape shape, Model* model, float mass, glm::vec3 initVelocity) {
-        this->shape = shape;
-        this->model = model;
-        this->mass = mass;
-        this->velocity = glm::vec3(initVelocity);
-        this->force = this->mass * glm::vec3(0.0f);
-        this->gravityEnabled = false;
-        this->airResistanceEnabled = false;
-    }
+    PhysxObject(PhysxShape shape, Model* model, float mass, glm::vec3 initVelocity);
 
     /**
 	 * @brief Enables gravity for the current object.
@@ -88,36 +141,111 @@ typedef struct PhysxObject {
     }
 
     /**
-	 * @brief Computer all the forces acting on object in the current frame.
+	 * @brief Wake the object up so that it is simulated again.
 	 */
-    void recomputeTotalForce() {
-        this->force = this->mass * glm::vec3(0.0f);
-
-        if (gravityEnabled) {
-            this->force += this->mass * glm::vec3(0, -g, 0);
-        }
+    void wake();
 
-        if (airResistanceEnabled) {
-            if (this->shape == PhysxShape::SPHERE) {
-                Sphere* s = static_cast<Sphere*>(this->model);
-                this->force -= this->mass * (6.0f * 3.1415f * 0.007f * s->radius) * this->velocity;
-            }
-        }
+    /**
+	 * @brief Whether the object moves and collides, i.e. it is an awake sphere.
+	 */
+    bool isAwake() const {
+        return this->shape == PhysxShape::SPHERE && !this->sleeping;
     }
+
+    /**
+	 * @brief Computer all the forces acting on object in the current frame.
+	 */
+    void recomputeTotalForce();
 } PhysxObject;
 
+//! Names a body created by Physx::createBody(), see Physx::getBody().
+typedef SlotHandle BodyHandle;
+
 /** @class Physx
  *  @brief Handles the Physics calculations for all objects in the scene with physics enabled.
  */
 class Physx {
    public:
+    //! Reproduce every step bit for bit across runs, thread counts and CPUs, see enableDeterministic().
+    bool deterministic = false;
+
+    /**
+	 * @brief Make the simulation reproducible bit for bit, for recorded runs and parameter sweeps.
+	 * 
+	 * @details Sums are taken in a fixed order by plain float kernels instead of SIMD approximations,
+	 * which differ between CPUs. Collisions need no change: the kernels find contacts on one thread
+	 * in the order the bodies were added in, and they are resolved in that order. The code also has
+	 * to be built with -ffp-contract=off, so that the compiler does not fuse multiply-adds where
+	 * another build would not.
+	 */
+    void enableDeterministic() {
+        this->deterministic = true;
+    }
+
     /**
 	 * @brief Consider the Model specified through the PhysxObject for all physics calculations.
+	 * @details The object stays owned by the caller and must not move while it is simulated.
+	 * Bodies created with createBody() are owned by the simulation instead.
 	 * 
 	 * @param object 
 	 */
-    void addObject(PhysxObject* object) {
-        this->objects.push_back(object);
+    void addObject(PhysxObject* object);
+
+    /**
+	 * @brief Stop simulating an object added with addObject(). The last object takes over its id.
+	 * 
+	 * @param object 
+	 * @return true If the object was part of the simulation.
+	 */
+    bool removeObject(PhysxObject* object);
+
+    /**
+	 * @brief Create a body owned by the simulation and add it.
+	 * @details The bodies are kept next to each other in one array, and removed bodies leave no
+	 * holes, so bodies can be created and removed at any rate without fragmenting memory.
+	 * 
+	 * @param shape 
+	 * @param model 
+	 * @param mass 
+	 * @param initVelocity 
+	 * @return BodyHandle Names the body until removeBody(), see getBody().
+	 */
+    BodyHandle createBody(PhysxShape shape, Model* model, float mass, glm::vec3 initVelocity);
+
+    /**
+	 * @brief Remove a body created with createBody(). The last object takes over its id.
+	 * 
+	 * @param handle 
+	 * @return true If the handle named a body of the simulation.
+	 */
+    bool removeBody(BodyHandle handle);
+
+    /**
+	 * @brief Get a body created with createBody().
+	 * @details The pointer is valid until the next body is created or removed, keep the handle instead.
+	 * 
+	 * @param handle 
+	 * @return PhysxObject* nullptr when the body was removed.
+	 */
+    PhysxObject* getBody(BodyHandle handle) {
+        return this->bodies.get(handle);
+    }
+
+    /**
+	 * @brief Get the handle of a body created with createBody().
+	 * 
+	 * @param object 
+	 * @return BodyHandle An invalid handle for objects added with addObject().
+	 */
+    BodyHandle getHandle(const PhysxObject* object) const;
+
+    /**
+	 * @brief Get the number of bodies created with createBody() that are still simulated.
+	 * 
+	 * @return std::size_t 
+	 */
+    std::size_t getBodyCount() const {
+        return this->bodies.size();
     }
 
     /**
@@ -127,73 +255,749 @@ class Physx {
 	 */
     virtual void step(float dt) = 0;
 
+    /**
+	 * @brief Get the type of the Physics Simulator.
+	 * 
+	 * @return PhysxEngine 
+	 */
+    virtual PhysxEngine getEngine() const = 0;
+
+    /**
+	 * @brief Get all the objects interacting in the simulation.
+	 * 
+	 * @return const std::vector<PhysxObject*>& 
+	 */
+    const std::vector<PhysxObject*>& getObjects() const {
+        return this->objects;
+    }
+
+    /**
+	 * @brief Append any state beyond the objects' positions and velocities that the next steps depend on.
+	 * @details Used by SimulationHistory so that replaying from a snapshot reproduces the original run.
+	 * 
+	 * @param words 
+	 */
+    virtual void captureSolverState(std::vector<std::uint32_t>& words) const {
+    }
+
+    /**
+	 * @brief Restore the state written by captureSolverState(), starting at words[i].
+	 * 
+	 * @param words 
+	 * @param i Advanced past the words read.
+	 */
+    virtual void restoreSolverState(const std::vector<std::uint32_t>& words, std::size_t& i) {
+    }
+
+    /**
+	 * @brief Select the numerical method used to advance the objects.
+	 * 
+	 * @param integrator 
+	 */
+    void setIntegrator(IntegratorType integrator) {
+        this->integrator = integrator;
+    }
+
+    /**
+	 * @brief Get the numerical method used to advance the objects.
+	 * 
+	 * @return IntegratorType 
+	 */
+    IntegratorType getIntegrator() const {
+        return this->integrator;
+    }
+
+    /**
+	 * @brief Compute the acceleration of every object for the given positions and velocities.
+	 * 
+	 * @details The default applies the forces of PhysxObject::recomputeTotalForce, gravity and air resistance.
+	 * 
+	 * @param positions 
+	 * @param velocities 
+	 * @param accelerations Output, one entry per object.
+	 */
+    virtual void computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations);
+
    protected:
-    //! List of all objects interacting in the simulation.
+    //! List of all objects interacting in the simulation. The id of an object is its index here.
     std::vector<PhysxObject*> objects;
+    //! Bodies created by createBody(), next to each other.
+    SlotMap<PhysxObject> bodies;
+    //! Changes whenever an object is added or removed.
+    std::uint64_t objectsVersion = 0;
+    //! Memory for data that lives for a single step. Steps reset it before they start.
+    Arena stepArena;
+    //! Numerical method used by integrate().
+    IntegratorType integrator = EXPLICIT_EULER;
+    //! Scratch state of integrate(), kept between steps to avoid reallocating.
+    std::vector<glm::vec3> positions, velocities, accelerations, k1x, k1v, k2x, k2v, k3x, k3v;
+
+    /**
+	 * @brief Tell the simulation which objects were added or removed since the last step.
+	 * @details Called by every step before anything else. Does nothing when no object changed.
+	 */
+    void updateObjects();
+
+    /**
+	 * @brief Move the per object state a simulation keeps across steps to the new ids.
+	 * 
+	 * @param newIds New id of every object of the last step, -1 for removed objects.
+	 */
+    virtual void onObjectsChanged(const std::vector<int>& newIds) {
+    }
+
+   private:
+    static constexpr std::uint32_t NEW_OBJECT = ~0u;
+
+    //! Whether objects were added or removed since the last step.
+    bool objectsChanged = false;
+    //! Number of objects in the last step.
+    std::size_t syncedCount = 0;
+    //! Id every object had in the last step, NEW_OBJECT for objects added since.
+    std::vector<std::uint32_t> previousIds;
+    std::vector<int> newIds;
+
+    void beginObjectsChange();
+
+    /**
+	 * @brief Remove the object with the given id by moving the last object into its place.
+	 */
+    void detachObject(unsigned id);
+
+   protected:
+
+    /**
+	 * @brief Advance the world position and velocity of every object by dt with the selected integrator.
+	 * 
+	 * @details The model transforms are not touched, the caller updates them once the step is done.
+	 * 
+	 * @param dt 
+	 */
+    void integrate(float dt);
+
+   private:
+    /**
+	 * @brief One drift-kick-drift step on the scratch state: drift by before * dt, kick by kick * dt, drift by after * dt.
+	 */
+    void leapfrog(float dt, float before, float kick, float after);
+
+    /**
+	 * @brief One classical Runge-Kutta step on the scratch state.
+	 */
+    void rungeKutta4(float dt);
 };
 
 /** @class SolarSystemPhysx
  *  @brief Handles the Physics for the Solar System Simulation.
  */
 class SolarSystemPhysx : public Physx {
-    virtual void step(float dt) {
-        int numObjects = this->objects.size();
-        PhysxObject* sun = this->objects[0];
-        for (int i = 1; i < numObjects; ++i) {
-            PhysxObject* p = this->objects[i];
-            p->force = glm::vec3(0);
-            float gForce = p->mass * sun->mass / glm::pow(glm::distance(p->model->worldPosition, sun->model->worldPosition), 2);
-            glm::vec3 gForceDirection = glm::normalize(sun->model->worldPosition - p->model->worldPosition);
-            p->force += gForceDirection * gForce;
-            p->model->worldPosition += p->velocity * dt;
-            p->velocity += (p->force / p->mass) * dt;
-            p->model->_translation[0] = p->model->worldPosition.x;
-            p->model->_translation[1] = p->model->worldPosition.y;
-            p->model->_translation[2] = p->model->worldPosition.z;
-            p->model->updateTransforms();
-        }
+   public:
+    //! Give every planet its own power-of-two sub-step instead of the shared time step.
+    bool adaptiveTimeStep = false;
+    //! Accuracy parameter of the sub-step criterion, sub-step <= accuracy * |a| / |da/dt|.
+    float timeStepAccuracy = 0.02f;
+    //! Finest sub-step level, the smallest sub-step is dt / 2^maxTimeStepLevel.
+    int maxTimeStepLevel = 8;
+
+    virtual PhysxEngine getEngine() const {
+        return SOLAR_SYSTEM_ENGINE;
+    }
+
+    /**
+	 * @brief Advance each planet with its own power-of-two fraction of the time step.
+	 * 
+	 * @details A planet's sub-step is chosen from its acceleration and jerk, so planets close to
+	 * the sun take many small kick-drift-kick steps while the outer ones take one step per frame.
+	 * The selected integrator is not used in this mode.
+	 * 
+	 * @param accuracy Accuracy parameter of the sub-step criterion.
+	 * @param maxLevel Finest sub-step level.
+	 */
+    void enableAdaptiveTimeStep(float accuracy = 0.02f, int maxLevel = 8);
+
+    /**
+	 * @brief Get the sub-step level of an object in the last step, its sub-step was dt / 2^level.
+	 * 
+	 * @param i Index of the object.
+	 * @return int 
+	 */
+    int getTimeStepLevel(int i) const {
+        return (i < (int)this->levels.size()) ? this->levels[i] : 0;
+    }
+
+    /**
+	 * @brief Get the time an object was advanced by in the last step, the sum of its sub-steps.
+	 * @details Equals the time step for every planet, only the sun is not advanced.
+	 *
+	 * @param i Index of the object.
+	 * @return double
+	 */
+    double getElapsedTime(int i) const {
+        return (i < (int)this->elapsedTimes.size()) ? this->elapsedTimes[i] : 0.0;
     }
+
+    /**
+	 * @brief Get the number of planet updates made since the simulation started.
+	 * 
+	 * @return unsigned long long 
+	 */
+    unsigned long long getBodyUpdates() const {
+        return this->bodyUpdates;
+    }
+
+    /**
+	 * @brief Gravity of the sun on every planet. The sun itself is held in place.
+	 */
+    virtual void computeAccelerations(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& velocities, std::vector<glm::vec3>& accelerations);
+
+    virtual void step(float dt);
+
+   private:
+    //! Sub-step level of every object.
+    std::vector<int> levels;
+    //! Acceleration of every object at its current position.
+    std::vector<glm::vec3> blockAccelerations;
+    //! Tick at which the current sub-step of every object ends and it is updated again.
+    std::vector<int> nextTicks;
+    //! Time every object was advanced by in the current step.
+    std::vector<double> elapsedTimes;
+    //! Number of planet updates made since the simulation started.
+    unsigned long long bodyUpdates = 0;
+
+    /**
+	 * @brief Acceleration and jerk of a planet from the gravity of the sun.
+	 */
+    glm::vec3 sunAcceleration(glm::vec3 position, glm::vec3 velocity, glm::vec3& jerk);
+
+    /**
+	 * @brief Finest power-of-two level whose sub-step meets the accuracy criterion.
+	 */
+    int chooseLevel(glm::vec3 acceleration, glm::vec3 jerk, float dt);
+
+    /**
+	 * @brief Block time step: the step is split into 2^maxTimeStepLevel ticks and a planet of
+	 * level k is updated every 2^(maxTimeStepLevel - k) ticks.
+	 * 
+	 * @details Only the sun attracts the planets, so a planet's update does not need the others
+	 * to be predicted to the same tick. A planet is updated again only at the tick its sub-step
+	 * ends, and changes its level there: to a finer level after any of its sub-steps, and to the
+	 * next coarser level only where that coarser sub-step starts. So every planet is advanced by
+	 * exactly the time step.
+	 */
+    void stepAdaptive(float dt);
 };
 
 /** @class CollisionPhysx
  *  @brief Handles the Physics for the Collision Simulation.
  */
 class CollisionPhysx : public Physx {
-    virtual void step(float dt) {
-        int numObjects = this->objects.size();
-        for (int i = 0; i < numObjects; ++i) {
-            PhysxObject* p = objects[i];
-            for (int j = 0; j < i; ++j) {
-                PhysxObject* q = objects[j];
-                if (p->shape == PLANE and q->shape == SPHERE) {
-                    if (this->testPlaneSphereCollision(p, q)) {
-                        this->solvePlaneSphereCollision(p, q);
-                    }
-                } else if (p->shape == SPHERE and q->shape == PLANE) {
-                    if (this->testPlaneSphereCollision(q, p)) {
-                        this->solvePlaneSphereCollision(q, p);
-                    }
-                } else if (p->shape == SPHERE and q->shape == SPHERE) {
-                    if (this->testSphereSphereCollision(p, q)) {
-                        solveSphereSphereCollision(p, q);
-                    }
-                }
-            }
-        }
+   public:
+    //! Resolve collisions at their time of impact instead of testing overlaps at the end of the step.
+    bool continuousCollision = false;
+    //! Impacts resolved per sphere within a single step before the rest of the step is drifted through.
+    int maxImpactsPerBody = 8;
+    //! Let islands of touching spheres at rest fall asleep and skip them until something wakes them.
+    bool sleepingEnabled = false;
+    //! Speed below which a sphere counts as being at rest.
+    float sleepVelocity = 0.5f;
+    //! Time every sphere of an island has to stay at rest before the island falls asleep.
+    float sleepTime = 0.5f;
+    //! Gap up to which two spheres count as touching when islands are built.
+    float contactMargin = 0.05f;
+    //! Resolve contacts with the iterative sequential impulse solver instead of reflecting velocities pairwise.
+    bool contactSolver = false;
+    //! Velocity iterations of the contact solver per step.
+    int solverIterations = 8;
+    //! Fraction of the penetration removed per step by the contact solver.
+    float baumgarte = 0.2f;
+    //! Penetration the contact solver leaves alone, so resting contacts do not jitter.
+    float penetrationSlop = 0.01f;
+    //! Approach speed below which impacts do not bounce.
+    float restitutionThreshold = 1.0f;
+
+    /**
+	 * @brief Construct a new CollisionPhysx, filling the tables of collision kernels and distance queries.
+	 * 
+	 * @details Pairs of shapes without a kernel, i.e. two static shapes, are never tested.
+	 */
+    CollisionPhysx();
+
+    virtual PhysxEngine getEngine() const {
+        return COLLISION_ENGINE;
+    }
+
+    /**
+	 * @brief Sweep the spheres over the time step and resolve collisions at their time of impact,
+	 * so that fast spheres cannot tunnel through planes or each other.
+	 */
+    void enableContinuousCollision() {
+        this->continuousCollision = true;
+    }
+
+    /**
+	 * @brief Put islands of touching spheres to sleep once they have been at rest for a while.
+	 * 
+	 * @details Sleeping spheres are neither moved nor collision tested. An island wakes up when
+	 * an awake sphere touches it or when one of its spheres is moved from outside, e.g. from the GUI.
+	 * 
+	 * @param velocity Speed below which a sphere counts as being at rest.
+	 * @param time Time an island has to stay at rest before it falls asleep.
+	 */
+    void enableSleeping(float velocity = 0.5f, float time = 0.5f);
+
+    /**
+	 * @brief Resolve contacts with an iterative sequential impulse solver.
+	 * 
+	 * @details Contacts are found for touching and, so that fast spheres do not tunnel, for soon to
+	 * be touching pairs. Their impulses are solved together over a number of iterations, starting from
+	 * the impulses of the same pairs in the previous step, with restitution, Coulomb friction and
+	 * Baumgarte position correction. This replaces the discrete and continuous paths.
+	 * 
+	 * @param iterations Velocity iterations per step.
+	 */
+    void enableContactSolver(int iterations = 8);
+
+    /**
+	 * @brief Get the contacts found in the last step of the contact solver.
+	 * 
+	 * @return int 
+	 */
+    int getContactCount() const {
+        return this->numContacts;
+    }
+
+    /**
+	 * @brief Get the contacts kept across steps, and the contact events of the last step.
+	 * 
+	 * @return const ContactCache& 
+	 */
+    const ContactCache& getContactCache() const {
+        return this->contactCache;
+    }
+
+    /**
+	 * @brief Write the cached contacts, sorted by body pair.
+	 * 
+	 * @param words 
+	 */
+    virtual void captureSolverState(std::vector<std::uint32_t>& words) const {
+        this->contactCache.capture(words);
+    }
+
+    virtual void restoreSolverState(const std::vector<std::uint32_t>& words, std::size_t& i) {
+        this->contactCache.restore(words, i);
+    }
+
+    /**
+	 * @brief Get the number of spheres that were simulated in the last step.
+	 * 
+	 * @return int 
+	 */
+    int getActiveCount() const {
+        return this->activeCount;
+    }
+
+    virtual void step(float dt);
+
+    /**
+	 * @brief Test overlaps at the end of the step and reflect the velocities of colliding pairs.
+	 * 
+	 * @param dt 
+	 */
+    void stepDiscrete(float dt);
 
-        for (int i = 0; i < numObjects; ++i) {
-            PhysxObject* p = objects[i];
-            if (p->shape == PhysxShape::SPHERE) {
-                this->stepSphere(p, dt);
-                if (p->gravityEnabled || p->airResistanceEnabled) {
-                    p->recomputeTotalForce();
-                    p->velocity += (p->force / p->mass) * dt;
-                    this->stepSphere(p, dt);
-                }
-            }
+    /**
+	 * @brief Advance the simulation by dt with the sequential impulse contact solver.
+	 * 
+	 * @details Velocities are integrated first, then the contacts are found and warm started from the
+	 * contact cache, their impulses are iterated, and the positions are integrated with the solved
+	 * velocities. The accumulated impulses go back into the cache for the next step.
+	 * 
+	 * @param dt 
+	 */
+    void stepSolver(float dt);
+
+    /**
+	 * @brief Advance the simulation by dt, resolving every impact at its time of impact.
+	 * 
+	 * @details Forces are applied to the velocities first. The impacts of all approaching pairs
+	 * within the step go into a queue ordered by time. Each sphere keeps its own local time, so
+	 * only the two bodies of an impact are moved up to it. After an impact only the pairs of
+	 * those two bodies are predicted again; queued impacts they were part of are dropped through
+	 * a per-body version. When a step hits maxImpactsPerBody impacts per sphere, the spheres
+	 * drift through what is left of the step.
+	 * 
+	 * @param dt 
+	 */
+    void stepContinuous(float dt);
+
+    /**
+	 * @brief Time at which a moving sphere touches a plane.
+	 * 
+	 * @param plane 
+	 * @param position Center of the sphere.
+	 * @param velocity Velocity of the sphere.
+	 * @param radius Radius of the sphere.
+	 * @param maxTime 
+	 * @return float Time of impact in [0, maxTime], or -1 when the sphere does not reach the plane in time
+	 * or is moving away from it.
+	 */
+    float sweepPlaneSphere(const Plane* plane, glm::vec3 position, glm::vec3 velocity, float radius, float maxTime);
+
+    /**
+	 * @brief Time at which a moving sphere touches a static body, by conservative advancement.
+	 * 
+	 * @details The sphere is moved up to the tangent plane at the closest point of the body, which
+	 * convex bodies lie behind, and the closest point is found again from there. For a plane the
+	 * first step is exact.
+	 * 
+	 * @param object Index of the static body.
+	 * @param position Center of the sphere.
+	 * @param velocity Velocity of the sphere.
+	 * @param radius Radius of the sphere.
+	 * @param maxTime 
+	 * @return float Time of impact in [0, maxTime], or -1 when the sphere does not reach the body in time
+	 * or is moving away from it.
+	 */
+    float sweepStatic(int object, glm::vec3 position, glm::vec3 velocity, float radius, float maxTime);
+
+    /**
+	 * @brief Time at which two moving spheres touch.
+	 * 
+	 * @param positionOne 
+	 * @param velocityOne 
+	 * @param radiusOne 
+	 * @param positionTwo 
+	 * @param velocityTwo 
+	 * @param radiusTwo 
+	 * @param maxTime 
+	 * @return float Time of impact in [0, maxTime], or -1 when the spheres do not meet in time
+	 * or are moving apart.
+	 */
+    float sweepSphereSphere(glm::vec3 positionOne, glm::vec3 velocityOne, float radiusOne, glm::vec3 positionTwo, glm::vec3 velocityTwo, float radiusTwo, float maxTime);
+
+   private:
+    /**
+	 * @struct ImpactEvent
+	 * @brief A predicted impact between two objects, valid while neither has collided since.
+	 */
+    struct ImpactEvent {
+        float time;
+        int one;
+        int two;
+        unsigned versionOne;
+        unsigned versionTwo;
+
+        bool operator>(const ImpactEvent& other) const {
+            return this->time > other.time;
         }
+    };
+
+    //! Time within the current step that each sphere has been moved up to.
+    std::vector<float> localTime;
+    //! Number of impacts each object has had in the current step.
+    std::vector<unsigned> version;
+    //! Predicted impacts, a heap with the earliest on top. A plain vector keeps its memory from step to step.
+    std::vector<ImpactEvent> impacts;
+
+    /**
+	 * @brief Position of an object at the given time within the step.
+	 */
+    glm::vec3 positionAt(int i, float time);
+
+    /**
+	 * @brief Move a sphere along its velocity up to the given time within the step.
+	 */
+    void advanceTo(int i, float time);
+
+    /**
+	 * @brief Queue the impacts of object i with the objects before index end, from time now to the end of the step.
+	 */
+    void predictImpacts(int i, int end, float now, float dt);
+
+    /**
+	 * @struct ShapeHit
+	 * @brief A sphere within reach of another body, found by a collision kernel.
+	 */
+    struct ShapeHit {
+        //! Object index of the sphere.
+        int sphere;
+        //! Object index of the other body.
+        int other;
+        //! Unit normal pointing from the other body to the sphere.
+        glm::vec3 normal;
+        //! Penetration depth, negative while the bodies are still apart.
+        float depth;
+    };
+
+    /**
+	 * @struct BoxCollider
+	 * @brief World space box of a Box model.
+	 */
+    struct BoxCollider {
+        glm::vec3 center;
+        //! Unit axes of the box.
+        glm::vec3 axes[3];
+        //! Half extents along the axes.
+        glm::vec3 extents;
+    };
+
+    /**
+	 * @struct CapsuleCollider
+	 * @brief World space capsule of a Capsule model.
+	 */
+    struct CapsuleCollider {
+        //! End points of the segment the capsule is swept along.
+        glm::vec3 a, b;
+        float radius;
+    };
+
+    /**
+	 * @struct MeshCollider
+	 * @brief World space triangles of a model whose meshes are kept on the CPU.
+	 */
+    struct MeshCollider {
+        //! Model matrix the triangles were transformed with.
+        glm::mat4 matrix;
+        //! Hierarchy over the triangles.
+        TriangleBVH bvh;
+        bool built = false;
+    };
+
+    //! Test all spheres against all bodies of one shape and collect the hits.
+    typedef void (CollisionPhysx::*CollisionKernel)(bool moving, float dt);
+    //! Distance of a point from the surface of a body, negative inside, and the outward normal there.
+    typedef float (CollisionPhysx::*DistanceQuery)(int object, glm::vec3 point, glm::vec3& normal);
+
+    //! Collision kernel of every pair of shapes, null for pairs that never collide.
+    CollisionKernel kernels[NUM_PHYSX_SHAPES][NUM_PHYSX_SHAPES];
+    //! Distance query of every shape.
+    DistanceQuery distances[NUM_PHYSX_SHAPES];
+
+    //! Object indices of the bodies of every shape, built for the objects of bucketVersion.
+    std::vector<int> buckets[NUM_PHYSX_SHAPES];
+    std::uint64_t bucketVersion = ~0ull;
+    //! Index of every object within the bucket of its shape.
+    std::vector<int> bucketSlot;
+
+    //! Position, velocity and radius of the spheres in bucket order, padded to a multiple of 4.
+    std::vector<float> sphereX, sphereY, sphereZ, sphereVx, sphereVy, sphereVz, sphereRadius;
+    //! Distance from its surface at which a sphere meets a static body, negative for padding.
+    std::vector<float> sphereReach;
+    std::vector<std::uint8_t> sphereAwake;
+    //! Gap of every sphere to the current body, written by the box, capsule and mesh kernels.
+    std::vector<float> sphereGap;
+
+    //! Plane equations, distance = nx * x + ny * y + nz * z + d, cached as separate arrays.
+    std::vector<float> planeNx, planeNy, planeNz, planeD;
+    //! Plane::version each equation was cached at.
+    std::vector<unsigned> planeVersions;
+    std::vector<BoxCollider> boxes;
+    std::vector<CapsuleCollider> capsules;
+    std::vector<MeshCollider> meshes;
+
+    //! Hits between two spheres of the last pass.
+    std::vector<ShapeHit> sphereHits;
+    //! Hits between a sphere and a static body of the last pass.
+    std::vector<ShapeHit> staticHits;
+
+    void setKernel(PhysxShape a, PhysxShape b, CollisionKernel kernel);
+
+    /**
+	 * @brief Sort the objects into buckets by shape, when objects were added since the last step.
+	 */
+    void updateBuckets();
+
+    /**
+	 * @brief Bring the world space colliders of the static bodies up to date with their models.
+	 *
+	 * @details Plane equations are cached until Plane::version changes, and mesh triangles until the
+	 * model matrix changes. Boxes and capsules are cheap enough to read from the model matrix every step.
+	 */
+    void updateColliders();
+
+    /**
+	 * @brief Transform the triangles of a model to world space and build their hierarchy.
+	 */
+    void buildMeshCollider(Model* model, MeshCollider& collider);
+
+    /**
+	 * @brief Run the collision kernel of every pair of shapes present in the scene, collecting into sphereHits and staticHits.
+	 *
+	 * @param moving Widen the reach by the margin and the distance a sphere covers in dt, for the contact solver.
+	 * @param dt
+	 */
+    void findHits(bool moving, float dt);
+
+    /**
+	 * @brief Copy the spheres into separate arrays, padded to a multiple of 4.
+	 *
+	 * @details Sleeping spheres get a reach against static bodies too, so that spheres woken by
+	 * a sphere pair in the same step still meet them. Their hits are dropped while they sleep.
+	 */
+    void gatherSpheres(bool moving, float dt);
+
+    /**
+	 * @brief Collect the pairs of spheres within reach of each other, skipping pairs that are both asleep.
+	 */
+    void collideSpheres(bool moving, float dt);
+
+    /**
+	 * @brief Collect the spheres within reach of every plane, four at a time.
+	 */
+    void collideSpherePlanes(bool moving, float dt);
+
+    /**
+	 * @brief Collect the spheres within reach of every box.
+	 *
+	 * @details The signed distances of all sphere centers are computed in a branch free loop over
+	 * the arrays first. Only the spheres within reach are looked at again for the normal.
+	 */
+    void collideSphereBoxes(bool moving, float dt);
+
+    /**
+	 * @brief Collect the spheres within reach of every capsule, in the same two passes as the boxes.
+	 */
+    void collideSphereCapsules(bool moving, float dt);
+
+    /**
+	 * @brief Collect the spheres within reach of every triangle mesh.
+	 *
+	 * @details The bounds of the mesh reject the spheres that are far away in a branch free loop.
+	 * The hierarchy is searched for the closest triangle of the others, only as far as their reach.
+	 */
+    void collideSphereMeshes(bool moving, float dt);
+
+    /**
+	 * @brief Add a hit for every sphere the last kernel pass left with a gap of at most 0 to a static body.
+	 */
+    void collectStaticHits(int object);
+
+    float distanceToSphere(int object, glm::vec3 point, glm::vec3& normal);
+
+    /**
+	 * @brief Distance from either side of a plane.
+	 */
+    float distanceToPlane(int object, glm::vec3 point, glm::vec3& normal);
+
+    /**
+	 * @brief Distance from a box, to the nearest face when the point is inside.
+	 */
+    float distanceToBox(int object, glm::vec3 point, glm::vec3& normal);
+
+    float distanceToCapsule(int object, glm::vec3 point, glm::vec3& normal);
+
+    /**
+	 * @brief Distance from the nearest triangle of a mesh. Meshes have no inside, so it is never negative.
+	 */
+    float distanceToMesh(int object, glm::vec3 point, glm::vec3& normal) {
+        return this->distanceToTriangles(this->meshes[this->bucketSlot[object]], point, std::numeric_limits<float>::max(), normal);
     }
 
+    /**
+	 * @brief Distance from the nearest triangle of a mesh within maxDistance, infinite when there is none.
+	 */
+    float distanceToTriangles(const MeshCollider& mesh, glm::vec3 point, float maxDistance, glm::vec3& normal);
+
+    /**
+	 * @struct Contact
+	 * @brief A contact between a sphere and another sphere or a static body, solved by the contact solver.
+	 */
+    struct Contact {
+        //! The sphere.
+        PhysxObject* one;
+        //! The other sphere, or the static body.
+        PhysxObject* two;
+        //! Entry of the contact in the contact cache.
+        ContactPoint* cached;
+        //! Unit normal pointing from two to one.
+        glm::vec3 normal;
+        //! Penetration depth, negative while the bodies are still apart.
+        float depth;
+        float inverseMassOne;
+        float inverseMassTwo;
+        float normalMass;
+        float friction;
+        float restitution;
+        //! Normal velocity the solver aims for.
+        float velocityBias;
+        //! Accumulated normal impulse, never negative.
+        float normalImpulse;
+        //! Accumulated friction impulse, tangent to the contact.
+        glm::vec3 frictionImpulse;
+    };
+
+    //! Contacts of the current step, in the step arena.
+    Contact* contacts = nullptr;
+    int numContacts = 0;
+    //! Contacts kept across steps with their accumulated impulses.
+    ContactCache contactCache;
+    //! Bodies that lost a contact to a removed body.
+    std::vector<unsigned> orphans;
+
+    /**
+	 * @brief Add a contact when the bodies touch or will close the gap between them within the step.
+	 */
+    void addContact(PhysxObject* one, PhysxObject* two, glm::vec3 normal, float depth, float dt);
+
+    /**
+	 * @brief Compute the masses and target velocity of a contact.
+	 */
+    void prepareContact(Contact& c, float dt);
+
+    /**
+	 * @brief Apply the impulses of the contact from the previous step.
+	 */
+    void warmStartContact(Contact& c);
+
+    /**
+	 * @brief One iteration of the normal and friction impulses of a contact.
+	 */
+    void solveContact(Contact& c);
+
+    //! Number of spheres simulated in the last step.
+    int activeCount = 0;
+    //! Union-find parent of every object while islands are built.
+    std::vector<int> islandParent;
+    //! Shortest time at rest over the spheres of every island, indexed by island root.
+    std::vector<float> islandSleepTimer;
+
+    /**
+	 * @brief Reflect the velocities of a colliding sphere pair, or the velocity of a sphere off a static body,
+	 * and record the contact.
+	 * 
+	 * @param sphere 
+	 * @param other Sphere or static body.
+	 * @param normal Unit normal pointing from other to sphere.
+	 * @param depth Penetration depth.
+	 */
+    void resolveCollision(PhysxObject* sphere, PhysxObject* other, glm::vec3 normal, float depth);
+
+    void wakeIfSleeping(PhysxObject* p);
+
+    /**
+	 * @brief Move the cached contacts to the new ids, and wake the bodies that lost a contact to a removed body.
+	 */
+    virtual void onObjectsChanged(const std::vector<int>& newIds);
+
+    /**
+	 * @brief Wake the sleeping spheres whose position was changed from outside the simulation.
+	 */
+    void wakeMovedObjects();
+
+    int findIsland(int i);
+
+    /**
+	 * @brief Build the islands of touching spheres and put the ones that stayed at rest long enough to sleep.
+	 * 
+	 * @details Planes do not join islands, so spheres resting on the same wall still sleep independently.
+	 * Sleeping spheres touched by an awake one are woken and join its island.
+	 * 
+	 * @param dt 
+	 */
+    void updateSleeping(float dt);
+
+   public:
     /**
 	 * @brief Test Plane-Sphere Collision
 	 * 
@@ -202,17 +1006,7 @@ class CollisionPhysx : public Physx {
 	 * @return true When collision happens
 	 * @return false When no collision happens
 	 */
-    bool testPlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere) {
-        Plane* p = static_cast<Plane*>(plane->model);
-        Sphere* s = static_cast<Sphere*>(sphere->model);
-        float dotP = glm::dot(p->normal, sphere->velocity);
-        if (dotP > 0) {
-            p->normal = -1.0f * p->normal;
-        }
-        p->updateOdist();
-        float dist = fabs(p->Odist + glm::dot(s->worldPosition, p->normal));
-        return (dist <= s->radius);
-    }
+    bool testPlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere);
 
     /**
 	 * @brief Solver for Plane-Sphere Collision
@@ -220,18 +1014,7 @@ class CollisionPhysx : public Physx {
 	 * @param plane 
 	 * @param sphere 
 	 */
-    void solvePlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere) {
-        Plane* p = static_cast<Plane*>(plane->model);
-        glm::vec3 ncap = p->normal;
-        if (glm::length(sphere->velocity) > 0.0f) {
-            glm::vec3 lcap = glm::normalize(sphere->velocity);
-            float dotnl = glm::dot(ncap, lcap);
-            glm::vec3 rcap = 2 * dotnl * ncap - lcap;
-            rcap = glm::normalize(rcap);
-            sphere->velocity = (-1.0f) * rcap * glm::length(sphere->velocity);
-        }
-        return;
-    }
+    void solvePlaneSphereCollision(PhysxObject* plane, PhysxObject* sphere);
 
     /**
 	 * @brief Test a Sphere-Sphere collision
@@ -241,14 +1024,7 @@ class CollisionPhysx : public Physx {
 	 * @return true When collision happens
 	 * @return false When no collision happens
 	 */
-    bool testSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo) {
-        Sphere* sOne = static_cast<Sphere*>(sphereOne->model);
-        Sphere* sTwo = static_cast<Sphere*>(sphereTwo->model);
-
-        bool cond1 = (glm::distance(sOne->worldPosition, sTwo->worldPosition) <= (sOne->radius + sTwo->radius));
-        bool cond2 = (glm::dot(sTwo->worldPosition - sOne->worldPosition, sphereOne->velocity) >= 0);
-        return cond1 && cond2;
-    }
+    bool testSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo);
 
     /**
 	 * @brief Solver for Sphere-Sphere Collision
@@ -256,18 +1032,7 @@ class CollisionPhysx : public Physx {
 	 * @param sphereOne 
 	 * @param sphereTwo 
 	 */
-    void solveSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo) {
-        Sphere* s1 = static_cast<Sphere*>(sphereOne->model);
-        Sphere* s2 = static_cast<Sphere*>(sphereTwo->model);
-        glm::vec3 d = glm::normalize(s2->worldPosition - s1->worldPosition);
-        glm::vec3 _v1 = sphereOne->velocity - sphereTwo->velocity;
-        glm::vec3 __v2 = (2.0f) * d * (sphereOne->mass / (sphereTwo->mass + sphereOne->mass)) * glm::dot(_v1, d);
-        glm::vec3 u2 = sphereTwo->velocity + __v2;
-        glm::vec3 u1 = (sphereOne->mass * sphereOne->velocity + sphereTwo->mass * sphereTwo->velocity - sphereTwo->mass * u2) / sphereOne->mass;
-        sphereOne->velocity = u1;
-        sphereTwo->velocity = u2;
-        return;
-    }
+    void solveSphereSphereCollision(PhysxObject* sphereOne, PhysxObject* sphereTwo);
 
     /**
 	 * @brief Step sphere when spheres Collide
@@ -275,14 +1040,7 @@ class CollisionPhysx : public Physx {
 	 * @param sphere 
 	 * @param dt 
 	 */
-    void stepSphere(PhysxObject* sphere, float dt) {
-        Sphere* s = static_cast<Sphere*>(sphere->model);
-        s->worldPosition += sphere->velocity * dt;
-        s->_translation[0] = s->worldPosition.x;
-        s->_translation[1] = s->worldPosition.y;
-        s->_translation[2] = s->worldPosition.z;
-        s->updateTransforms();
-    }
+    void stepSphere(PhysxObject* sphere, float dt);
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,111 @@
+/** @file Renderer.cpp
+ *  @brief Implementation of the renderer, see Renderer.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ *  @author G Sathyaram (wreck-count)
+ */
+
+#include <GL/glew.h>
+
+#include <glm/glm/gtc/matrix_transform.hpp>
+#include <chrono>
+
+#include "Renderer.hpp"
+
+Renderer::Renderer(ProjectionType projectionType, PerpectiveProperties perpectiveProperties, glm::mat4 projectionMatrix) : perpectiveProperties{perpectiveProperties} {
+    this->projectionType = projectionType;
+    this->projectionMatrix = projectionMatrix;
+
+    this->camera = Camera();
+    this->shader = Shader();
+    this->scene = Scene();
+}
+
+Renderer::Renderer(const PerpectiveProperties& perpectiveProperties) : perpectiveProperties{perpectiveProperties} {
+    this->projectionType = PERSPECTIVE;
+    this->projectionMatrix = glm::perspective(
+        glm::radians(perpectiveProperties.fieldOfVision),
+        (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
+        perpectiveProperties.nearDistance,
+        perpectiveProperties.farDistance);
+
+    this->camera = Camera();
+    this->shader = Shader();
+    this->scene = Scene();
+}
+
+Renderer::Renderer(const PerpectiveProperties& perpectiveProperties, float stepSize, glm::vec3 cameraPosition) : perpectiveProperties{perpectiveProperties} {
+    this->projectionType = PERSPECTIVE;
+    this->projectionMatrix = glm::perspective(
+        glm::radians(perpectiveProperties.fieldOfVision),
+        (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
+        perpectiveProperties.nearDistance,
+        perpectiveProperties.farDistance);
+
+    this->camera = Camera(cameraPosition);
+    this->shader = Shader();
+    this->scene = Scene();
+    this->timeStep = stepSize;
+}
+
+void Renderer::renderAll() {
+    this->updateLighting();
+    this->updateVPMatrices();
+    this->updateCameraPosition();
+
+    if (scene.isPhysicsOn && scene.physx != nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        if (scene.history != nullptr) {
+            scene.history->step(this->timeStep);
+        } else {
+            scene.physx->step(this->timeStep);
+        }
+        this->stepMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const std::vector<Model*>& models = this->scene.getModels();
+    Model::composeModelMatrices(models.data(), models.size());
+    this->scene.updateWorldMatrices();
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        const Model* model = models[i];
+        if (model->visibility) {
+            this->renderModel(model, this->scene.getWorldMatrix(i));
+        }
+    }
+}
+
+void Renderer::updateLighting() const {
+    const Light light = this->scene.light;
+    this->shader.setLighting(light.getLightPosition(), light.getLightAmbient(), light.getLightDiffuse(), light.getLightSpecular());
+}
+
+void Renderer::updateVPMatrices() const {
+    this->shader.setViewMatrix(camera.getViewMatrix());
+    this->shader.setProjectionMatrix(this->projectionMatrix);
+}
+
+void Renderer::renderModel(const Model* model, const glm::mat4& worldMatrix) const {
+    this->shader.setModelMatrix(worldMatrix);
+    for (unsigned int i = 0; i < model->numMeshes; ++i) {
+        const Mesh& mesh = model->meshes[i];
+        this->shader.setMaterial(
+            mesh.material.getMaterialAmbient(),
+            mesh.material.getMaterialDiffuse(),
+            mesh.material.getMaterialSpecular(),
+            mesh.material.getMaterialShininess());
+
+        unsigned int meshVAO = mesh.getVertexArrayObjectPointer();
+        glBindVertexArray(meshVAO);
+        glDrawElements(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+    }
+}
+
+void Renderer::updateProjectionMatrix(float fieldOfVision) {
+    this->perpectiveProperties.fieldOfVision = fieldOfVision;
+    this->projectionMatrix = glm::perspective(
+        glm::radians(perpectiveProperties.fieldOfVision),
+        (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
+        perpectiveProperties.nearDistance,
+        perpectiveProperties.farDistance);
+}
@@ -1,4 +1,4 @@
-/** @file Renderer.cpp
+/** @file Renderer.hpp
  *  @brief Class definition for a Renderer.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -8,21 +8,13 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/matrix_transform.hpp>
-#include <vector>
 
 #include "Camera.hpp"
 #include "Shader.hpp"
 #include "Scene.hpp"
 #include "Model.hpp"
 
-using namespace std;
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -91,6 +83,9 @@ class Renderer {
 
     float timeStep = 0.025f;
 
+    //! @brief Wall clock time the last physics step of renderAll() took, in milliseconds.
+    double stepMilliseconds = 0.0;
+
     /**
 	 * @brief Construct a new Renderer object
 	 * 
@@ -98,32 +93,14 @@ class Renderer {
 	 * @param perpectiveProperties 
 	 * @param projectionMatrix 
 	 */
-    Renderer(ProjectionType projectionType, PerpectiveProperties perpectiveProperties, glm::mat4 projectionMatrix) : perpectiveProperties{perpectiveProperties} {
-        this->projectionType = projectionType;
-        this->projectionMatrix = projectionMatrix;
-
-        this->camera = Camera();
-        this->shader = Shader();
-        this->scene = Scene();
-    }
+    Renderer(ProjectionType projectionType, PerpectiveProperties perpectiveProperties, glm::mat4 projectionMatrix);
 
     /**
 	 * @brief Construct a new Renderer object
 	 * 
 	 * @param perpectiveProperties 
 	 */
-    Renderer(const PerpectiveProperties& perpectiveProperties) : perpectiveProperties{perpectiveProperties} {
-        this->projectionType = PERSPECTIVE;
-        this->projectionMatrix = glm::perspective(
-            glm::radians(perpectiveProperties.fieldOfVision),
-            (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
-            perpectiveProperties.nearDistance,
-            perpectiveProperties.farDistance);
-
-        this->camera = Camera();
-        this->shader = Shader();
-        this->scene = Scene();
-    }
+    Renderer(const PerpectiveProperties& perpectiveProperties);
 
     /**
 	 * @brief Construct a new Renderer object
@@ -132,54 +109,22 @@ class Renderer {
 	 * @param stepSize 
 	 * @param cameraPosition 
 	 */
-    Renderer(const PerpectiveProperties& perpectiveProperties, float stepSize, glm::vec3 cameraPosition) : perpectiveProperties{perpectiveProperties} {
-        this->projectionType = PERSPECTIVE;
-        this->projectionMatrix = glm::perspective(
-            glm::radians(perpectiveProperties.fieldOfVision),
-            (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
-            perpectiveProperties.nearDistance,
-            perpectiveProperties.farDistance);
-
-        this->camera = Camera(cameraPosition);
-        this->shader = Shader();
-        this->scene = Scene();
-        this->timeStep = stepSize;
-    }
+    Renderer(const PerpectiveProperties& perpectiveProperties, float stepSize, glm::vec3 cameraPosition);
 
     /**
 	* @brief Render the current the frame.
 	*/
-    void renderAll() {
-        this->updateLighting();
-        this->updateVPMatrices();
-        this->updateCameraPosition();
-
-        if (scene.isPhysicsOn && scene.physx != nullptr) {
-            scene.physx->step(this->timeStep);
-        }
-
-        for (const Model* model : this->scene.models) {
-            if (model->visibility) {
-                this->renderModel(model);
-            }
-        }
-    }
+    void renderAll();
 
     /**
 	 * @brief Update the lights from the scenes to the shaders.
 	 */
-    void updateLighting() const {
-        const Light light = this->scene.light;
-        this->shader.setLighting(light.getLightPosition(), light.getLightAmbient(), light.getLightDiffuse(), light.getLightSpecular());
-    }
+    void updateLighting() const;
 
     /**
 	 * @brief Update the View and Projection matrices to the shaders.
 	 */
-    void updateVPMatrices() const {
-        this->shader.setViewMatrix(camera.getViewMatrix());
-        this->shader.setProjectionMatrix(this->projectionMatrix);
-    }
+    void updateVPMatrices() const;
 
     /**
 	 * @brief Update the camera position to the shaders.
@@ -194,36 +139,24 @@ class Renderer {
 	 * @param model 
 	 */
     void renderModel(const Model* model) const {
-        this->shader.setModelMatrix(model->getModelMatrix());
-        for (unsigned int i = 0; i < model->numMeshes; ++i) {
-            Mesh mesh = model->meshes[i];
-            this->shader.setMaterial(
-                mesh.material.getMaterialAmbient(),
-                mesh.material.getMaterialDiffuse(),
-                mesh.material.getMaterialSpecular(),
-                mesh.material.getMaterialShininess());
-
-            unsigned int meshVAO = mesh.getVertexArrayObjectPointer();
-            glBindVertexArray(meshVAO);
-            glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
-        }
+        this->renderModel(model, model->getModelMatrix());
     }
 
+    /**
+	 * @brief Update the aspects of the provided model to the shaders and draw it with the given world matrix.
+	 *
+	 * @param model
+	 * @param worldMatrix
+	 */
+    void renderModel(const Model* model, const glm::mat4& worldMatrix) const;
+
     /** @brief updateProjectionMatrix - Update Feild of Vision of the Perspective Projection.
  	*
  	* @param fieldOfVision The desired angle value for field of vison. Provide as a float.
 	* 
  	* @return void
  	*/
-    void updateProjectionMatrix(float fieldOfVision) {
-        this->perpectiveProperties.fieldOfVision = fieldOfVision;
-        this->projectionMatrix = glm::perspective(
-            glm::radians(perpectiveProperties.fieldOfVision),
-            (perpectiveProperties.screenWidth / perpectiveProperties.screenHeight),
-            perpectiveProperties.nearDistance,
-            perpectiveProperties.farDistance);
-    }
+    void updateProjectionMatrix(float fieldOfVision);
 
     /**
 	 * @brief Get the currently used Scene.
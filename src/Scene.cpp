@@ -0,0 +1,107 @@
+/** @file Scene.cpp
+ *  @brief Implementation of the transform hierarchy of a Scene, see Scene.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include "Scene.hpp"
+
+bool Scene::contains(const Model* model) const {
+    return model != nullptr && model->sceneIndex >= 0 && (std::size_t)model->sceneIndex < this->models.size() && this->models[model->sceneIndex] == model;
+}
+
+bool Scene::addModel(Model* model, Model* parent) {
+    int parentIndex = -1;
+    if (parent != nullptr) {
+        if (!this->contains(parent)) {
+            return false;
+        }
+        parentIndex = parent->sceneIndex;
+        ++this->numAttached;
+    }
+    // Added after its parent, so the list stays in order.
+    model->sceneIndex = this->models.size();
+    this->models.push_back(model);
+    this->parents.push_back(parentIndex);
+    this->worldMatrices.push_back(model->getModelMatrix());
+    // Differs from the version of the model, so the first pass updates it.
+    this->seenVersions.push_back(model->transformVersion - 1);
+    this->updated.push_back(0);
+    return true;
+}
+
+bool Scene::removeModel(Model* model) {
+    if (!this->contains(model)) {
+        return false;
+    }
+    std::size_t index = model->sceneIndex;
+
+    if (this->numAttached == 0) {
+        std::size_t last = this->models.size() - 1;
+        this->models[index] = this->models[last];
+        this->models[index]->sceneIndex = index;
+        this->worldMatrices[index] = this->worldMatrices[last];
+        this->seenVersions[index] = this->seenVersions[last];
+        this->models.pop_back();
+        this->parents.pop_back();
+        this->worldMatrices.pop_back();
+        this->seenVersions.pop_back();
+        this->updated.pop_back();
+        model->sceneIndex = -1;
+        return true;
+    }
+
+    // Children come after their parents, so one pass from the front finds the whole subtree.
+    std::vector<int> newIndex(this->models.size(), -1);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < this->models.size(); ++i) {
+        int parent = this->parents[i];
+        if (i == index || (parent >= 0 && newIndex[parent] < 0)) {
+            this->numAttached -= (parent >= 0) ? 1 : 0;
+            this->models[i]->sceneIndex = -1;
+            continue;
+        }
+        newIndex[i] = kept;
+        this->models[kept] = this->models[i];
+        this->models[kept]->sceneIndex = kept;
+        this->parents[kept] = (parent >= 0) ? newIndex[parent] : -1;
+        this->worldMatrices[kept] = this->worldMatrices[i];
+        this->seenVersions[kept] = this->seenVersions[i];
+        ++kept;
+    }
+    this->models.resize(kept);
+    this->parents.resize(kept);
+    this->worldMatrices.resize(kept);
+    this->seenVersions.resize(kept);
+    this->updated.resize(kept);
+    return true;
+}
+
+void Scene::clearModels() {
+    for (Model* model : this->models) {
+        model->sceneIndex = -1;
+    }
+    this->models.clear();
+    this->parents.clear();
+    this->worldMatrices.clear();
+    this->seenVersions.clear();
+    this->updated.clear();
+    this->numAttached = 0;
+}
+
+void Scene::updateWorldMatrices() {
+    for (std::size_t i = 0; i < this->models.size(); ++i) {
+        const Model* model = this->models[i];
+        int parent = this->parents[i];
+        bool changed = (model->transformVersion != this->seenVersions[i]) || (parent >= 0 && this->updated[parent]);
+        this->updated[i] = changed ? 1 : 0;
+        if (changed) {
+            this->seenVersions[i] = model->transformVersion;
+            if (parent >= 0) {
+                this->worldMatrices[i] = this->worldMatrices[parent] * model->getModelMatrix();
+            } else {
+                this->worldMatrices[i] = model->getModelMatrix();
+            }
+        }
+    }
+}
@@ -1,15 +1,28 @@
-/** @file Scene.cpp
+/** @file Scene.hpp
  *  @brief Class definition of a 3D Scene.
  *
+ *  @details Models can be attached to a parent model, e.g. a moon to its planet, and then move
+ *  with it. The models are kept in a flat list in which every parent comes before its children,
+ *  so the world matrices are updated in one pass from the front, see updateWorldMatrices().
+ *  Every model remembers its index in the list, so a model is found without a search. A model can
+ *  be in one scene at a time.
+ *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
  */
 
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <glm/glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "FMM.hpp"
 #include "Light.hpp"
 #include "Model.hpp"
+#include "NBody.hpp"
 #include "Physics.hpp"
+#include "Snapshot.hpp"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,21 +35,21 @@ class Scene {
    public:
     //! The light used in the scene
     Light light;
-    //! List of models present in the scene.
-    std::vector<Model*> models;
 
     //! Flag variable to decide whether physics simulation is rendered.
     bool isPhysicsOn;
     //! The type of Physics Simulator to use for the current scene.
     Physx* physx = nullptr;
+    //! Optional recorder of the simulation used for rewinding. Steps the simulation in place of physx when attached.
+    SimulationHistory* history = nullptr;
 
     /**
 	 * @brief Construct a new Scene object
 	 */
     Scene() {
         this->light = Light();
-        this->models = std::vector<Model*>();
         this->isPhysicsOn = false;
+        this->numAttached = 0;
     }
 
     /**
@@ -45,7 +58,80 @@ class Scene {
 	 * @param model 
 	 */
     void addModel(Model* model) {
-        this->models.push_back(model);
+        this->addModel(model, nullptr);
+    }
+
+    /**
+	 * @brief Adds a Model to the scene, attached to a parent model.
+	 * @details The transforms of the model are relative to its parent: the world matrix of the model
+	 * is the world matrix of the parent times its own Model matrix. The simulations work in world
+	 * space, so physics bodies should not be attached to a parent.
+	 *
+	 * @param model
+	 * @param parent A model already in the scene, or nullptr.
+	 * @return true If the model was added, false if the parent is not in the scene.
+	 */
+    bool addModel(Model* model, Model* parent);
+
+    /**
+	 * @brief Removes a Model from the scene, together with the models attached to it.
+	 * @details Without attached models in the scene the last model takes its place in the list, which
+	 * takes constant time. Otherwise the order of the remaining models is kept.
+	 * 
+	 * @param model 
+	 * @return true If the model was in the scene.
+	 */
+    bool removeModel(Model* model);
+
+    /**
+	 * @brief Removes all the models from the scene.
+	 */
+    void clearModels();
+
+    /**
+	 * @brief Get the models present in the scene, every parent before its children.
+	 * @details Read only, models are added and removed through the scene so the per model lists stay in step.
+	 *
+	 * @return const std::vector<Model*>&
+	 */
+    const std::vector<Model*>& getModels() const {
+        return this->models;
+    }
+
+    /**
+	 * @brief Whether the model is in this scene, from the index it remembers.
+	 *
+	 * @param model
+	 * @return true If the model is in the scene, at index model->sceneIndex.
+	 */
+    bool contains(const Model* model) const;
+
+    /**
+	 * @brief Get the index of the parent of the i-th model.
+	 *
+	 * @param i
+	 * @return int -1 if the model is not attached to a parent.
+	 */
+    int getParent(std::size_t i) const {
+        return this->parents[i];
+    }
+
+    /**
+	 * @brief Update the world matrices of the models whose transforms or whose parents changed.
+	 * @details One pass over the models from the front: a model is updated when its transformVersion
+	 * differs from the one seen last time or when its parent was updated in this pass, so unchanged
+	 * subtrees are skipped. Call after composing the Model matrices, the renderer does both.
+	 */
+    void updateWorldMatrices();
+
+    /**
+	 * @brief Get the world matrix of the i-th model as of the last updateWorldMatrices().
+	 *
+	 * @param i
+	 * @return const glm::mat4&
+	 */
+    const glm::mat4& getWorldMatrix(std::size_t i) const {
+        return this->worldMatrices[i];
     }
 
     /**
@@ -65,6 +151,47 @@ class Scene {
     void attachPhysics(CollisionPhysx* physx) {
         this->physx = physx;
     }
+
+    /**
+	 * @brief Attaches N-body Physics Simulator to the scene.
+	 * 
+	 * @param physx 
+	 */
+    void attachPhysics(NBodyPhysx* physx) {
+        this->physx = physx;
+    }
+
+    /**
+	 * @brief Attaches Fast Multipole Method Physics Simulator to the scene.
+	 * 
+	 * @param physx 
+	 */
+    void attachPhysics(FMMPhysx* physx) {
+        this->physx = physx;
+    }
+
+    /**
+	 * @brief Attaches a recorder for the attached Physics Simulator to the scene.
+	 * 
+	 * @param history 
+	 */
+    void attachHistory(SimulationHistory* history) {
+        this->history = history;
+    }
+
+   private:
+    //! List of models present in the scene, every parent before its children.
+    std::vector<Model*> models;
+    //! Index of the parent of every model, -1 for none.
+    std::vector<int> parents;
+    //! World matrix of every model.
+    std::vector<glm::mat4> worldMatrices;
+    //! transformVersion of every model when its world matrix was last updated.
+    std::vector<std::uint32_t> seenVersions;
+    //! Whether the world matrix of the model was updated in the current pass.
+    std::vector<unsigned char> updated;
+    //! Number of models attached to a parent.
+    std::size_t numAttached;
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,761 @@
+/** @file SceneFile.cpp
+ *  @brief Implementation of reading and writing scene files, see SceneFile.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SceneFile.hpp"
+
+bool SceneData::isValid() const {
+    if (this->header->engine > SCENE_ENGINE_FMM) {
+        return false;
+    }
+    // Paths are read up to their null, so the table has to end with one.
+    if (this->header->stringsSize > 0 && this->strings[this->header->stringsSize - 1] != '\0') {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < this->header->numModels; ++i) {
+        const SceneModelRecord& model = this->models[i];
+        if (model.type > CAPSULE_MODEL || (model.pathOffset != SCENE_NO_PATH && model.pathOffset >= this->header->stringsSize)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < this->header->numBodies; ++i) {
+        const SceneBodyRecord& body = this->bodies[i];
+        if (body.model >= this->header->numModels || body.shape >= (std::uint32_t)NUM_PHYSX_SHAPES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SceneDocument::SceneDocument() {
+    std::memset(&this->header, 0, sizeof(SceneFileHeader));
+    std::memcpy(this->header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC));
+    this->header.version = SCENE_FILE_VERSION;
+    this->header.engine = SCENE_ENGINE_NONE;
+    this->header.timeStep = 0.025f;
+    this->setLight(Light());
+}
+
+SceneData SceneDocument::data() {
+    this->header.numModels = this->models.size();
+    this->header.numBodies = this->bodies.size();
+    this->header.stringsSize = this->strings.size();
+
+    SceneData data;
+    data.header = &this->header;
+    data.models = this->models.data();
+    data.bodies = this->bodies.data();
+    data.strings = this->strings.data();
+    return data;
+}
+
+void SceneDocument::setLight(const Light& light) {
+    for (int i = 0; i < 3; ++i) {
+        this->header.light.position[i] = light._position[i];
+        this->header.light.ambient[i] = light._ambient[i];
+        this->header.light.diffuse[i] = light._diffuse[i];
+        this->header.light.specular[i] = light._specular[i];
+    }
+}
+
+SceneModelRecord& SceneDocument::addModel(ModelType type, const std::string& path, float radius, unsigned resolution) {
+    SceneModelRecord record;
+    std::memset(&record, 0, sizeof(SceneModelRecord));
+    record.type = type;
+    record.pathOffset = path.empty() ? SCENE_NO_PATH : this->addString(path);
+    record.radius = radius;
+    record.resolution = resolution;
+    record.scale[0] = record.scale[1] = record.scale[2] = 1.0f;
+    record.visible = 1u;
+    this->models.push_back(record);
+    return this->models.back();
+}
+
+SceneBodyRecord& SceneDocument::addBody(std::uint32_t model, PhysxShape shape, float mass, glm::vec3 velocity, std::uint32_t flags) {
+    SceneBodyRecord record;
+    std::memset(&record, 0, sizeof(SceneBodyRecord));
+    record.model = model;
+    record.shape = shape;
+    record.mass = mass;
+    record.velocity[0] = velocity.x;
+    record.velocity[1] = velocity.y;
+    record.velocity[2] = velocity.z;
+    record.flags = flags;
+    this->bodies.push_back(record);
+    return this->bodies.back();
+}
+
+void SceneDocument::capture(const Scene& scene, float timeStep) {
+    this->models.clear();
+    this->bodies.clear();
+    this->strings.clear();
+
+    this->setLight(scene.light);
+    this->header.physicsOn = scene.isPhysicsOn ? 1u : 0u;
+    this->header.timeStep = timeStep;
+    this->header.engine = SCENE_ENGINE_NONE;
+
+    for (const Model* model : scene.getModels()) {
+        float radius = 0.0f;
+        unsigned resolution = 0;
+        if (model->type == SPHERE_MODEL) {
+            radius = static_cast<const Sphere*>(model)->radius;
+            resolution = static_cast<const Sphere*>(model)->resolution;
+        } else if (model->type == PLANE_MODEL) {
+            resolution = static_cast<const Plane*>(model)->generatedScale;
+        } else if (model->type == BOX_MODEL) {
+            radius = static_cast<const Box*>(model)->halfSize;
+        } else if (model->type == CAPSULE_MODEL) {
+            radius = static_cast<const Capsule*>(model)->radius;
+            resolution = static_cast<const Capsule*>(model)->resolution;
+        }
+
+        SceneModelRecord& record = this->addModel(model->type, model->sourcePath, radius, resolution);
+        if (model->type == CAPSULE_MODEL) {
+            record.halfHeight = static_cast<const Capsule*>(model)->halfHeight;
+        }
+        for (int i = 0; i < 3; ++i) {
+            record.translation[i] = model->_translation[i];
+            record.rotation[i] = model->_rotation[i];
+            record.scale[i] = model->_scale[i];
+        }
+        record.visible = model->visibility ? 1u : 0u;
+
+        // Imported models with several meshes keep the materials from their own files.
+        if (model->meshes.size() == 1) {
+            const Material& material = model->meshes[0].material;
+            record.hasMaterial = 1u;
+            for (int i = 0; i < 3; ++i) {
+                record.ambient[i] = material.getMaterialAmbient()[i];
+                record.diffuse[i] = material.getMaterialDiffuse()[i];
+                record.specular[i] = material.getMaterialSpecular()[i];
+            }
+            record.shininess = material.getMaterialShininess();
+        }
+    }
+
+    if (scene.physx == nullptr) {
+        return;
+    }
+
+    switch (scene.physx->getEngine()) {
+        case COLLISION_ENGINE:
+            this->header.engine = SCENE_ENGINE_COLLISION;
+            break;
+        case SOLAR_SYSTEM_ENGINE:
+            this->header.engine = SCENE_ENGINE_SOLAR_SYSTEM;
+            break;
+        case NBODY_ENGINE:
+            this->header.engine = SCENE_ENGINE_NBODY;
+            break;
+        case FMM_ENGINE:
+            this->header.engine = SCENE_ENGINE_FMM;
+            break;
+    }
+    for (const PhysxObject* object : scene.physx->getObjects()) {
+        if (!scene.contains(object->model)) {
+            std::cout << "SCENE::WARNING::Skipping a physics body whose model is not in the scene." << std::endl;
+            continue;
+        }
+        std::uint32_t model = object->model->sceneIndex;
+
+        std::uint32_t flags = 0u;
+        flags |= object->gravityEnabled ? SCENE_BODY_GRAVITY : 0u;
+        flags |= object->airResistanceEnabled ? SCENE_BODY_AIR_RESISTANCE : 0u;
+        this->addBody(model, object->shape, object->mass, object->velocity, flags);
+    }
+}
+
+bool SceneDocument::saveBinary(const std::string& path) {
+    this->data();
+    this->header.modelsOffset = alignOffset(sizeof(SceneFileHeader));
+    this->header.bodiesOffset = alignOffset(this->header.modelsOffset + this->models.size() * sizeof(SceneModelRecord));
+    this->header.stringsOffset = alignOffset(this->header.bodiesOffset + this->bodies.size() * sizeof(SceneBodyRecord));
+
+    std::vector<char> buffer(this->header.stringsOffset + this->strings.size(), 0);
+    std::memcpy(&buffer[0], &this->header, sizeof(SceneFileHeader));
+    if (!this->models.empty()) {
+        std::memcpy(&buffer[this->header.modelsOffset], this->models.data(), this->models.size() * sizeof(SceneModelRecord));
+    }
+    if (!this->bodies.empty()) {
+        std::memcpy(&buffer[this->header.bodiesOffset], this->bodies.data(), this->bodies.size() * sizeof(SceneBodyRecord));
+    }
+    if (!this->strings.empty()) {
+        std::memcpy(&buffer[this->header.stringsOffset], this->strings.data(), this->strings.size());
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cout << "SCENE::ERROR::Could not open " << path << " for writing." << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    std::fclose(file);
+    return written;
+}
+
+bool SceneDocument::saveText(const std::string& path) {
+    if (!this->data().isValid()) {
+        std::cout << "SCENE::ERROR::The scene has records out of range, not writing " << path << std::endl;
+        return false;
+    }
+
+    std::string out;
+    out.reserve(128 + this->models.size() * 160 + this->bodies.size() * 48);
+
+    static const char* engines[] = {"none", "collision", "solar_system", "nbody", "fmm"};
+    static const char* shapes[] = {"plane", "sphere", "box", "capsule", "mesh"};
+
+    out += "# MyBlender scene\n";
+    out += std::string("engine ") + engines[this->header.engine] + "\n";
+    out += std::string("physics ") + (this->header.physicsOn ? "on" : "off") + "\n";
+    out += "timestep";
+    appendFloats(out, &this->header.timeStep, 1);
+    const SceneLightRecord& l = this->header.light;
+    out += "\nlight";
+    appendFloats(out, l.position, 3);
+    appendFloats(out, l.ambient, 3);
+    appendFloats(out, l.diffuse, 3);
+    appendFloats(out, l.specular, 3);
+    out += "\n";
+
+    // Bodies are written right after the model they belong to, so bucket them by model first.
+    std::vector<std::uint32_t> firstBody(this->models.size() + 1, 0u);
+    for (const SceneBodyRecord& b : this->bodies) {
+        ++firstBody[b.model + 1];
+    }
+    for (std::size_t i = 1; i < firstBody.size(); ++i) {
+        firstBody[i] += firstBody[i - 1];
+    }
+    std::vector<std::uint32_t> bodyOrder(this->bodies.size());
+    std::vector<std::uint32_t> next(firstBody.begin(), firstBody.end() - 1);
+    for (std::uint32_t i = 0; i < this->bodies.size(); ++i) {
+        bodyOrder[next[this->bodies[i].model]++] = i;
+    }
+
+    for (std::size_t i = 0; i < this->models.size(); ++i) {
+        const SceneModelRecord& m = this->models[i];
+        const char* path = (m.pathOffset == SCENE_NO_PATH) ? nullptr : this->strings.c_str() + m.pathOffset;
+
+        out += "\n";
+        if (m.type == SPHERE_MODEL) {
+            out += "sphere";
+            appendFloats(out, &m.radius, 1);
+            out += " " + std::to_string(m.resolution);
+        } else if (m.type == PLANE_MODEL && path == nullptr) {
+            out += "plane " + std::to_string(m.resolution);
+        } else if (m.type == BOX_MODEL) {
+            out += "box";
+            appendFloats(out, &m.radius, 1);
+        } else if (m.type == CAPSULE_MODEL) {
+            out += "capsule";
+            appendFloats(out, &m.radius, 1);
+            appendFloats(out, &m.halfHeight, 1);
+            out += " " + std::to_string(m.resolution);
+        } else {
+            std::string file = path ? path : "";
+            // Quoted, a # in the path does not start a comment and outer spaces are kept.
+            if (file.find('#') != std::string::npos || (!file.empty() && (file.front() == ' ' || file.back() == ' ' || file.front() == '"'))) {
+                file = "\"" + file + "\"";
+            }
+            out += std::string((m.type == PLANE_MODEL) ? "plane_file " : "mesh ") + file;
+        }
+        out += "\ntranslation";
+        appendFloats(out, m.translation, 3);
+        out += "\nrotation";
+        appendFloats(out, m.rotation, 3);
+        out += "\nscale";
+        appendFloats(out, m.scale, 3);
+        out += "\n";
+        if (m.hasMaterial) {
+            out += "material";
+            appendFloats(out, m.ambient, 3);
+            appendFloats(out, m.diffuse, 3);
+            appendFloats(out, m.specular, 3);
+            appendFloats(out, &m.shininess, 1);
+            out += "\n";
+        }
+        if (!m.visible) {
+            out += "hidden\n";
+        }
+
+        for (std::uint32_t k = firstBody[i]; k < firstBody[i + 1]; ++k) {
+            const SceneBodyRecord& b = this->bodies[bodyOrder[k]];
+            out += std::string("body ") + shapes[b.shape];
+            appendFloats(out, &b.mass, 1);
+            appendFloats(out, b.velocity, 3);
+            out += (b.flags & SCENE_BODY_GRAVITY) ? " gravity" : "";
+            out += (b.flags & SCENE_BODY_AIR_RESISTANCE) ? " air" : "";
+            out += "\n";
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cout << "SCENE::ERROR::Could not open " << path << " for writing." << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    std::fclose(file);
+    return written;
+}
+
+bool SceneDocument::loadText(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        std::cout << "SCENE::ERROR::Could not open " << path << std::endl;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    *this = SceneDocument();
+    std::size_t lineNumber = 0;
+    const char* cursor = text.c_str();
+    const char* end = cursor + text.size();
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        ++lineNumber;
+        if (!this->parseLine(cursor, lineEnd)) {
+            std::cout << "SCENE::ERROR::" << path << ":" << lineNumber << ": " << std::string(cursor, lineEnd) << std::endl;
+            return false;
+        }
+        cursor = lineEnd + 1;
+    }
+    return true;
+}
+
+void SceneDocument::appendFloats(std::string& out, const float* values, int count) {
+    char buffer[32];
+    for (int i = 0; i < count; ++i) {
+        buffer[0] = ' ';
+        std::to_chars_result result = std::to_chars(buffer + 1, buffer + sizeof(buffer), values[i]);
+        out.append(buffer, result.ptr);
+    }
+}
+
+std::uint32_t SceneDocument::addString(const std::string& s) {
+    std::uint32_t offset = this->strings.size();
+    this->strings += s;
+    this->strings.push_back('\0');
+    return offset;
+}
+
+const char* SceneDocument::skipSpaces(const char* c, const char* end) {
+    while (c < end && (*c == ' ' || *c == '\t' || *c == '\r')) {
+        ++c;
+    }
+    return c;
+}
+
+bool SceneDocument::readFloats(const char*& c, const char* end, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        c = skipSpaces(c, end);
+        std::from_chars_result result = std::from_chars(c, end, out[i]);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        c = result.ptr;
+    }
+    return true;
+}
+
+bool SceneDocument::readWord(const char*& c, const char* end, std::string& word) {
+    c = skipSpaces(c, end);
+    const char* start = c;
+    while (c < end && *c != ' ' && *c != '\t' && *c != '\r' && *c != '#') {
+        ++c;
+    }
+    word.assign(start, c);
+    return !word.empty();
+}
+
+bool SceneDocument::readRest(const char* c, const char* end, std::string& rest) {
+    c = skipSpaces(c, end);
+    if (c < end && *c == '"') {
+        const char* close = static_cast<const char*>(std::memchr(c + 1, '"', end - c - 1));
+        if (close == nullptr) {
+            return false;
+        }
+        rest.assign(c + 1, close);
+        c = skipSpaces(close + 1, end);
+        return c == end || *c == '#';
+    }
+    const char* comment = static_cast<const char*>(std::memchr(c, '#', end - c));
+    if (comment != nullptr) {
+        end = comment;
+    }
+    while (end > c && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+        --end;
+    }
+    rest.assign(c, end);
+    return true;
+}
+
+bool SceneDocument::toCount(float value, unsigned& count) {
+    // Casting a negative or too large float to unsigned is undefined.
+    if (!(value >= 0.0f && value <= 4294967040.0f)) {
+        return false;
+    }
+    count = static_cast<unsigned>(value);
+    return true;
+}
+
+bool SceneDocument::parseLine(const char* c, const char* end) {
+    std::string keyword;
+    c = skipSpaces(c, end);
+    if (c == end || *c == '#') {
+        return true;
+    }
+    readWord(c, end, keyword);
+
+    if (keyword == "engine") {
+        std::string engine;
+        readWord(c, end, engine);
+        if (engine == "none") {
+            this->header.engine = SCENE_ENGINE_NONE;
+        } else if (engine == "collision") {
+            this->header.engine = SCENE_ENGINE_COLLISION;
+        } else if (engine == "solar_system") {
+            this->header.engine = SCENE_ENGINE_SOLAR_SYSTEM;
+        } else if (engine == "nbody") {
+            this->header.engine = SCENE_ENGINE_NBODY;
+        } else if (engine == "fmm") {
+            this->header.engine = SCENE_ENGINE_FMM;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (keyword == "physics") {
+        std::string state;
+        readWord(c, end, state);
+        this->header.physicsOn = (state == "on") ? 1u : 0u;
+        return state == "on" || state == "off";
+    }
+    if (keyword == "timestep") {
+        return readFloats(c, end, &this->header.timeStep, 1);
+    }
+    if (keyword == "light") {
+        SceneLightRecord& l = this->header.light;
+        return readFloats(c, end, l.position, 3) && readFloats(c, end, l.ambient, 3) &&
+               readFloats(c, end, l.diffuse, 3) && readFloats(c, end, l.specular, 3);
+    }
+    if (keyword == "sphere") {
+        float values[2];
+        unsigned resolution;
+        if (!readFloats(c, end, values, 2) || !toCount(values[1], resolution)) {
+            return false;
+        }
+        this->addModel(SPHERE_MODEL, "", values[0], resolution);
+        return true;
+    }
+    if (keyword == "plane") {
+        float scale;
+        unsigned count;
+        if (!readFloats(c, end, &scale, 1) || !toCount(scale, count)) {
+            return false;
+        }
+        this->addModel(PLANE_MODEL, "", 0.0f, count);
+        return true;
+    }
+    if (keyword == "box") {
+        float halfSize;
+        if (!readFloats(c, end, &halfSize, 1)) {
+            return false;
+        }
+        this->addModel(BOX_MODEL, "", halfSize);
+        return true;
+    }
+    if (keyword == "capsule") {
+        float values[3];
+        unsigned resolution;
+        if (!readFloats(c, end, values, 3) || !toCount(values[2], resolution)) {
+            return false;
+        }
+        this->addModel(CAPSULE_MODEL, "", values[0], resolution).halfHeight = values[1];
+        return true;
+    }
+    if (keyword == "mesh" || keyword == "plane_file") {
+        std::string path;
+        if (!readRest(c, end, path) || path.empty()) {
+            return false;
+        }
+        this->addModel((keyword == "mesh") ? GENERIC_MODEL : PLANE_MODEL, path);
+        return true;
+    }
+
+    // Everything below applies to the last model.
+    if (this->models.empty()) {
+        return false;
+    }
+    SceneModelRecord& model = this->models.back();
+    if (keyword == "translation") {
+        return readFloats(c, end, model.translation, 3);
+    }
+    if (keyword == "rotation") {
+        return readFloats(c, end, model.rotation, 3);
+    }
+    if (keyword == "scale") {
+        return readFloats(c, end, model.scale, 3);
+    }
+    if (keyword == "material") {
+        model.hasMaterial = 1u;
+        return readFloats(c, end, model.ambient, 3) && readFloats(c, end, model.diffuse, 3) &&
+               readFloats(c, end, model.specular, 3) && readFloats(c, end, &model.shininess, 1);
+    }
+    if (keyword == "hidden") {
+        model.visible = 0u;
+        return true;
+    }
+    if (keyword == "body") {
+        static const char* shapes[] = {"plane", "sphere", "box", "capsule", "mesh"};
+        std::string word;
+        float values[4];
+        readWord(c, end, word);
+        int shape = 0;
+        while (shape < NUM_PHYSX_SHAPES && word != shapes[shape]) {
+            ++shape;
+        }
+        if (shape == NUM_PHYSX_SHAPES || !readFloats(c, end, values, 4)) {
+            return false;
+        }
+        std::uint32_t flags = 0u;
+        std::string flag;
+        while (readWord(c, end, flag)) {
+            if (flag == "gravity") {
+                flags |= SCENE_BODY_GRAVITY;
+            } else if (flag == "air") {
+                flags |= SCENE_BODY_AIR_RESISTANCE;
+            } else {
+                return false;
+            }
+        }
+        this->addBody(this->models.size() - 1, static_cast<PhysxShape>(shape), values[0], glm::vec3(values[1], values[2], values[3]), flags);
+        return true;
+    }
+    return false;
+}
+
+bool SceneFileView::open(const std::string& path) {
+    this->close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "SCENE::ERROR::Could not open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(SceneFileHeader)) {
+        std::cout << "SCENE::ERROR::" << path << " is too small to be a scene file." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    this->size = st.st_size;
+    void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cout << "SCENE::ERROR::Could not map " << path << std::endl;
+        this->size = 0;
+        return false;
+    }
+    this->mapping = static_cast<const char*>(mapping);
+
+    const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(this->mapping);
+    bool valid = std::memcmp(header->magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) == 0 &&
+                 header->version == SCENE_FILE_VERSION &&
+                 fitsIn(header->modelsOffset, header->numModels, sizeof(SceneModelRecord), this->size) &&
+                 fitsIn(header->bodiesOffset, header->numBodies, sizeof(SceneBodyRecord), this->size) &&
+                 fitsIn(header->stringsOffset, header->stringsSize, 1, this->size) &&
+                 header->modelsOffset % alignof(SceneModelRecord) == 0 &&
+                 header->bodiesOffset % alignof(SceneBodyRecord) == 0;
+    if (valid) {
+        this->view.header = header;
+        this->view.models = reinterpret_cast<const SceneModelRecord*>(this->mapping + header->modelsOffset);
+        this->view.bodies = reinterpret_cast<const SceneBodyRecord*>(this->mapping + header->bodiesOffset);
+        this->view.strings = this->mapping + header->stringsOffset;
+        valid = this->view.isValid();
+    }
+    if (!valid) {
+        std::cout << "SCENE::ERROR::" << path << " is not a valid scene file." << std::endl;
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void SceneFileView::close() {
+    if (this->mapping != nullptr) {
+        munmap(const_cast<char*>(this->mapping), this->size);
+    }
+    this->mapping = nullptr;
+    this->size = 0;
+    this->view = SceneData();
+}
+
+bool SceneInstance::instantiate(const SceneData& data, Scene* scene, const std::string& baseDirectory, MeshResidency meshResidency) {
+    if (!data.isValid()) {
+        std::cout << "SCENE::ERROR::The scene has records out of range, nothing was instantiated." << std::endl;
+        return false;
+    }
+
+    const SceneFileHeader* header = data.header;
+    this->timeStep = header->timeStep;
+    this->models.reserve(this->models.size() + header->numModels);
+    std::size_t firstModel = this->models.size();
+
+    for (int i = 0; i < 3; ++i) {
+        scene->light._position[i] = header->light.position[i];
+        scene->light._ambient[i] = header->light.ambient[i];
+        scene->light._diffuse[i] = header->light.diffuse[i];
+        scene->light._specular[i] = header->light.specular[i];
+    }
+    scene->light.updateLighting();
+
+    // Triangle mesh bodies collide with the triangles of their model, so those are kept on the CPU.
+    std::vector<bool> keepTriangles(header->numModels, false);
+    for (std::uint32_t i = 0; i < header->numBodies; ++i) {
+        if (data.bodies[i].shape == TRIANGLE_MESH) {
+            keepTriangles[data.bodies[i].model] = true;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < header->numModels; ++i) {
+        const SceneModelRecord& record = data.models[i];
+        const char* path = data.path(record);
+        std::string fullPath = path ? resolvePath(baseDirectory, path) : "";
+        MeshResidency residency = keepTriangles[i] ? withCPUData(meshResidency) : meshResidency;
+
+        Model* model;
+        if (record.type == SPHERE_MODEL) {
+            model = new Sphere(record.radius, record.resolution, residency);
+        } else if (record.type == PLANE_MODEL) {
+            model = path ? new Plane(fullPath, residency) : new Plane(record.resolution, residency);
+        } else if (record.type == BOX_MODEL) {
+            model = new Box(record.radius, residency);
+        } else if (record.type == CAPSULE_MODEL) {
+            model = new Capsule(record.radius, record.halfHeight, record.resolution, residency);
+        } else {
+            model = new Model(fullPath, residency);
+        }
+        this->models.emplace_back(model);
+
+        for (int j = 0; j < 3; ++j) {
+            model->_translation[j] = record.translation[j];
+            model->_rotation[j] = record.rotation[j];
+            model->_scale[j] = record.scale[j];
+        }
+        if (record.type == PLANE_MODEL) {
+            static_cast<Plane*>(model)->updateTransforms();
+        } else {
+            model->updateTransforms();
+        }
+        model->visibility = record.visible != 0u;
+
+        if (record.hasMaterial) {
+            Material material(glm::vec3(record.ambient[0], record.ambient[1], record.ambient[2]),
+                              glm::vec3(record.diffuse[0], record.diffuse[1], record.diffuse[2]),
+                              glm::vec3(record.specular[0], record.specular[1], record.specular[2]),
+                              record.shininess);
+            for (Mesh& mesh : model->meshes) {
+                mesh.material = material;
+            }
+        }
+        scene->addModel(model);
+    }
+
+    if (header->engine == SCENE_ENGINE_COLLISION) {
+        this->physx.reset(new CollisionPhysx());
+        scene->attachPhysics(static_cast<CollisionPhysx*>(this->physx.get()));
+    } else if (header->engine == SCENE_ENGINE_SOLAR_SYSTEM) {
+        this->physx.reset(new SolarSystemPhysx());
+        scene->attachPhysics(static_cast<SolarSystemPhysx*>(this->physx.get()));
+    } else if (header->engine == SCENE_ENGINE_NBODY) {
+        this->physx.reset(new NBodyPhysx());
+        scene->attachPhysics(static_cast<NBodyPhysx*>(this->physx.get()));
+    } else if (header->engine == SCENE_ENGINE_FMM) {
+        this->physx.reset(new FMMPhysx());
+        scene->attachPhysics(static_cast<FMMPhysx*>(this->physx.get()));
+    }
+    scene->isPhysicsOn = header->physicsOn != 0u && this->physx != nullptr;
+
+    if (this->physx == nullptr) {
+        return true;
+    }
+    this->bodies.reserve(this->bodies.size() + header->numBodies);
+    for (std::uint32_t i = 0; i < header->numBodies; ++i) {
+        const SceneBodyRecord& record = data.bodies[i];
+        glm::vec3 velocity(record.velocity[0], record.velocity[1], record.velocity[2]);
+        BodyHandle handle = this->physx->createBody(static_cast<PhysxShape>(record.shape), this->models[firstModel + record.model].get(), record.mass, velocity);
+        PhysxObject* body = this->physx->getBody(handle);
+        if (record.flags & SCENE_BODY_GRAVITY) {
+            body->enableGravity();
+        }
+        if (record.flags & SCENE_BODY_AIR_RESISTANCE) {
+            body->enableAirResistance();
+        }
+        this->bodies.push_back(handle);
+    }
+    return true;
+}
+
+bool SceneInstance::load(const std::string& path, Scene* scene, MeshResidency residency) {
+    std::string baseDirectory;
+    std::size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) {
+        baseDirectory = path.substr(0, slash);
+    }
+
+    if (isBinarySceneFile(path)) {
+        SceneFileView view;
+        if (!view.open(path)) {
+            return false;
+        }
+        return this->instantiate(view.data(), scene, baseDirectory, residency);
+    }
+
+    SceneDocument document;
+    if (!document.loadText(path)) {
+        return false;
+    }
+    return this->instantiate(document.data(), scene, baseDirectory, residency);
+}
+
+bool SceneInstance::isBinarySceneFile(const std::string& path) {
+    char magic[4] = {0, 0, 0, 0};
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, SCENE_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+MeshResidency SceneInstance::withCPUData(MeshResidency residency) {
+    if (residency == GPU_ONLY) {
+        return GPU_AND_CPU;
+    }
+    return (residency == COUNT_ONLY) ? CPU_ONLY : residency;
+}
+
+std::string SceneInstance::resolvePath(const std::string& baseDirectory, const char* path) {
+    if (path[0] == '/' || baseDirectory.empty()) {
+        return path;
+    }
+    return baseDirectory + "/" + path;
+}
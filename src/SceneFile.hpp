@@ -0,0 +1,424 @@
+/** @file SceneFile.hpp
+ *  @brief Class definitions for saving and loading scene files.
+ *
+ *  @details A scene file stores the models, their transforms and materials, the light,
+ *  the physics bodies and the type of the physics simulator of a Scene.
+ *  It comes in two forms:
+ *  - Text form, for editing by hand. One statement per line and '#' starts a comment.
+ *  - Binary form, a header followed by fixed size records and a string table.
+ *    It is loaded by mapping the file into memory and reading the records in place.
+ *
+ *  Text form:
+ *  @code
+ *  engine collision              # collision | solar_system | nbody | fmm | none
+ *  physics off                   # on | off
+ *  timestep 0.02
+ *  light 10 60 10  0.2 0.2 0.2  1 1 1  1 1 1   # position ambient diffuse specular
+ *  plane_file assets/plane.obj   # mesh <path> | sphere <radius> <resolution> | plane <scale> | plane_file <path>
+ *                                # | box <half size> | capsule <radius> <half height> <resolution>
+ *  translation 0 -12 0           # Applies to the last model.
+ *  rotation 0 0 0
+ *  scale 10 10 10
+ *  material 1 1 1  0.2 0.4 0.9  1 1 1  76.8       # ambient diffuse specular shininess
+ *  hidden
+ *  body plane 2 0 0 0            # <shape> <mass> <vx vy vz> [gravity] [air]. Applies to the last model.
+ *                                # shape: plane | sphere | box | capsule | mesh
+ *  @endcode
+ *  Relative paths are resolved against the directory of the scene file. A path containing '#' is
+ *  written in double quotes, e.g. mesh "assets/part #2.obj".
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FMM.hpp"
+#include "Light.hpp"
+#include "Model.hpp"
+#include "NBody.hpp"
+#include "Physics.hpp"
+#include "Scene.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Magic bytes at the start of a binary scene file.
+const char SCENE_FILE_MAGIC[4] = {'M', 'B', 'S', 'C'};
+
+//! Version of the binary scene file layout.
+const std::uint32_t SCENE_FILE_VERSION = 1u;
+
+//! Marks a record without a path in the string table.
+const std::uint32_t SCENE_NO_PATH = 0xFFFFFFFFu;
+
+/**
+ * @enum SceneEngine
+ * @brief Type of the Physics Simulator stored in a scene file.
+ */
+enum SceneEngine {
+    SCENE_ENGINE_NONE,
+    SCENE_ENGINE_COLLISION,
+    SCENE_ENGINE_SOLAR_SYSTEM,
+    SCENE_ENGINE_NBODY,
+    SCENE_ENGINE_FMM,
+};
+
+/**
+ * @enum SceneBodyFlags
+ * @brief Flags of a physics body stored in a scene file.
+ */
+enum SceneBodyFlags {
+    SCENE_BODY_GRAVITY = 1u << 0,
+    SCENE_BODY_AIR_RESISTANCE = 1u << 1,
+};
+
+/**
+ * @struct SceneLightRecord
+ * @brief The light of the scene.
+ */
+typedef struct SceneLightRecord {
+    float position[3];
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+} SceneLightRecord;
+
+/**
+ * @struct SceneModelRecord
+ * @brief A model of the scene with its transforms and material.
+ */
+typedef struct SceneModelRecord {
+    //! ModelType of the model.
+    std::uint32_t type;
+    //! Offset of the model's file path in the string table, or SCENE_NO_PATH for generated models.
+    std::uint32_t pathOffset;
+    //! Radius of a generated Sphere or Capsule, or half size of a generated Box.
+    float radius;
+    //! Resolution of a generated Sphere or Capsule, or scale of a generated Plane.
+    std::uint32_t resolution;
+    float translation[3];
+    float rotation[3];
+    float scale[3];
+    //! Non zero when the material below overrides the materials of all meshes.
+    std::uint32_t hasMaterial;
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    std::uint32_t visible;
+    //! Half height of a generated Capsule.
+    float halfHeight;
+} SceneModelRecord;
+
+/**
+ * @struct SceneBodyRecord
+ * @brief A physics body attached to a model of the scene.
+ */
+typedef struct SceneBodyRecord {
+    //! Index of the model in the model records.
+    std::uint32_t model;
+    //! PhysxShape of the body.
+    std::uint32_t shape;
+    float mass;
+    float velocity[3];
+    //! Combination of SceneBodyFlags.
+    std::uint32_t flags;
+    std::uint32_t padding;
+} SceneBodyRecord;
+
+/**
+ * @struct SceneFileHeader
+ * @brief Header of a binary scene file. All offsets are from the start of the file.
+ */
+typedef struct SceneFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    //! SceneEngine of the scene.
+    std::uint32_t engine;
+    std::uint32_t physicsOn;
+    float timeStep;
+    std::uint32_t numModels;
+    std::uint32_t numBodies;
+    std::uint32_t stringsSize;
+    SceneLightRecord light;
+    std::uint64_t modelsOffset;
+    std::uint64_t bodiesOffset;
+    std::uint64_t stringsOffset;
+} SceneFileHeader;
+
+/**
+ * @struct SceneData
+ * @brief Non owning view over the contents of a scene file.
+ * @details Points either into a SceneDocument or directly into a memory mapped binary scene file.
+ * The records are only used once isValid() accepted them.
+ */
+typedef struct SceneData {
+    const SceneFileHeader* header = nullptr;
+    const SceneModelRecord* models = nullptr;
+    const SceneBodyRecord* bodies = nullptr;
+    const char* strings = nullptr;
+
+    /**
+	 * @brief Get the path of a model, or nullptr for generated models.
+	 *
+	 * @param model
+	 * @return const char*
+	 */
+    const char* path(const SceneModelRecord& model) const {
+        if (model.pathOffset == SCENE_NO_PATH || model.pathOffset >= header->stringsSize) {
+            return nullptr;
+        }
+        return this->strings + model.pathOffset;
+    }
+
+    /**
+	 * @brief Check that every enum of the records is in range, that every body refers to a model
+	 * and that every path is a null terminated string inside the string table.
+	 *
+	 * @return true When the records can be used.
+	 * @return false Otherwise.
+	 */
+    bool isValid() const;
+} SceneData;
+
+/** @class SceneDocument
+ *  @brief Editable, owning form of a scene file.
+ *  @details Builds scenes by hand or from a live Scene, and reads and writes both the text and the binary form.
+ */
+class SceneDocument {
+   public:
+    SceneFileHeader header;
+    std::vector<SceneModelRecord> models;
+    std::vector<SceneBodyRecord> bodies;
+    //! Null terminated paths referenced by the model records.
+    std::string strings;
+
+    /**
+	 * @brief Construct a new empty SceneDocument with the default light.
+	 */
+    SceneDocument();
+
+    /**
+	 * @brief Get a view over the contents of the document.
+	 * @details The view is invalidated by any change made to the document.
+	 *
+	 * @return SceneData
+	 */
+    SceneData data();
+
+    /**
+	 * @brief Set the light of the scene.
+	 *
+	 * @param light
+	 */
+    void setLight(const Light& light);
+
+    /**
+	 * @brief Add a model record. Transforms default to identity and the model is visible.
+	 *
+	 * @param type ModelType of the model.
+	 * @param path Path of the model's file. (Empty for generated models.)
+	 * @param radius Radius of a generated Sphere or Capsule, or half size of a generated Box.
+	 * @param resolution Resolution of a generated Sphere or Capsule, or scale of a generated Plane.
+	 * @return SceneModelRecord&
+	 */
+    SceneModelRecord& addModel(ModelType type, const std::string& path = "", float radius = 0.0f, unsigned resolution = 0);
+
+    /**
+	 * @brief Add a physics body record for a model.
+	 *
+	 * @param model Index of the model record.
+	 * @param shape
+	 * @param mass
+	 * @param velocity
+	 * @param flags Combination of SceneBodyFlags.
+	 * @return SceneBodyRecord&
+	 */
+    SceneBodyRecord& addBody(std::uint32_t model, PhysxShape shape, float mass, glm::vec3 velocity, std::uint32_t flags = 0u);
+
+    /**
+	 * @brief Capture the current state of a live scene.
+	 *
+	 * @param scene
+	 * @param timeStep Time step the scene is simulated with.
+	 */
+    void capture(const Scene& scene, float timeStep);
+
+    /**
+	 * @brief Write the document in the binary form.
+	 *
+	 * @param path
+	 * @return true When the file was written.
+	 * @return false When the file could not be written.
+	 */
+    bool saveBinary(const std::string& path);
+
+    /**
+	 * @brief Write the document in the text form.
+	 *
+	 * @param path
+	 * @return true When the file was written.
+	 * @return false When the records are not valid or the file could not be written. The error is printed.
+	 */
+    bool saveText(const std::string& path);
+
+    /**
+	 * @brief Read a document in the text form, replacing the current contents.
+	 *
+	 * @param path
+	 * @return true When the file was read.
+	 * @return false When the file could not be read or has an error. The error is printed with its line number.
+	 */
+    bool loadText(const std::string& path);
+
+   private:
+    /**
+	 * @brief Append space separated floats with the fewest digits that still read back to the same value.
+	 */
+    static void appendFloats(std::string& out, const float* values, int count);
+
+    static std::uint64_t alignOffset(std::uint64_t offset) {
+        return (offset + 7u) & ~std::uint64_t(7u);
+    }
+
+    std::uint32_t addString(const std::string& s);
+
+    static const char* skipSpaces(const char* c, const char* end);
+
+    static bool readFloats(const char*& c, const char* end, float* out, int count);
+
+    static bool readWord(const char*& c, const char* end, std::string& word);
+
+    /**
+	 * @brief Read the rest of a line up to a comment, without the spaces around it, or the text
+	 * between double quotes, which may contain '#'.
+	 */
+    static bool readRest(const char* c, const char* end, std::string& rest);
+
+    /**
+	 * @brief Convert a count read as float, failing for negative and too large values.
+	 */
+    static bool toCount(float value, unsigned& count);
+
+    bool parseLine(const char* c, const char* end);
+};
+
+/** @class SceneFileView
+ *  @brief Read only, zero-copy view of a binary scene file.
+ *  @details The file is mapped into memory and the records are used in place, without any parsing.
+ */
+class SceneFileView {
+   public:
+    SceneFileView() = default;
+    SceneFileView(const SceneFileView&) = delete;
+    SceneFileView& operator=(const SceneFileView&) = delete;
+
+    ~SceneFileView() {
+        this->close();
+    }
+
+    /**
+	 * @brief Map a binary scene file and validate its header and records.
+	 *
+	 * @param path
+	 * @return true When the file is a valid scene file.
+	 * @return false Otherwise. The error is printed.
+	 */
+    bool open(const std::string& path);
+
+    /**
+	 * @brief Unmap the file.
+	 */
+    void close();
+
+    /**
+	 * @brief Get a view over the mapped file. Valid until the file is closed.
+	 *
+	 * @return const SceneData&
+	 */
+    const SceneData& data() const {
+        return this->view;
+    }
+
+   private:
+    const char* mapping = nullptr;
+    std::size_t size = 0;
+    SceneData view;
+
+    /**
+	 * @brief Check that count records of recordSize bytes at offset end within size bytes,
+	 * without overflowing for offsets and counts read from a crafted file.
+	 */
+    static bool fitsIn(std::uint64_t offset, std::uint64_t count, std::uint64_t recordSize, std::uint64_t size) {
+        return offset <= size && count <= (size - offset) / recordSize;
+    }
+};
+
+/** @class SceneInstance
+ *  @brief Owns the Models, PhysxObjects and Physics Simulator created from a scene file.
+ */
+class SceneInstance {
+   public:
+    //! Models created from the scene file, in the order of the model records.
+    std::vector<std::unique_ptr<Model>> models;
+    //! Physics bodies created from the scene file in the simulator, in the order of the body records.
+    std::vector<BodyHandle> bodies;
+    //! The Physics Simulator of the scene, or nullptr when the scene has none.
+    std::unique_ptr<Physx> physx;
+    //! Time step stored in the scene file.
+    float timeStep = 0.025f;
+
+    /**
+	 * @brief Create all Models and physics bodies of a scene file and add them to the scene.
+	 *
+	 * @param data Contents of the scene file.
+	 * @param scene Scene to add the models to. Its light and physics are replaced.
+	 * @param baseDirectory Directory relative paths are resolved against.
+	 * @param meshResidency Which copies of the mesh data to keep. Use a headless residency when there is no OpenGL context.
+	 * Models of triangle mesh bodies keep their CPU copies either way.
+	 * @return true When the scene was instantiated.
+	 * @return false When the records are not valid, nothing is created then. The error is printed.
+	 */
+    bool instantiate(const SceneData& data, Scene* scene, const std::string& baseDirectory = "", MeshResidency meshResidency = GPU_ONLY);
+
+    /**
+	 * @brief Load a scene file in either form and add it to the scene.
+	 * @details Files starting with the binary magic bytes are mapped, everything else is read as text.
+	 *
+	 * @param path
+	 * @param scene
+	 * @param residency
+	 * @return true When the scene was loaded.
+	 * @return false When the file could not be read or is not valid. The error is printed.
+	 */
+    bool load(const std::string& path, Scene* scene, MeshResidency residency = GPU_ONLY);
+
+    /**
+	 * @brief Check whether a file starts with the binary scene file magic bytes.
+	 *
+	 * @param path
+	 * @return true For binary scene files.
+	 * @return false Otherwise.
+	 */
+    static bool isBinarySceneFile(const std::string& path);
+
+   private:
+    /**
+	 * @brief The residency that keeps the CPU copies, and otherwise does the same as the given one.
+	 */
+    static MeshResidency withCPUData(MeshResidency residency);
+
+    static std::string resolvePath(const std::string& baseDirectory, const char* path);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
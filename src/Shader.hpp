@@ -1,4 +1,4 @@
-/** @file Shader.cpp
+/** @file Shader.hpp
  *  @brief Class definition for a Shader.
  *
  *  @author Sivaraman Karthik Rangasai (karthikrangasai)
@@ -9,12 +9,8 @@
 #define SHADER_H
 
 #include <glm/glm/glm.hpp>
-#include <glm/glm/gtc/type_ptr.hpp>
 
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,71 +28,35 @@ class Shader {
     /**
 	 * @brief Default Constructor.
 	*/
-    Shader() {
-        unsigned int vertex, fragment;
-        // Vertex Shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &_materialVertexShaderSource, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-
-        // Fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &_materialFragmentShaderSource, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-
-        // Shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-
-        // delete the shaders as they're linked into our program now and no longer necessery
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-    }
+    Shader();
 
     /**
 	 * @brief Set the Model Matrix
 	 * 
 	 * @param model 
 	 */
-    void setModelMatrix(const glm::mat4& model) const {
-        int modelLocation = glGetUniformLocation(this->ID, "model");
-        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
-    }
+    void setModelMatrix(const glm::mat4& model) const;
 
     /**
 	 * @brief Set the View Matrix
 	 * 
 	 * @param view 
 	 */
-    void setViewMatrix(const glm::mat4& view) const {
-        int viewLocation = glGetUniformLocation(this->ID, "view");
-        glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view));
-    }
+    void setViewMatrix(const glm::mat4& view) const;
 
     /**
 	 * @brief Set the Projection Matrix
 	 * 
 	 * @param projection 
 	 */
-    void setProjectionMatrix(const glm::mat4& projection) const {
-        int projectionLocation = glGetUniformLocation(this->ID, "projection");
-        glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
-    }
+    void setProjectionMatrix(const glm::mat4& projection) const;
 
     /**
 	 * @brief Set the Camera Position
 	 * 
 	 * @param position 
 	 */
-    void setCameraPosition(const glm::vec3& position) const {
-        int cameraPosition = glGetUniformLocation(this->ID, "viewPos");
-        glUniform3fv(cameraPosition, 1, glm::value_ptr(position));
-    }
+    void setCameraPosition(const glm::vec3& position) const;
 
     /**
 	 * @brief Set the Material
@@ -106,19 +66,7 @@ class Shader {
 	 * @param specular 
 	 * @param shininess 
 	 */
-    void setMaterial(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, const float& shininess) const {
-        int materialAmbient = glGetUniformLocation(this->ID, "material.ambient");
-        glUniform3fv(materialAmbient, 1, glm::value_ptr(ambient));
-
-        int materialDiffuse = glGetUniformLocation(this->ID, "material.diffuse");
-        glUniform3fv(materialDiffuse, 1, glm::value_ptr(diffuse));
-
-        int materialSpecular = glGetUniformLocation(this->ID, "material.specular");
-        glUniform3fv(materialSpecular, 1, glm::value_ptr(glm::vec3(specular)));
-
-        int materialShininess = glGetUniformLocation(this->ID, "material.shininess");
-        glUniform1f(materialShininess, shininess);
-    }
+    void setMaterial(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, const float& shininess) const;
 
     /**
 	 * @brief Set the Lighting
@@ -128,19 +76,7 @@ class Shader {
 	 * @param diffuse 
 	 * @param specular 
 	 */
-    void setLighting(const glm::vec3& position, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular) const {
-        int lightPosition = glGetUniformLocation(this->ID, "light.position");
-        glUniform3fv(lightPosition, 1, glm::value_ptr(position));
-
-        int lightAmbient = glGetUniformLocation(this->ID, "light.ambient");
-        glUniform3fv(lightAmbient, 1, glm::value_ptr(ambient));
-
-        int lightDiffuse = glGetUniformLocation(this->ID, "light.diffuse");
-        glUniform3fv(lightDiffuse, 1, glm::value_ptr(diffuse));
-
-        int lightSpecular = glGetUniformLocation(this->ID, "light.specular");
-        glUniform3fv(lightSpecular, 1, glm::value_ptr(specular));
-    }
+    void setLighting(const glm::vec3& position, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular) const;
 
    private:
     const char* _materialVertexShaderSource =
@@ -213,25 +149,7 @@ class Shader {
         "\tFragColor = color;\n"
         "}\n\0";
 
-    void checkCompileErrors(GLuint shader, std::string type) {
-        GLint success;
-        GLchar infoLog[1024];
-        if (type != "PROGRAM") {
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-            if (!success) {
-                glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n"
-                          << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        } else {
-            glGetProgramiv(shader, GL_LINK_STATUS, &success);
-            if (!success) {
-                glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n"
-                          << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        }
-    }
+    void checkCompileErrors(unsigned int shader, std::string type);
 };
 
 #ifdef __cplusplus
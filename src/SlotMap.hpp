@@ -0,0 +1,218 @@
+/** @file SlotMap.hpp
+ *  @brief Class definition for a container of objects addressed by generational handles.
+ *
+ *  @details The objects are kept next to each other in one array. Removing one moves the last
+ *  object into its place, so the array never has holes. A handle names a slot that records where
+ *  its object currently is, and the generation of the slot: a slot that was freed and reused
+ *  carries a newer generation, so stale handles are detected instead of reaching another object.
+ *  Adding, removing and looking up objects take constant time, and freed slots are reused, so
+ *  objects coming and going do not fragment memory.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct SlotHandle
+ * @brief Names an object of a SlotMap for as long as it exists.
+ */
+typedef struct SlotHandle {
+    //! Slot of the object.
+    std::uint32_t index;
+    //! Generation of the slot when the object was added. 0 is never used, so SlotHandle() is invalid.
+    std::uint32_t generation;
+
+    bool operator==(const SlotHandle& other) const {
+        return this->index == other.index && this->generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const {
+        return !(*this == other);
+    }
+} SlotHandle;
+
+#ifdef __cplusplus
+}
+#endif
+
+// Templates cannot have C linkage.
+
+/** @class SlotMap
+ *  @brief Objects stored contiguously and addressed by SlotHandle.
+ *  @details Pointers and references to the objects are invalidated by insert() and erase(),
+ *  handles are not.
+ */
+template <typename T>
+class SlotMap {
+   public:
+    //! Returned by erase() for handles that do not name an object.
+    static const std::size_t npos = ~(std::size_t)0;
+
+    /**
+	 * @brief Construct an object at the end of the array.
+	 *
+	 * @param args Arguments of the constructor of T.
+	 * @return SlotHandle
+	 */
+    template <typename... Args>
+    SlotHandle insert(Args&&... args) {
+        std::uint32_t slot;
+        if (this->freeSlot != NO_SLOT) {
+            slot = this->freeSlot;
+            this->freeSlot = this->slots[slot].position;
+        } else {
+            slot = this->slots.size();
+            this->slots.push_back({0u, 1u});
+        }
+        this->slots[slot].position = this->values.size();
+        this->values.emplace_back(std::forward<Args>(args)...);
+        this->owners.push_back(slot);
+        return {slot, this->slots[slot].generation};
+    }
+
+    /**
+	 * @brief Remove an object. The last object of the array is moved into its place.
+	 *
+	 * @param handle
+	 * @return std::size_t Position the object was at. Unless it is size(), the last object was moved
+	 * there. SlotMap::npos when the handle did not name an object.
+	 */
+    std::size_t erase(SlotHandle handle) {
+        if (!this->contains(handle)) {
+            return npos;
+        }
+        std::uint32_t position = this->slots[handle.index].position;
+        std::uint32_t last = this->values.size() - 1;
+        if (position != last) {
+            this->values[position] = std::move(this->values[last]);
+            this->owners[position] = this->owners[last];
+            this->slots[this->owners[position]].position = position;
+        }
+        this->values.pop_back();
+        this->owners.pop_back();
+
+        Slot& slot = this->slots[handle.index];
+        // Generation 0 is skipped when the counter wraps around, it marks invalid handles.
+        slot.generation = (slot.generation + 1 != 0) ? slot.generation + 1 : 1;
+        slot.position = this->freeSlot;
+        this->freeSlot = handle.index;
+        return position;
+    }
+
+    /**
+	 * @brief Whether the handle names an object that is still in the map.
+	 */
+    bool contains(SlotHandle handle) const {
+        return handle.index < this->slots.size() && handle.generation != 0 && this->slots[handle.index].generation == handle.generation;
+    }
+
+    /**
+	 * @brief Get the object named by a handle.
+	 *
+	 * @param handle
+	 * @return T* nullptr when the object was removed.
+	 */
+    T* get(SlotHandle handle) {
+        return this->contains(handle) ? &this->values[this->slots[handle.index].position] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return this->contains(handle) ? &this->values[this->slots[handle.index].position] : nullptr;
+    }
+
+    /**
+	 * @brief Get the handle of the object at a position of the array.
+	 */
+    SlotHandle handleAt(std::size_t position) const {
+        std::uint32_t slot = this->owners[position];
+        return {slot, this->slots[slot].generation};
+    }
+
+    /**
+	 * @brief Make room for count objects, so that inserting them does not move the array.
+	 */
+    void reserve(std::size_t count) {
+        this->values.reserve(count);
+        this->owners.reserve(count);
+        this->slots.reserve(count);
+    }
+
+    /**
+	 * @brief Remove all objects. Handles given out before stay invalid.
+	 */
+    void clear() {
+        while (!this->values.empty()) {
+            this->erase(this->handleAt(this->values.size() - 1));
+        }
+    }
+
+    std::size_t size() const {
+        return this->values.size();
+    }
+
+    bool empty() const {
+        return this->values.empty();
+    }
+
+    T& operator[](std::size_t position) {
+        return this->values[position];
+    }
+
+    const T& operator[](std::size_t position) const {
+        return this->values[position];
+    }
+
+    T* data() {
+        return this->values.data();
+    }
+
+    const T* data() const {
+        return this->values.data();
+    }
+
+    typename std::vector<T>::iterator begin() {
+        return this->values.begin();
+    }
+
+    typename std::vector<T>::iterator end() {
+        return this->values.end();
+    }
+
+    typename std::vector<T>::const_iterator begin() const {
+        return this->values.begin();
+    }
+
+    typename std::vector<T>::const_iterator end() const {
+        return this->values.end();
+    }
+
+   private:
+    static const std::uint32_t NO_SLOT = ~0u;
+
+    struct Slot {
+        //! Position of the object in values, or the next free slot while the slot is free.
+        std::uint32_t position;
+        std::uint32_t generation;
+    };
+
+    //! The objects, without holes.
+    std::vector<T> values;
+    //! Slot of every object of values.
+    std::vector<std::uint32_t> owners;
+    std::vector<Slot> slots;
+    //! First slot of the list of free slots.
+    std::uint32_t freeSlot = NO_SLOT;
+};
+
+#endif
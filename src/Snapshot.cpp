@@ -0,0 +1,288 @@
+/** @file Snapshot.cpp
+ *  @brief Implementation of the simulation history, see Snapshot.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <cstring>
+#include <iostream>
+
+#include "Snapshot.hpp"
+
+SimulationHistory::SimulationHistory(Physx* physx, unsigned interval, unsigned keyframeInterval) {
+    this->physx = physx;
+    this->interval = interval > 0 ? interval : 1;
+    this->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+    this->currentStep = 0;
+    this->previousIsLast = false;
+}
+
+void SimulationHistory::step(float dt) {
+    if (this->entries.empty()) {
+        this->capture(dt);
+        if (this->hashCheck) {
+            this->checkStateHash();
+        }
+    } else if (this->currentStep < this->entries.back().step) {
+        if (dt != this->entries[this->findEntry(this->currentStep)].dt) {
+            this->discardAfter(this->currentStep);
+        }
+    }
+
+    SnapshotEntry& last = this->entries.back();
+    if (this->currentStep >= last.step && dt != last.dt) {
+        if (last.step == this->currentStep) {
+            last.dt = dt;
+        } else {
+            // Replaying needs the time step of every step, so changing it forces a snapshot.
+            this->capture(dt);
+        }
+    }
+
+    this->physx->step(dt);
+    ++this->currentStep;
+    if (this->hashCheck) {
+        this->checkStateHash();
+    }
+
+    if (this->currentStep % this->interval == 0 && this->currentStep > this->entries.back().step) {
+        this->capture(dt);
+    }
+}
+
+bool SimulationHistory::seek(std::uint64_t step) {
+    if (this->entries.empty()) {
+        return false;
+    }
+
+    std::size_t index = this->findEntry(step);
+    this->decode(index, this->state);
+    this->restoreState(this->state);
+    this->currentStep = this->entries[index].step;
+
+    while (this->currentStep < step) {
+        this->step(this->entries[this->findEntry(this->currentStep)].dt);
+    }
+    return true;
+}
+
+void SimulationHistory::discardAfter(std::uint64_t step) {
+    if (this->stateHashes.size() > step + 1) {
+        this->stateHashes.resize(step + 1);
+    }
+    while (!this->entries.empty() && this->entries.back().step > step) {
+        this->buffer.resize(this->entries.back().offset);
+        this->entries.pop_back();
+        this->previousIsLast = false;
+    }
+}
+
+void SimulationHistory::clear() {
+    this->entries.clear();
+    this->buffer.clear();
+    this->stateHashes.clear();
+    this->firstMismatch = -1;
+    this->currentStep = 0;
+    this->previousIsLast = false;
+}
+
+void SimulationHistory::expectStateHashes(const std::vector<std::uint64_t>& hashes) {
+    this->stateHashes = hashes;
+    this->firstMismatch = -1;
+    this->hashCheck = true;
+}
+
+std::uint64_t SimulationHistory::stateHash() {
+    this->captureState(this->scratch);
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::uint32_t word : this->scratch) {
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void SimulationHistory::captureState(std::vector<std::uint32_t>& words) const {
+    words.clear();
+    for (const PhysxObject* object : this->physx->getObjects()) {
+        pushVec3(words, object->model->worldPosition);
+        pushVec3(words, object->velocity);
+        words.push_back(floatBits(object->sleepTimer));
+        words.push_back(object->sleeping ? 1u : 0u);
+        if (object->shape == PLANE) {
+            const Plane* plane = static_cast<const Plane*>(object->model);
+            pushVec3(words, plane->normal);
+            words.push_back(floatBits(plane->Odist));
+        }
+    }
+    this->physx->captureSolverState(words);
+}
+
+void SimulationHistory::restoreState(const std::vector<std::uint32_t>& words) {
+    std::size_t i = 0;
+    for (PhysxObject* object : this->physx->getObjects()) {
+        Model* model = object->model;
+        model->worldPosition = readVec3(words, i);
+        object->velocity = readVec3(words, i);
+        object->sleepTimer = bitsFloat(words[i++]);
+        object->sleeping = words[i++] != 0u;
+        object->sleepPosition = model->worldPosition;
+        if (object->shape == PLANE) {
+            // Planes do not move, and Plane::updateTransforms() would rotate the restored normal again.
+            Plane* plane = static_cast<Plane*>(model);
+            plane->normal = readVec3(words, i);
+            plane->Odist = bitsFloat(words[i++]);
+            ++plane->version;
+        } else {
+            model->_translation[0] = model->worldPosition.x;
+            model->_translation[1] = model->worldPosition.y;
+            model->_translation[2] = model->worldPosition.z;
+            model->updateTransforms();
+        }
+    }
+    this->physx->restoreSolverState(words, i);
+}
+
+void SimulationHistory::checkStateHash() {
+    std::uint64_t hash = this->stateHash();
+    if (this->currentStep >= this->stateHashes.size()) {
+        this->stateHashes.resize(this->currentStep + 1, 0u);
+        this->stateHashes[this->currentStep] = hash;
+    } else if (this->stateHashes[this->currentStep] != hash && this->firstMismatch < 0) {
+        this->firstMismatch = this->currentStep;
+        std::cout << "SNAPSHOT::ERROR::The state at step " << this->currentStep << " differs from the recorded run." << std::endl;
+    }
+}
+
+void SimulationHistory::capture(float dt) {
+    this->captureState(this->state);
+
+    SnapshotEntry entry;
+    entry.step = this->currentStep;
+    entry.dt = dt;
+    entry.offset = this->buffer.size();
+
+    std::size_t sinceKeyframe = 0;
+    for (std::size_t i = this->entries.size(); i > 0 && !this->entries[i - 1].keyframe; --i) {
+        ++sinceKeyframe;
+    }
+    entry.keyframe = this->entries.empty() || sinceKeyframe + 1 >= this->keyframeInterval;
+
+    if (!entry.keyframe) {
+        // The base of the delta is the state of the last snapshot, decoded again only if it was discarded.
+        if (!this->previousIsLast) {
+            this->decode(this->entries.size() - 1, this->previous);
+        }
+        entry.keyframe = this->previous.size() != this->state.size();
+    }
+
+    if (entry.keyframe) {
+        std::size_t bytes = this->state.size() * sizeof(std::uint32_t);
+        this->buffer.resize(entry.offset + bytes);
+        if (bytes > 0) {
+            std::memcpy(&this->buffer[entry.offset], this->state.data(), bytes);
+        }
+    } else {
+        this->encodeDelta(this->state, this->previous);
+    }
+
+    entry.size = this->buffer.size() - entry.offset;
+    this->entries.push_back(entry);
+    this->previous = this->state;
+    this->previousIsLast = true;
+}
+
+void SimulationHistory::encodeDelta(const std::vector<std::uint32_t>& current, const std::vector<std::uint32_t>& base) {
+    std::size_t mask = this->buffer.size();
+    this->buffer.resize(mask + (current.size() + 7) / 8, 0u);
+    for (std::size_t i = 0; i < current.size(); ++i) {
+        if (current[i] == base[i]) {
+            continue;
+        }
+        std::uint32_t difference = orderedBits(current[i]) - orderedBits(base[i]);
+        this->buffer[mask + i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+        this->writeVarint((difference << 1) ^ (0u - (difference >> 31)));
+    }
+}
+
+void SimulationHistory::decode(std::size_t index, std::vector<std::uint32_t>& words) const {
+    std::size_t keyframe = index;
+    while (!this->entries[keyframe].keyframe) {
+        --keyframe;
+    }
+
+    const SnapshotEntry& key = this->entries[keyframe];
+    words.resize(key.size / sizeof(std::uint32_t));
+    if (key.size > 0) {
+        std::memcpy(words.data(), &this->buffer[key.offset], key.size);
+    }
+
+    for (std::size_t e = keyframe + 1; e <= index; ++e) {
+        const SnapshotEntry& entry = this->entries[e];
+        std::size_t mask = entry.offset;
+        std::size_t position = entry.offset + (words.size() + 7) / 8;
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (this->buffer[mask + i / 8] & (1u << (i % 8))) {
+                std::uint32_t zigzag = this->readVarint(position);
+                std::uint32_t difference = (zigzag >> 1) ^ (0u - (zigzag & 1u));
+                words[i] = unorderedBits(orderedBits(words[i]) + difference);
+            }
+        }
+    }
+}
+
+std::size_t SimulationHistory::findEntry(std::uint64_t step) const {
+    std::size_t low = 0, high = this->entries.size();
+    while (high - low > 1) {
+        std::size_t mid = (low + high) / 2;
+        if (this->entries[mid].step <= step) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void SimulationHistory::writeVarint(std::uint32_t value) {
+    while (value >= 0x80u) {
+        this->buffer.push_back(static_cast<std::uint8_t>(value | 0x80u));
+        value >>= 7;
+    }
+    this->buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint32_t SimulationHistory::readVarint(std::size_t& position) const {
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        std::uint8_t byte = this->buffer[position++];
+        value |= static_cast<std::uint32_t>(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+std::uint32_t SimulationHistory::floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float SimulationHistory::bitsFloat(std::uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void SimulationHistory::pushVec3(std::vector<std::uint32_t>& words, const glm::vec3& v) {
+    words.push_back(floatBits(v.x));
+    words.push_back(floatBits(v.y));
+    words.push_back(floatBits(v.z));
+}
+
+glm::vec3 SimulationHistory::readVec3(const std::vector<std::uint32_t>& words, std::size_t& i) {
+    glm::vec3 v(bitsFloat(words[i]), bitsFloat(words[i + 1]), bitsFloat(words[i + 2]));
+    i += 3;
+    return v;
+}
@@ -0,0 +1,262 @@
+/** @file Snapshot.hpp
+ *  @brief Class definition for recording, rewinding and replaying a physics simulation.
+ *
+ *  @details The full simulation state (positions, velocities, plane normals and the state the
+ *  simulation keeps between steps) is captured into a single compact buffer at a configurable
+ *  interval.
+ *  Every few snapshots a keyframe is stored as is, the snapshots in between only store the
+ *  difference of each float to the previous snapshot: a bitmask of the changed words followed by
+ *  the changes in units in the last place as varints, so that unchanged values (planes, bodies at
+ *  rest) cost a single bit and small changes one to three bytes.
+ *  Seeking restores the closest snapshot at or before the requested step and replays the
+ *  remaining steps, which reproduces the original run bit for bit.
+ *  With the hash check on, the hash of the state after every step is kept and compared when the
+ *  step is simulated again, by a replay or by another run given the hashes of the first one.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Model.hpp"
+#include "Physics.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct SnapshotEntry
+ * @brief Location of a single snapshot in the history buffer.
+ */
+typedef struct SnapshotEntry {
+    //! Simulation step the snapshot was taken at.
+    std::uint64_t step;
+    //! Time step used for the steps following the snapshot.
+    float dt;
+    //! Whether the snapshot is stored whole, or as a delta against the previous snapshot.
+    bool keyframe;
+    //! Offset of the encoded snapshot in the history buffer.
+    std::size_t offset;
+    //! Size of the encoded snapshot in bytes.
+    std::size_t size;
+} SnapshotEntry;
+
+/** @class SimulationHistory
+ *  @brief Records snapshots of a Physics Simulator and rewinds or replays it to any step.
+ *  @details Use step() in place of Physx::step() so the history knows the step count.
+ *  The set of objects in the simulation must not change while recording.
+ */
+class SimulationHistory {
+   public:
+    /**
+	 * @brief Construct a new SimulationHistory.
+	 *
+	 * @param physx The simulation to record.
+	 * @param interval Number of steps between two snapshots.
+	 * @param keyframeInterval Number of snapshots between two keyframes.
+	 */
+    SimulationHistory(Physx* physx, unsigned interval = 10, unsigned keyframeInterval = 30);
+
+    /**
+	 * @brief Advance the simulation by a single time step and take a snapshot when one is due.
+	 * @details The first call also records the starting state as step 0. After a seek, stepping with
+	 * the recorded time steps replays the recording and keeps it. Stepping with a different time step
+	 * drops the snapshots after the current step.
+	 *
+	 * @param dt
+	 */
+    void step(float dt);
+
+    /**
+	 * @brief Restore the simulation to the given step.
+	 * @details Restores the closest snapshot at or before the step and replays the steps after it.
+	 * Steps past the last recorded step are simulated and recorded with the last time step.
+	 *
+	 * @param step
+	 * @return true When the step was reached.
+	 * @return false When nothing has been recorded yet.
+	 */
+    bool seek(std::uint64_t step);
+
+    /**
+	 * @brief Drop all snapshots taken after the given step.
+	 * @details Use this after the state was edited, e.g. from the GUI, so that the old future is not replayed.
+	 *
+	 * @param step
+	 */
+    void discardAfter(std::uint64_t step);
+
+    /**
+	 * @brief Drop every snapshot and start counting steps from 0 again.
+	 */
+    void clear();
+
+    /**
+	 * @brief Get the step the simulation is currently at.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getCurrentStep() const {
+        return this->currentStep;
+    }
+
+    /**
+	 * @brief Get the last step a snapshot was taken at.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getLastRecordedStep() const {
+        return this->entries.empty() ? 0 : this->entries.back().step;
+    }
+
+    /**
+	 * @brief Get the number of bytes used by the encoded snapshots.
+	 *
+	 * @return std::size_t
+	 */
+    std::size_t getBufferSize() const {
+        return this->buffer.size();
+    }
+
+    /**
+	 * @brief Get the snapshots taken so far.
+	 *
+	 * @return const std::vector<SnapshotEntry>&
+	 */
+    const std::vector<SnapshotEntry>& getEntries() const {
+        return this->entries;
+    }
+
+    /**
+	 * @brief Keep the hash of the state after every step, and compare it with the hash kept for the
+	 * same step before. A mismatch is printed once, see getFirstMismatch().
+	 * @details Replays compare against the original run. For runs on other machines or in a sweep,
+	 * pass the hashes of a reference run to expectStateHashes(). The simulation should be in
+	 * deterministic mode, see Physx::enableDeterministic().
+	 */
+    void enableHashCheck() {
+        this->hashCheck = true;
+    }
+
+    /**
+	 * @brief Check the coming steps against the hashes of another run, indexed by step.
+	 *
+	 * @param hashes
+	 */
+    void expectStateHashes(const std::vector<std::uint64_t>& hashes);
+
+    /**
+	 * @brief Get the state hash of every step so far, indexed by step.
+	 *
+	 * @return const std::vector<std::uint64_t>&
+	 */
+    const std::vector<std::uint64_t>& getStateHashes() const {
+        return this->stateHashes;
+    }
+
+    /**
+	 * @brief Get the first step whose state did not match its hash.
+	 *
+	 * @return std::int64_t The step, or -1 while all hashes matched.
+	 */
+    std::int64_t getFirstMismatch() const {
+        return this->firstMismatch;
+    }
+
+    /**
+	 * @brief Hash the current simulation state. Two runs are bit-exact when their hashes match at every step.
+	 *
+	 * @return std::uint64_t FNV-1a hash of the state words.
+	 */
+    std::uint64_t stateHash();
+
+    /**
+	 * @brief Write the simulation state as raw 32 bit words.
+	 * @details Every object contributes its position, velocity and sleep state. Planes also contribute
+	 * their normal and distance from the origin. The simulation adds its own state last, e.g. the
+	 * cached contacts.
+	 *
+	 * @param words
+	 */
+    void captureState(std::vector<std::uint32_t>& words) const;
+
+    /**
+	 * @brief Restore the simulation state written by captureState().
+	 *
+	 * @param words
+	 */
+    void restoreState(const std::vector<std::uint32_t>& words);
+
+   private:
+    Physx* physx;
+    unsigned interval;
+    unsigned keyframeInterval;
+    std::uint64_t currentStep;
+
+    //! All encoded snapshots, back to back.
+    std::vector<std::uint8_t> buffer;
+    std::vector<SnapshotEntry> entries;
+
+    //! Decoded state of the last snapshot taken, used as the base of the next delta.
+    std::vector<std::uint32_t> previous;
+    //! Whether previous still holds the state of the last snapshot.
+    bool previousIsLast;
+    std::vector<std::uint32_t> state;
+    std::vector<std::uint32_t> scratch;
+
+    //! Whether the state is hashed after every step.
+    bool hashCheck = false;
+    //! Hash of the state after every step, indexed by step.
+    std::vector<std::uint64_t> stateHashes;
+    std::int64_t firstMismatch = -1;
+
+    void checkStateHash();
+
+    void capture(float dt);
+
+    /**
+	 * @brief Write the difference of two states as a bitmask of the changed words followed by their zigzag differences as varints.
+	 */
+    void encodeDelta(const std::vector<std::uint32_t>& current, const std::vector<std::uint32_t>& base);
+
+    /**
+	 * @brief Decode the snapshot at the given index by applying all deltas since its keyframe.
+	 */
+    void decode(std::size_t index, std::vector<std::uint32_t>& words) const;
+
+    std::size_t findEntry(std::uint64_t step) const;
+
+    void writeVarint(std::uint32_t value);
+
+    std::uint32_t readVarint(std::size_t& position) const;
+
+    /**
+	 * @brief Map the bits of a float to an unsigned integer that grows with the float's value,
+	 * so that close floats have close integers.
+	 */
+    static std::uint32_t orderedBits(std::uint32_t bits) {
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    static std::uint32_t unorderedBits(std::uint32_t ordered) {
+        return (ordered & 0x80000000u) ? (ordered & 0x7FFFFFFFu) : ~ordered;
+    }
+
+    static std::uint32_t floatBits(float value);
+
+    static float bitsFloat(std::uint32_t bits);
+
+    static void pushVec3(std::vector<std::uint32_t>& words, const glm::vec3& v);
+
+    static glm::vec3 readVec3(const std::vector<std::uint32_t>& words, std::size_t& i);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
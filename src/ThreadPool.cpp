@@ -0,0 +1,83 @@
+/** @file ThreadPool.cpp
+ *  @brief Implementation of the worker thread pool, see ThreadPool.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include "ThreadPool.hpp"
+
+void ThreadPool::run(int numTasks, void (*task)(void* context, int index), void* context) {
+    if (numTasks <= 0) {
+        return;
+    }
+    if (numTasks > 1) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while ((int)this->workers.size() < numTasks - 1) {
+            this->workers.emplace_back(&ThreadPool::workerLoop, this, (int)this->workers.size());
+        }
+        this->task = task;
+        this->context = context;
+        this->numTasks = numTasks;
+        this->pending = numTasks - 1;
+        ++this->generation;
+        lock.unlock();
+        this->workReady.notify_all();
+    }
+
+    task(context, 0);
+
+    if (numTasks > 1) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->workDone.wait(lock, [&]() { return this->pending == 0; });
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->workReady.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+    this->workers.clear();
+    this->stopping = false;
+}
+
+void ThreadPool::workerLoop(int index) {
+    std::uint64_t seen = 0;
+    {
+        // A worker started for a run takes part in that run.
+        std::lock_guard<std::mutex> lock(this->mutex);
+        seen = this->generation - 1;
+    }
+    while (true) {
+        void (*task)(void*, int);
+        void* context;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            // Workers beyond the tasks of a run sit it out.
+            this->workReady.wait(lock, [&]() {
+                return this->stopping || (this->generation != seen && index + 1 < this->numTasks);
+            });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+            task = this->task;
+            context = this->context;
+        }
+
+        task(context, index + 1);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            last = --this->pending == 0;
+        }
+        if (last) {
+            this->workDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/** @file ThreadPool.hpp
+ *  @brief Class definition for a pool of worker threads that run the tasks of a parallel loop.
+ *
+ *  @details The workers are started the first time they are needed and then sleep until the next
+ *  run, so a loop that runs several times per step does not start and join threads every time.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Templates cannot have C linkage, run() has a template overload.
+
+/** @class ThreadPool
+ *  @brief Runs numbered tasks on the calling thread and a set of persistent workers.
+ *  @details One run at a time: run() is not meant to be called from several threads at once.
+ */
+class ThreadPool {
+   public:
+    ThreadPool() = default;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        this->stop();
+    }
+
+    /**
+	 * @brief Run task(context, i) for every i in [0, numTasks) and wait until all of them finished.
+	 * @details Task 0 runs on the calling thread and task i on worker i - 1. Workers missing for
+	 * numTasks are started here and kept for later runs.
+	 *
+	 * @param numTasks
+	 * @param task
+	 * @param context Passed to every task.
+	 */
+    void run(int numTasks, void (*task)(void* context, int index), void* context);
+
+    /**
+	 * @brief Run task(i) for every i in [0, numTasks), for any callable task.
+	 *
+	 * @param numTasks
+	 * @param task Called from several threads at once.
+	 */
+    template <typename Task>
+    void run(int numTasks, Task& task) {
+        this->run(numTasks, [](void* context, int index) { (*static_cast<Task*>(context))(index); }, &task);
+    }
+
+    /**
+	 * @brief Get the number of worker threads started so far.
+	 *
+	 * @return int
+	 */
+    int getWorkerCount() const {
+        return this->workers.size();
+    }
+
+    /**
+	 * @brief Stop and join all workers. A later run() starts them again.
+	 */
+    void stop();
+
+   private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+
+    //! Task of the current run and its context.
+    void (*task)(void*, int) = nullptr;
+    void* context = nullptr;
+    //! Number of tasks of the current run.
+    int numTasks = 0;
+    //! Counts the runs, a worker takes part in every run it has not seen yet.
+    std::uint64_t generation = 0;
+    //! Workers still running a task of the current run.
+    int pending = 0;
+    bool stopping = false;
+
+    void workerLoop(int index);
+};
+
+#endif
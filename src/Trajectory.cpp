@@ -0,0 +1,283 @@
+/** @file Trajectory.cpp
+ *  @brief Implementation of recording and reading trajectories, see Trajectory.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Trajectory.hpp"
+
+bool TrajectoryRecorder::open(const std::string& path, std::uint32_t numBodies, float dt, std::size_t ringFrames) {
+    this->close();
+
+    this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (this->fd < 0) {
+        std::cout << "TRAJECTORY::ERROR::Could not create " << path << std::endl;
+        return false;
+    }
+
+    this->numBodies = numBodies;
+    this->frameSize = frameSizeFor(numBodies);
+    this->ringFrames = ringFrames > 0 ? ringFrames : 1;
+    this->ring.assign(this->ringFrames * this->frameSize, 0);
+    this->head = 0;
+    this->tail = 0;
+    this->framesWritten = 0;
+    this->framesDropped = 0;
+    this->full = false;
+    this->stalls = 0;
+    this->stopping = false;
+
+    if (!this->growMapping(TRAJECTORY_HEADER_SIZE + this->ringFrames * this->frameSize)) {
+        this->closeFile();
+        return false;
+    }
+
+    TrajectoryHeader* header = reinterpret_cast<TrajectoryHeader*>(this->mapping);
+    std::memset(header, 0, sizeof(TrajectoryHeader));
+    std::memcpy(header->magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC));
+    header->version = TRAJECTORY_VERSION;
+    header->numBodies = numBodies;
+    header->frameSize = this->frameSize;
+    header->frameCount = 0;
+    header->dt = dt;
+
+    this->writer = std::thread(&TrajectoryRecorder::writeLoop, this);
+    return true;
+}
+
+void TrajectoryRecorder::record(const Physx& physx, std::uint64_t step) {
+    if (this->fd < 0) {
+        return;
+    }
+    if (this->full.load(std::memory_order_acquire)) {
+        this->framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::uint64_t slot = this->head.load(std::memory_order_relaxed);
+    if (slot - this->tail.load(std::memory_order_acquire) >= this->ringFrames) {
+        ++this->stalls;
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->spaceAvailable.wait(lock, [&]() { return slot - this->tail.load(std::memory_order_acquire) < this->ringFrames; });
+    }
+
+    char* frame = &this->ring[(slot % this->ringFrames) * this->frameSize];
+    std::memcpy(frame, &step, sizeof(step));
+    float* columns = reinterpret_cast<float*>(frame + sizeof(std::uint64_t));
+    const std::vector<PhysxObject*>& objects = physx.getObjects();
+    std::uint32_t n = this->numBodies;
+    std::uint32_t count = objects.size() < n ? objects.size() : n;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const glm::vec3& position = objects[i]->model->worldPosition;
+        const glm::vec3& velocity = objects[i]->velocity;
+        columns[i] = position.x;
+        columns[n + i] = position.y;
+        columns[2 * n + i] = position.z;
+        columns[3 * n + i] = velocity.x;
+        columns[4 * n + i] = velocity.y;
+        columns[5 * n + i] = velocity.z;
+    }
+    for (std::uint32_t c = 0; c < TRAJECTORY_COLUMNS && count < n; ++c) {
+        std::memset(columns + c * n + count, 0, (n - count) * sizeof(float));
+    }
+
+    this->head.store(slot + 1, std::memory_order_release);
+    this->dataAvailable.notify_one();
+}
+
+void TrajectoryRecorder::close() {
+    if (this->writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->dataAvailable.notify_one();
+        this->writer.join();
+    }
+    if (this->fd >= 0) {
+        std::size_t used = TRAJECTORY_HEADER_SIZE + this->framesWritten * this->frameSize;
+        msync(this->mapping, used, MS_SYNC);
+        this->closeFile();
+    }
+}
+
+std::uint32_t TrajectoryRecorder::frameSizeFor(std::uint32_t numBodies) {
+    std::uint32_t size = sizeof(std::uint64_t) + TRAJECTORY_COLUMNS * numBodies * sizeof(float);
+    return (size + 7u) & ~7u;
+}
+
+void TrajectoryRecorder::writeLoop() {
+    const std::size_t flushEvery = 64;
+    std::size_t sinceFlush = 0;
+    std::size_t flushedBytes = TRAJECTORY_HEADER_SIZE;
+    while (true) {
+        std::uint64_t available;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->dataAvailable.wait_for(lock, std::chrono::milliseconds(50), [&]() {
+                return this->stopping || this->head.load(std::memory_order_acquire) != this->tail.load(std::memory_order_relaxed);
+            });
+            available = this->head.load(std::memory_order_acquire);
+            if (this->stopping && available == this->tail.load(std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        std::uint64_t written = this->tail.load(std::memory_order_relaxed);
+        while (written < available && !this->full.load(std::memory_order_relaxed)) {
+            std::size_t offset = TRAJECTORY_HEADER_SIZE + written * this->frameSize;
+            if (offset + this->frameSize > this->mappingSize && !this->growMapping(2 * this->mappingSize)) {
+                // Without room in the file the frames are dropped, but the simulation keeps running.
+                this->full.store(true, std::memory_order_release);
+                break;
+            }
+            std::memcpy(this->mapping + offset, &this->ring[(written % this->ringFrames) * this->frameSize], this->frameSize);
+            ++written;
+            ++sinceFlush;
+
+            reinterpret_cast<TrajectoryHeader*>(this->mapping)->frameCount = written;
+            this->framesWritten.store(written, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->tail.store(written, std::memory_order_release);
+            }
+            this->spaceAvailable.notify_one();
+        }
+        if (written < available) {
+            // Free the ring slots of the dropped frames, record() may be waiting for them.
+            this->framesDropped.fetch_add(available - written, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->tail.store(available, std::memory_order_release);
+            }
+            this->spaceAvailable.notify_one();
+        }
+
+        if (sinceFlush >= flushEvery) {
+            // Hand the written pages to the kernel without waiting for the disk.
+            std::size_t used = TRAJECTORY_HEADER_SIZE + written * this->frameSize;
+            std::size_t page = flushedBytes & ~(std::size_t(sysconf(_SC_PAGESIZE)) - 1);
+            msync(this->mapping + page, used - page, MS_ASYNC);
+            msync(this->mapping, TRAJECTORY_HEADER_SIZE, MS_ASYNC);
+            flushedBytes = used;
+            sinceFlush = 0;
+        }
+    }
+}
+
+bool TrajectoryRecorder::growMapping(std::size_t size) {
+    if (ftruncate(this->fd, size) != 0) {
+        std::cout << "TRAJECTORY::ERROR::Could not grow the trajectory file." << std::endl;
+        return false;
+    }
+    void* mapping = (this->mapping == nullptr)
+                        ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0)
+                        : mremap(this->mapping, this->mappingSize, size, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) {
+        std::cout << "TRAJECTORY::ERROR::Could not map the trajectory file." << std::endl;
+        return false;
+    }
+    this->mapping = static_cast<char*>(mapping);
+    this->mappingSize = size;
+    return true;
+}
+
+void TrajectoryRecorder::closeFile() {
+    std::size_t used = TRAJECTORY_HEADER_SIZE + this->framesWritten * this->frameSize;
+    if (this->mapping != nullptr) {
+        munmap(this->mapping, this->mappingSize);
+    }
+    if (ftruncate(this->fd, used) != 0) {
+        std::cout << "TRAJECTORY::ERROR::Could not trim the trajectory file." << std::endl;
+    }
+    ::close(this->fd);
+    this->fd = -1;
+    this->mapping = nullptr;
+    this->mappingSize = 0;
+}
+
+bool TrajectoryReader::open(const std::string& path) {
+    this->close();
+    this->path = path;
+    return this->refresh();
+}
+
+bool TrajectoryReader::refresh() {
+    this->unmap();
+
+    int fd = ::open(this->path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "TRAJECTORY::ERROR::Could not open " << this->path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < TRAJECTORY_HEADER_SIZE) {
+        std::cout << "TRAJECTORY::ERROR::" << this->path << " is too small to be a trajectory file." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cout << "TRAJECTORY::ERROR::Could not map " << this->path << std::endl;
+        return false;
+    }
+    this->mapping = static_cast<const char*>(mapping);
+    this->mappingSize = st.st_size;
+
+    const TrajectoryHeader* header = this->header();
+    if (std::memcmp(header->magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) != 0 || header->version != TRAJECTORY_VERSION ||
+        header->frameSize != TrajectoryRecorder::frameSizeFor(header->numBodies)) {
+        std::cout << "TRAJECTORY::ERROR::" << this->path << " is not a valid trajectory file." << std::endl;
+        this->unmap();
+        return false;
+    }
+    return true;
+}
+
+void TrajectoryReader::close() {
+    this->unmap();
+    this->path.clear();
+}
+
+std::uint64_t TrajectoryReader::getFrameCount() const {
+    if (this->mapping == nullptr) {
+        return 0;
+    }
+    std::uint64_t inFile = (this->mappingSize - TRAJECTORY_HEADER_SIZE) / this->header()->frameSize;
+    std::uint64_t complete = this->header()->frameCount;
+    return complete < inFile ? complete : inFile;
+}
+
+TrajectoryFrame TrajectoryReader::frame(std::uint64_t index) const {
+    const char* data = this->mapping + TRAJECTORY_HEADER_SIZE + index * this->header()->frameSize;
+    std::uint32_t n = this->header()->numBodies;
+    const float* columns = reinterpret_cast<const float*>(data + sizeof(std::uint64_t));
+
+    TrajectoryFrame frame;
+    std::memcpy(&frame.step, data, sizeof(frame.step));
+    frame.px = columns;
+    frame.py = columns + n;
+    frame.pz = columns + 2 * n;
+    frame.vx = columns + 3 * n;
+    frame.vy = columns + 4 * n;
+    frame.vz = columns + 5 * n;
+    return frame;
+}
+
+void TrajectoryReader::unmap() {
+    if (this->mapping != nullptr) {
+        munmap(const_cast<char*>(this->mapping), this->mappingSize);
+    }
+    this->mapping = nullptr;
+    this->mappingSize = 0;
+}
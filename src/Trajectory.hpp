@@ -0,0 +1,274 @@
+/** @file Trajectory.hpp
+ *  @brief Class definitions for streaming body trajectories to a memory mapped file and reading them back.
+ *
+ *  @details A trajectory file is a page sized header followed by fixed width frames.
+ *  Every frame is columnar: the step number, then the x, y and z positions of all bodies,
+ *  then the x, y and z velocities of all bodies.
+ *  @code
+ *  | header (4096 bytes) | step | px[n] | py[n] | pz[n] | vx[n] | vy[n] | vz[n] | step | px[n] | ...
+ *  @endcode
+ *  The simulation thread only copies a frame into an in-memory ring. A background thread moves
+ *  the frames into the mapped file, grows it as needed and flushes it, so the simulation thread
+ *  never waits on I/O unless the ring is full.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Physics.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Magic bytes at the start of a trajectory file.
+const char TRAJECTORY_MAGIC[4] = {'M', 'B', 'T', 'R'};
+
+//! Version of the trajectory file layout.
+const std::uint32_t TRAJECTORY_VERSION = 1u;
+
+//! Size of the header. Frames start at this offset.
+const std::size_t TRAJECTORY_HEADER_SIZE = 4096u;
+
+//! Number of float columns per body in a frame: position xyz and velocity xyz.
+const std::uint32_t TRAJECTORY_COLUMNS = 6u;
+
+/**
+ * @struct TrajectoryHeader
+ * @brief Header of a trajectory file.
+ */
+typedef struct TrajectoryHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t numBodies;
+    std::uint32_t frameSize;
+    //! Number of complete frames in the file. Updated by the writer after the frames are in place.
+    std::uint64_t frameCount;
+    //! Time step the frames were recorded with.
+    float dt;
+    std::uint32_t padding;
+} TrajectoryHeader;
+
+/**
+ * @struct TrajectoryFrame
+ * @brief Columns of a single frame, pointing into the mapped file.
+ */
+typedef struct TrajectoryFrame {
+    std::uint64_t step;
+    const float* px;
+    const float* py;
+    const float* pz;
+    const float* vx;
+    const float* vy;
+    const float* vz;
+} TrajectoryFrame;
+
+/** @class TrajectoryRecorder
+ *  @brief Appends per step positions and velocities of every body to a trajectory file.
+ *  @details record() is called from the simulation thread after each step. The number of
+ *  bodies is fixed when the file is opened.
+ */
+class TrajectoryRecorder {
+   public:
+    TrajectoryRecorder() = default;
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    ~TrajectoryRecorder() {
+        this->close();
+    }
+
+    /**
+	 * @brief Create the trajectory file and start the background writer.
+	 *
+	 * @param path
+	 * @param numBodies Number of bodies recorded in every frame.
+	 * @param dt Time step of the simulation, stored in the header.
+	 * @param ringFrames Number of frames the ring holds before record() has to wait for the writer.
+	 * @return true When the file was created.
+	 * @return false Otherwise. The error is printed.
+	 */
+    bool open(const std::string& path, std::uint32_t numBodies, float dt, std::size_t ringFrames = 1024);
+
+    /**
+	 * @brief Queue a frame with the current state of all objects of the simulation.
+	 * @details Only objects up to the number of bodies given to open() are recorded, missing ones are zero.
+	 * Once the file could not be grown the frame is dropped instead, see getFramesDropped().
+	 *
+	 * @param physx
+	 * @param step Step number stored with the frame.
+	 */
+    void record(const Physx& physx, std::uint64_t step);
+
+    /**
+	 * @brief Write all queued frames, stop the writer and trim the file to its frames.
+	 */
+    void close();
+
+    /**
+	 * @brief Get the number of frames written into the file so far.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getFramesWritten() const {
+        return this->framesWritten.load(std::memory_order_acquire);
+    }
+
+    /**
+	 * @brief Get the number of times record() had to wait for the writer because the ring was full.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getStalls() const {
+        return this->stalls;
+    }
+
+    /**
+	 * @brief Get the number of frames dropped because the file could not be grown.
+	 * @details The first failure to grow the file drops the frames queued at that point and every
+	 * frame recorded after it, without trying to grow the file again.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getFramesDropped() const {
+        return this->framesDropped.load(std::memory_order_acquire);
+    }
+
+    /**
+	 * @brief Size of a single frame for the given number of bodies.
+	 *
+	 * @param numBodies
+	 * @return std::uint32_t
+	 */
+    static std::uint32_t frameSizeFor(std::uint32_t numBodies);
+
+   private:
+    int fd = -1;
+    char* mapping = nullptr;
+    std::size_t mappingSize = 0;
+
+    std::uint32_t numBodies = 0;
+    std::uint32_t frameSize = 0;
+
+    //! Frames queued by record() and not yet moved into the file.
+    std::vector<char> ring;
+    std::size_t ringFrames = 0;
+    //! Number of frames queued so far. Only written by the simulation thread.
+    std::atomic<std::uint64_t> head{0};
+    //! Number of frames taken out of the ring so far, written or dropped. Only written by the writer thread.
+    std::atomic<std::uint64_t> tail{0};
+    std::atomic<std::uint64_t> framesWritten{0};
+    std::atomic<std::uint64_t> framesDropped{0};
+    //! Set once the file could not be grown, from then on frames are dropped.
+    std::atomic<bool> full{false};
+    std::uint64_t stalls = 0;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable dataAvailable;
+    std::condition_variable spaceAvailable;
+    bool stopping = false;
+
+    void writeLoop();
+
+    bool growMapping(std::size_t size);
+
+    void closeFile();
+};
+
+/** @class TrajectoryReader
+ *  @brief Random access to the frames of a trajectory file.
+ *  @details The file is mapped read only and frames are returned as pointers into the mapping.
+ *  A file that is still being recorded can be opened, and refresh() picks up the frames written since.
+ */
+class TrajectoryReader {
+   public:
+    TrajectoryReader() = default;
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    ~TrajectoryReader() {
+        this->close();
+    }
+
+    /**
+	 * @brief Map a trajectory file.
+	 *
+	 * @param path
+	 * @return true When the file is a valid trajectory file.
+	 * @return false Otherwise. The error is printed.
+	 */
+    bool open(const std::string& path);
+
+    /**
+	 * @brief Map the file again to pick up frames written since it was opened.
+	 *
+	 * @return true When the file is a valid trajectory file.
+	 * @return false Otherwise.
+	 */
+    bool refresh();
+
+    /**
+	 * @brief Unmap the file.
+	 */
+    void close();
+
+    /**
+	 * @brief Get the number of complete frames in the file.
+	 *
+	 * @return std::uint64_t
+	 */
+    std::uint64_t getFrameCount() const;
+
+    /**
+	 * @brief Get the number of bodies in every frame.
+	 *
+	 * @return std::uint32_t
+	 */
+    std::uint32_t getBodyCount() const {
+        return this->mapping ? this->header()->numBodies : 0;
+    }
+
+    /**
+	 * @brief Get the time step the frames were recorded with.
+	 *
+	 * @return float
+	 */
+    float getTimeStep() const {
+        return this->mapping ? this->header()->dt : 0.0f;
+    }
+
+    /**
+	 * @brief Get the columns of a frame. The frame index must be less than getFrameCount().
+	 *
+	 * @param index
+	 * @return TrajectoryFrame
+	 */
+    TrajectoryFrame frame(std::uint64_t index) const;
+
+   private:
+    std::string path;
+    const char* mapping = nullptr;
+    std::size_t mappingSize = 0;
+
+    const TrajectoryHeader* header() const {
+        return reinterpret_cast<const TrajectoryHeader*>(this->mapping);
+    }
+
+    void unmap();
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,244 @@
+/** @file TriangleBVH.cpp
+ *  @brief Implementation of the triangle bounding volume hierarchy, see TriangleBVH.hpp.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "TriangleBVH.hpp"
+
+void TriangleBVH::build(const std::vector<glm::vec3>& corners) {
+    std::uint32_t numTriangles = corners.size() / 3;
+    this->nodes.clear();
+    this->corners.clear();
+    if (numTriangles == 0) {
+        return;
+    }
+
+    this->triangleLower.resize(numTriangles);
+    this->triangleUpper.resize(numTriangles);
+    this->centroids.resize(numTriangles);
+    this->order.resize(numTriangles);
+    for (std::uint32_t t = 0; t < numTriangles; ++t) {
+        const glm::vec3& a = corners[3 * t];
+        const glm::vec3& b = corners[3 * t + 1];
+        const glm::vec3& c = corners[3 * t + 2];
+        this->triangleLower[t] = glm::min(a, glm::min(b, c));
+        this->triangleUpper[t] = glm::max(a, glm::max(b, c));
+        this->centroids[t] = (a + b + c) / 3.0f;
+        this->order[t] = t;
+    }
+
+    // A binary tree with leaves of at least one triangle has fewer than twice as many nodes as triangles.
+    this->nodes.reserve(2 * numTriangles);
+    this->nodes.push_back(BVHNode());
+    this->buildNode(0, 0, numTriangles, 0);
+
+    this->corners.resize(3 * numTriangles);
+    for (std::uint32_t t = 0; t < numTriangles; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            this->corners[3 * t + k] = corners[3 * this->order[t] + k];
+        }
+    }
+
+    std::vector<glm::vec3>().swap(this->triangleLower);
+    std::vector<glm::vec3>().swap(this->triangleUpper);
+    std::vector<glm::vec3>().swap(this->centroids);
+    std::vector<std::uint32_t>().swap(this->order);
+}
+
+float TriangleBVH::nearest(glm::vec3 point, float maxDistance, glm::vec3& closest, int& triangle) const {
+    triangle = -1;
+    float best2 = maxDistance * maxDistance;
+    if (this->nodes.empty() || distance2(this->nodes[0], point) > best2) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // Every level pushes at most one child, and the tree is at most MAX_SAH_DEPTH + 32 levels deep.
+    std::uint32_t stack[MAX_SAH_DEPTH + 40];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BVHNode& node = this->nodes[stack[--top]];
+        if (distance2(node, point) > best2) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (std::uint32_t t = node.first; t < node.first + node.count; ++t) {
+                glm::vec3 q = closestPointOnTriangle(point, this->corners[3 * t], this->corners[3 * t + 1], this->corners[3 * t + 2]);
+                float d2 = glm::dot(point - q, point - q);
+                if (d2 <= best2) {
+                    best2 = d2;
+                    closest = q;
+                    triangle = t;
+                }
+            }
+            continue;
+        }
+        std::uint32_t near = node.first, far = node.first + 1;
+        float nearDistance2 = distance2(this->nodes[near], point);
+        float farDistance2 = distance2(this->nodes[far], point);
+        if (farDistance2 < nearDistance2) {
+            std::swap(near, far);
+            std::swap(nearDistance2, farDistance2);
+        }
+        if (farDistance2 <= best2) {
+            stack[top++] = far;
+        }
+        if (nearDistance2 <= best2) {
+            stack[top++] = near;
+        }
+    }
+    return (triangle < 0) ? std::numeric_limits<float>::infinity() : glm::sqrt(best2);
+}
+
+glm::vec3 TriangleBVH::faceNormal(int triangle) const {
+    const glm::vec3* c = &this->corners[3 * triangle];
+    glm::vec3 normal = glm::cross(c[1] - c[0], c[2] - c[0]);
+    float length = glm::length(normal);
+    return (length > 0.0f) ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+glm::vec3 TriangleBVH::closestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + (d1 / (d1 - d3)) * ab;
+    }
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + (d2 / (d2 - d6)) * ac;
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+    }
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+float TriangleBVH::distance2(const BVHNode& node, glm::vec3 point) {
+    glm::vec3 d = glm::max(glm::max(node.lower - point, point - node.upper), glm::vec3(0.0f));
+    return glm::dot(d, d);
+}
+
+float TriangleBVH::halfArea(glm::vec3 lower, glm::vec3 upper) {
+    glm::vec3 e = upper - lower;
+    return e.x * e.y + e.y * e.z + e.z * e.x;
+}
+
+void TriangleBVH::buildNode(std::uint32_t index, std::uint32_t first, std::uint32_t count, int depth) {
+    glm::vec3 lower(std::numeric_limits<float>::max()), upper(-std::numeric_limits<float>::max());
+    glm::vec3 centroidLower = lower, centroidUpper = upper;
+    for (std::uint32_t i = first; i < first + count; ++i) {
+        std::uint32_t t = this->order[i];
+        lower = glm::min(lower, this->triangleLower[t]);
+        upper = glm::max(upper, this->triangleUpper[t]);
+        centroidLower = glm::min(centroidLower, this->centroids[t]);
+        centroidUpper = glm::max(centroidUpper, this->centroids[t]);
+    }
+    BVHNode& node = this->nodes[index];
+    node.lower = lower;
+    node.upper = upper;
+    node.first = first;
+    node.count = count;
+    if (count <= (std::uint32_t)LEAF_SIZE) {
+        return;
+    }
+
+    int bestAxis = -1;
+    int bestBin = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    glm::vec3 extent = centroidUpper - centroidLower;
+    if (depth < MAX_SAH_DEPTH) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+            std::uint32_t binCount[BINS] = {};
+            glm::vec3 binLower[BINS], binUpper[BINS];
+            for (int b = 0; b < BINS; ++b) {
+                binLower[b] = glm::vec3(std::numeric_limits<float>::max());
+                binUpper[b] = glm::vec3(-std::numeric_limits<float>::max());
+            }
+            float scale = BINS / extent[axis];
+            for (std::uint32_t i = first; i < first + count; ++i) {
+                std::uint32_t t = this->order[i];
+                int b = std::min(BINS - 1, (int)((this->centroids[t][axis] - centroidLower[axis]) * scale));
+                ++binCount[b];
+                binLower[b] = glm::min(binLower[b], this->triangleLower[t]);
+                binUpper[b] = glm::max(binUpper[b], this->triangleUpper[t]);
+            }
+
+            // Cost of every split plane between bin b and b + 1, sweeping from the right first.
+            float rightCost[BINS];
+            glm::vec3 l(std::numeric_limits<float>::max()), u(-std::numeric_limits<float>::max());
+            std::uint32_t n = 0;
+            for (int b = BINS - 1; b > 0; --b) {
+                n += binCount[b];
+                l = glm::min(l, binLower[b]);
+                u = glm::max(u, binUpper[b]);
+                rightCost[b - 1] = (n > 0) ? n * halfArea(l, u) : 0.0f;
+            }
+            l = glm::vec3(std::numeric_limits<float>::max());
+            u = glm::vec3(-std::numeric_limits<float>::max());
+            n = 0;
+            for (int b = 0; b < BINS - 1; ++b) {
+                n += binCount[b];
+                l = glm::min(l, binLower[b]);
+                u = glm::max(u, binUpper[b]);
+                float cost = ((n > 0) ? n * halfArea(l, u) : 0.0f) + rightCost[b];
+                if (n > 0 && n < count && cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+    }
+
+    std::uint32_t middle;
+    if (bestAxis >= 0) {
+        if (bestCost >= count * halfArea(lower, upper) && count <= 2u * LEAF_SIZE) {
+            // Splitting costs more than testing all triangles of a small node.
+            return;
+        }
+        float scale = BINS / extent[bestAxis];
+        float origin = centroidLower[bestAxis];
+        std::uint32_t* split = std::partition(this->order.data() + first, this->order.data() + first + count, [&](std::uint32_t t) {
+            return std::min(BINS - 1, (int)((this->centroids[t][bestAxis] - origin) * scale)) <= bestBin;
+        });
+        middle = split - this->order.data();
+    } else {
+        // All centroids coincide, or the tree is too deep already: split at the median.
+        int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+        middle = first + count / 2;
+        std::nth_element(this->order.data() + first, this->order.data() + middle, this->order.data() + first + count, [&](std::uint32_t a, std::uint32_t b) {
+            return this->centroids[a][axis] < this->centroids[b][axis];
+        });
+    }
+
+    std::uint32_t left = this->nodes.size();
+    this->nodes.push_back(BVHNode());
+    this->nodes.push_back(BVHNode());
+    this->nodes[index].first = left;
+    this->nodes[index].count = 0;
+    this->buildNode(left, first, middle - first, depth + 1);
+    this->buildNode(left + 1, middle, first + count - middle, depth + 1);
+}
@@ -0,0 +1,130 @@
+/** @file TriangleBVH.hpp
+ *  @brief Class definition for a bounding volume hierarchy over the triangles of a mesh.
+ *
+ *  @details The hierarchy is built once over world space triangles. Every node is split where the
+ *  surface area heuristic, evaluated at a fixed number of bins along each axis, is the cheapest.
+ *  Nodes are kept in one flat array with the two children of a node next to each other, and the
+ *  triangles are reordered so that every leaf owns a contiguous range of them.
+ *
+ *  @author Sivaraman Karthik Rangasai (karthikrangasai)
+ */
+
+#ifndef TRIANGLE_BVH_H
+#define TRIANGLE_BVH_H
+
+#include <glm/glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct BVHNode
+ * @brief A node of a TriangleBVH, 32 bytes.
+ */
+typedef struct BVHNode {
+    //! Lower corner of the bounds of the triangles below the node.
+    glm::vec3 lower;
+    //! First triangle of a leaf, or the index of the left child of an inner node. The right child follows it.
+    std::uint32_t first;
+    //! Upper corner of the bounds of the triangles below the node.
+    glm::vec3 upper;
+    //! Number of triangles of a leaf, 0 for inner nodes.
+    std::uint32_t count;
+} BVHNode;
+
+/** @class TriangleBVH
+ *  @brief Bounding volume hierarchy over a triangle soup, for closest point queries.
+ */
+class TriangleBVH {
+   public:
+    //! Leaves are not split below this many triangles.
+    static const int LEAF_SIZE = 4;
+    //! Bins along each axis the surface area heuristic is evaluated at.
+    static const int BINS = 12;
+    //! Below this depth nodes are split at the median, which bounds the depth of the tree.
+    static const int MAX_SAH_DEPTH = 48;
+
+    /**
+	 * @brief Build the hierarchy over a list of triangles.
+	 *
+	 * @param corners Corners of the triangles, three per triangle.
+	 */
+    void build(const std::vector<glm::vec3>& corners);
+
+    bool empty() const {
+        return this->nodes.empty();
+    }
+
+    int getTriangleCount() const {
+        return this->corners.size() / 3;
+    }
+
+    int getNodeCount() const {
+        return this->nodes.size();
+    }
+
+    /**
+	 * @brief Get the bounds of all triangles.
+	 *
+	 * @return const BVHNode&
+	 */
+    const BVHNode& getRoot() const {
+        return this->nodes[0];
+    }
+
+    /**
+	 * @brief Find the point of the mesh closest to a point, no further away than maxDistance.
+	 *
+	 * @details Nodes are visited nearer child first, and skipped once their bounds are further away
+	 * than the closest triangle found so far, so a small maxDistance rejects most of the tree at once.
+	 *
+	 * @param point
+	 * @param maxDistance
+	 * @param closest Closest point of the mesh.
+	 * @param triangle Index of the triangle the closest point is on, -1 when none is close enough.
+	 * @return float Distance to the closest point, infinite when no triangle is within maxDistance.
+	 */
+    float nearest(glm::vec3 point, float maxDistance, glm::vec3& closest, int& triangle) const;
+
+    /**
+	 * @brief Unit normal of a triangle from its winding, or the y axis for a degenerate triangle.
+	 *
+	 * @param triangle
+	 * @return glm::vec3
+	 */
+    glm::vec3 faceNormal(int triangle) const;
+
+    /**
+	 * @brief Closest point of the triangle abc to p, from the Voronoi regions of its corners and edges.
+	 */
+    static glm::vec3 closestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c);
+
+   private:
+    std::vector<BVHNode> nodes;
+    //! Corners of the triangles in leaf order, three per triangle.
+    std::vector<glm::vec3> corners;
+
+    //! Bounds and centroids of the triangles, and the triangles in leaf order, while building.
+    std::vector<glm::vec3> triangleLower, triangleUpper, centroids;
+    std::vector<std::uint32_t> order;
+
+    /**
+	 * @brief Squared distance from a point to the bounds of a node, 0 inside.
+	 */
+    static float distance2(const BVHNode& node, glm::vec3 point);
+
+    static float halfArea(glm::vec3 lower, glm::vec3 upper);
+
+    /**
+	 * @brief Fill in the node for the triangles order[first, first + count) and split it further.
+	 */
+    void buildNode(std::uint32_t index, std::uint32_t first, std::uint32_t count, int depth);
+};
+
+#ifdef __cplusplus
+}
+#endif
+#endif